@@ -8,6 +8,13 @@ class Stream : public Print {
     virtual int read() = 0;
     virtual int peek() = 0;
     virtual int available() = 0;
+    size_t readBytes(uint8_t *buffer, size_t length) {
+        size_t count = 0;
+        int c;
+        while (count < length && (c = read()) >= 0)
+            buffer[count++] = c;
+        return count;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -79,6 +79,19 @@ class BankSettingChangeCallback
     /// the bank setting is 1, the LED displays the state of track 7.
     /// To know when to update the LED, this callback is used.
     virtual void onBankSettingChange() {}
+
+    /// Check whether the state that is stored for the two given bank settings
+    /// is different.
+    /// When the bank setting changes, @ref onBankSettingChange is only called
+    /// if this function returns true, so the outputs of elements that display
+    /// the same state in the old and the new bank aren't updated needlessly.
+    /// Elements that don't keep a separate state for each bank should always
+    /// return true (default).
+    virtual bool isBankStateDifferent(setting_t oldSetting,
+                                      setting_t newSetting) const {
+        (void)oldSetting, (void)newSetting;
+        return true;
+    }
 };
 
 /// A class that groups @ref BankableMIDIOutputElements and
@@ -111,8 +124,9 @@ class Bank : public Selectable<NumBanks>, public OutputBank {
 
     /// Select the given bank setting.
     ///
-    /// All Bankable MIDI Input elements that were added to this bank will be
-    /// updated.
+    /// All Bankable MIDI Input elements that were added to this bank and
+    /// whose state in the new bank differs from their state in the old bank
+    /// will be updated.
     ///
     /// @param  bankSetting
     ///         The new setting to select.
@@ -161,9 +175,11 @@ void Bank<NumBanks>::remove(BankSettingChangeCallback *bankable) {
 template <setting_t NumBanks>
 void Bank<NumBanks>::select(setting_t bankSetting) {
     bankSetting = this->validateSetting(bankSetting);
+    setting_t oldSetting = OutputBank::getSelection();
     OutputBank::select(bankSetting);
     for (BankSettingChangeCallback &e : inputBankables)
-        e.onBankSettingChange();
+        if (e.isBankStateDifferent(oldSetting, bankSetting))
+            e.onBankSettingChange();
 }
 
 END_CS_NAMESPACE
\ No newline at end of file
@@ -131,6 +131,10 @@
 #include <MIDI_Interfaces/BluetoothMIDI_Interface.hpp>
 #endif
 #include <MIDI_Interfaces/MIDI_Callbacks.hpp>
+#include <MIDI_Interfaces/MIDIMessageQueue.hpp>
+#include <MIDI_Interfaces/MIDIStallBuffer.hpp>
+#include <MIDI_Interfaces/StaticMIDI_Pipe.hpp>
+#include <MIDI_Interfaces/MIDI_RoutingMatrix.hpp>
 
 // ------------------------- Extended Input Output -------------------------- //
 #include <AH/Hardware/ExtendedInputOutput/AnalogMultiplex.hpp>
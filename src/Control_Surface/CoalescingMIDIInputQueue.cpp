@@ -0,0 +1,79 @@
+#include "CoalescingMIDIInputQueue.hpp"
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+bool BasicCoalescingMIDIInputQueue::isCoalescible(ChannelMessage msg) {
+    auto type = msg.getMessageType();
+    if (type == MIDIMessageType::ControlChange) {
+        uint8_t cc = msg.getData1();
+        return cc != MIDI_CC::Bank_Select && cc != MIDI_CC::Bank_Select_LSB &&
+               cc != MIDI_CC::Data_Entry_MSB && cc != MIDI_CC::Data_Entry_LSB &&
+               !(cc >= MIDI_CC::Data_Increment && cc <= MIDI_CC::RPN_MSB) &&
+               cc < MIDI_CC::All_Sound_Off;
+    }
+    return type == MIDIMessageType::KeyPressure ||
+           type == MIDIMessageType::ChannelPressure ||
+           type == MIDIMessageType::PitchBend;
+}
+
+bool BasicCoalescingMIDIInputQueue::supersedes(ChannelMessage b,
+                                               ChannelMessage a) {
+    if (a.header != b.header || a.cable != b.cable)
+        return false;
+    auto type = a.getMessageType();
+    if (type == MIDIMessageType::ControlChange ||
+        type == MIDIMessageType::KeyPressure)
+        return a.data1 == b.data1;
+    if (type == MIDIMessageType::ChannelPressure)
+        return (a.data1 >> 4) == (b.data1 >> 4) &&
+               ((a.data1 & 0x0F) > 0xC) == ((b.data1 & 0x0F) > 0xC);
+    return type == MIDIMessageType::PitchBend;
+}
+
+bool BasicCoalescingMIDIInputQueue::push(ChannelMessage msg) {
+    if (isCoalescible(msg)) {
+        for (uint16_t i = readIndex; i < writeIndex; ++i) {
+            Entry &e = buffer[i];
+            ChannelMessage queued {e.header, e.data1, e.data2, Cable(e.cable)};
+            if (supersedes(msg, queued)) {
+                // Overwrite the older message in place, so the new value is
+                // not reordered with respect to the messages after it. There
+                // can be at most one older message for the same address.
+                e.data1 = msg.data1;
+                e.data2 = msg.data2;
+                ++numCoalesced;
+                ++numPushed;
+                return true;
+            }
+        }
+    }
+    if (writeIndex == capacity) {
+        if (readIndex == 0)
+            return false;
+        // Move the remaining messages to the front of the buffer
+        uint16_t w = 0;
+        for (uint16_t r = readIndex; r < writeIndex; ++r)
+            buffer[w++] = buffer[r];
+        readIndex = 0;
+        writeIndex = w;
+    }
+    buffer[writeIndex++] = {msg.header, msg.data1, msg.data2,
+                            msg.cable.getRaw()};
+    ++numPushed;
+    return true;
+}
+
+bool BasicCoalescingMIDIInputQueue::pop(ChannelMessage &msg) {
+    if (readIndex == writeIndex) {
+        readIndex = writeIndex = 0;
+        return false;
+    }
+    const Entry &e = buffer[readIndex++];
+    msg = {e.header, e.data1, e.data2, Cable(e.cable)};
+    if (readIndex == writeIndex) // Start from the beginning again
+        readIndex = writeIndex = 0;
+    return true;
+}
+
+END_CS_NAMESPACE
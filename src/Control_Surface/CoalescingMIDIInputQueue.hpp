@@ -0,0 +1,114 @@
+#pragma once
+
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <Settings/NamespaceSettings.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Staging queue for incoming MIDI Channel Voice messages that
+ *          collapses redundant updates of the same address.
+ *
+ * When a DAW dumps its state, the same controller or VU meter is often updated
+ * many times before the MIDI input elements get to see the messages. When
+ * a message is pushed that supersedes a message that is still in the queue,
+ * the newer message replaces the older one at the older message's position in
+ * the queue (last value wins). The messages are dispatched in the order in
+ * which their addresses were first queued, so the new value is dispatched
+ * before any messages that were received between the two updates.
+ *
+ * The following messages are coalesced:
+ *
+ * - Control Change, per controller number, except for Bank Select, Data Entry,
+ *   (N)RPN and Channel Mode messages, which depend on the order of the
+ *   surrounding messages.
+ * - Key Pressure, per note.
+ * - Pitch Bend, per channel.
+ * - Channel Pressure, per channel and per value of the upper four bits of the
+ *   data byte, so Mackie Control VU meters of different tracks are kept apart.
+ *   Values with a lower nibble greater than 0xC (VU overload flags) are kept
+ *   apart from level values.
+ *
+ * Note On/Off and Program Change messages are never coalesced.
+ *
+ * @see     @ref Control_Surface_::setInputQueue
+ * @see     @ref CoalescingMIDIInputQueue
+ */
+class BasicCoalescingMIDIInputQueue {
+  public:
+    /// Compact storage of a queued message.
+    struct Entry {
+        uint8_t header;
+        uint8_t data1;
+        uint8_t data2;
+        uint8_t cable;
+    };
+
+  protected:
+    BasicCoalescingMIDIInputQueue(Entry *buffer, uint16_t capacity)
+        : buffer(buffer), capacity(capacity) {}
+
+  public:
+    /// Add a message to the end of the queue, or replace an older message for
+    /// the same address in place if there is one.
+    /// @return False if the queue is full, true otherwise.
+    bool push(ChannelMessage msg);
+    /// Remove the oldest message from the queue.
+    /// @return False if the queue is empty, true otherwise.
+    bool pop(ChannelMessage &msg);
+    /// Check whether there are any messages in the queue.
+    bool empty() const { return readIndex == writeIndex; }
+    /// Get the maximum number of messages the queue can hold.
+    uint16_t getCapacity() const { return capacity; }
+
+    /// Check whether a message may be replaced by later messages for the same
+    /// address.
+    static bool isCoalescible(ChannelMessage msg);
+    /// Check whether the newer message @p b supersedes the older message @p a.
+    static bool supersedes(ChannelMessage b, ChannelMessage a);
+
+    /// @name   Statistics
+    /// @{
+
+    /// Get the number of messages that were pushed into the queue.
+    uint32_t getNumberOfPushed() const { return numPushed; }
+    /// Get the number of messages that were replaced because a newer message
+    /// for the same address was pushed.
+    uint32_t getNumberOfCoalesced() const { return numCoalesced; }
+    /// Reset the statistics.
+    void resetCounters() { numPushed = numCoalesced = 0; }
+
+    /// @}
+
+  private:
+    Entry *buffer;
+    uint16_t capacity;
+    /// Index of the oldest message that hasn't been popped yet.
+    uint16_t readIndex = 0;
+    /// Index where the next message will be stored.
+    uint16_t writeIndex = 0;
+    uint32_t numPushed = 0;
+    uint32_t numCoalesced = 0;
+};
+
+/**
+ * @brief   Staging queue for incoming MIDI Channel Voice messages that
+ *          collapses redundant updates of the same address.
+ *
+ * @tparam  Capacity
+ *          The maximum number of messages that can be staged. If the queue is
+ *          full, the staged messages are dispatched to make room.
+ *
+ * @copydetails BasicCoalescingMIDIInputQueue
+ */
+template <uint16_t Capacity>
+class CoalescingMIDIInputQueue : public BasicCoalescingMIDIInputQueue {
+  public:
+    CoalescingMIDIInputQueue()
+        : BasicCoalescingMIDIInputQueue(storage, Capacity) {}
+
+  private:
+    Entry storage[Capacity] {};
+};
+
+END_CS_NAMESPACE
@@ -5,6 +5,7 @@
 #include <MIDI_Constants/Control_Change.hpp>
 #include <MIDI_Inputs/MIDIInputElement.hpp>
 #include <MIDI_Interfaces/DebugMIDI_Interface.hpp>
+#include <MIDI_Interfaces/MIDIMessageQueue.hpp>
 #include <MIDI_Outputs/Abstract/MIDIOutputElement.hpp>
 #include <Selectors/Selector.hpp>
 
@@ -76,9 +77,12 @@ void Control_Surface_::loop() {
     if (displayTimer)
         updateDisplays();
     ExtendedIOElement::updateAllBufferedOutputs();
+    MIDI_Interface::endLoopAll();
 }
 
 void Control_Surface_::updateMidiInput() {
+    // Also updates the MIDIStallBuffers
+    AH::Updatable<BasicMIDIMessageQueue>::updateAll();
 #if !DISABLE_PIPES
     Updatable<MIDI_Interface>::updateAll();
 #else
@@ -107,11 +111,33 @@ void Control_Surface_::updateMidiInput() {
         }
     }
 #endif
+    flushInputQueue();
+}
+
+void Control_Surface_::setInputQueue(BasicCoalescingMIDIInputQueue *queue) {
+    flushInputQueue();
+    inputQueue = queue;
+}
+
+void Control_Surface_::flushInputQueue() {
+    if (inputQueue == nullptr)
+        return;
+    ChannelMessage msg {0, 0, 0};
+    while (inputQueue->pop(msg))
+        dispatchChannelMessage(msg);
+}
+
+bool Control_Surface_::shouldSend(ChannelMessage msg) {
+    if (outputCache == nullptr)
+        return true;
+    uint32_t now = outputCache->getWindow() != 0 ? millis() : 0;
+    return outputCache->shouldSend(msg, now);
 }
 
 #if !DISABLE_PIPES
 void Control_Surface_::sendChannelMessageImpl(ChannelMessage msg) {
-    this->sourceMIDItoPipe(msg);
+    if (shouldSend(msg))
+        this->sourceMIDItoPipe(msg);
 }
 void Control_Surface_::sendSysExImpl(SysExMessage msg) {
     this->sourceMIDItoPipe(msg);
@@ -124,6 +150,8 @@ void Control_Surface_::sendRealTimeImpl(RealTimeMessage msg) {
 }
 #else
 void Control_Surface_::sendChannelMessageImpl(ChannelMessage msg) {
+    if (!shouldSend(msg))
+        return;
     if (auto def = MIDI_Interface::getDefault())
         def->send(msg);
 }
@@ -142,6 +170,18 @@ void Control_Surface_::sendRealTimeImpl(RealTimeMessage msg) {
 #endif
 
 void Control_Surface_::sinkMIDIfromPipe(ChannelMessage midimsg) {
+    // The receiver's state may have changed, don't suppress the next message
+    if (outputCache != nullptr)
+        outputCache->invalidate(midimsg);
+    if (inputQueue == nullptr)
+        return dispatchChannelMessage(midimsg);
+    if (!inputQueue->push(midimsg)) {
+        flushInputQueue();
+        inputQueue->push(midimsg);
+    }
+}
+
+void Control_Surface_::dispatchChannelMessage(ChannelMessage midimsg) {
 #ifdef DEBUG_MIDI_PACKETS
     if (midimsg.hasTwoDataBytes())
         DEBUG(">>> " << hex << midimsg.header << ' ' << midimsg.data1 << ' '
@@ -237,6 +277,8 @@ void Control_Surface_::sinkMIDIfromPipe(SysExMessage msg) {
         DEBUG_OUT << data[i] << ' ';
     DEBUG_OUT << " (" << msg.cable << ')' << dec << endl;
 #endif
+    // Channel messages that arrived before this message are handled first
+    flushInputQueue();
     // If the SysEx Message callback exists, call it to see if we have to
     // continue handling it.
     if (sysExMessageCallback && sysExMessageCallback(msg))
@@ -250,6 +292,7 @@ void Control_Surface_::sinkMIDIfromPipe(SysCommonMessage msg) {
               << ' ' << msg.getData2() << " (" << msg.cable << ')' << dec
               << endl;
 #endif
+    flushInputQueue();
     // If the SysEx Message callback exists, call it to see if we have to
     // continue handling it.
     if (sysCommonMessageCallback && sysCommonMessageCallback(msg))
@@ -278,6 +321,24 @@ void Control_Surface_::updateInputs() {
     MIDIInputElementSysEx::updateAll();
 }
 
+void Control_Surface_::buildInputIndices(MIDIInputDelivery delivery) {
+    MIDIInputElementNote::buildIndex(delivery);
+    MIDIInputElementKP::buildIndex(delivery);
+    MIDIInputElementCC::buildIndex(delivery);
+    MIDIInputElementPC::buildIndex(delivery);
+    MIDIInputElementCP::buildIndex(delivery);
+    MIDIInputElementPB::buildIndex(delivery);
+}
+
+void Control_Surface_::clearInputIndices() {
+    MIDIInputElementNote::clearIndex();
+    MIDIInputElementKP::clearIndex();
+    MIDIInputElementCC::clearIndex();
+    MIDIInputElementPC::clearIndex();
+    MIDIInputElementCP::clearIndex();
+    MIDIInputElementPB::clearIndex();
+}
+
 void Control_Surface_::beginDisplays() {
     auto &allElements = DisplayElement::getAll();
     auto it = allElements.begin();
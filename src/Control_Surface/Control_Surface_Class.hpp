@@ -5,8 +5,11 @@
 #include <AH/Containers/Updatable.hpp>
 #include <AH/Hardware/FilteredAnalog.hpp>
 #include <AH/Timing/MillisMicrosTimer.hpp>
+#include <Control_Surface/CoalescingMIDIInputQueue.hpp>
+#include <Control_Surface/MIDIOutputValueCache.hpp>
 #include <Display/DisplayElement.hpp>
 #include <Display/DisplayInterface.hpp>
+#include <MIDI_Inputs/MIDIInputElementIndex.hpp>
 #include <MIDI_Interfaces/MIDI_Interface.hpp>
 #include <Settings/SettingsWrapper.hpp>
 
@@ -62,10 +65,49 @@ class Control_Surface_ : public MIDI_Sender<Control_Surface_>,
     /// Disconnect Control Surface from the MIDI interfaces it's connected to.
     void disconnectMIDI_Interfaces();
 
-    /// Update all MIDI interfaces to receive new MIDI events.
+    /// Send the messages in all @ref MIDIMessageQueue%s and
+    /// @ref MIDIStallBuffer%s to the pipes, and update all MIDI interfaces to
+    /// receive new MIDI events.
     void updateMidiInput();
     /// Update all MIDIInputElement%s.
     void updateInputs();
+    /// Build the address indices of all channel message MIDIInputElement%s,
+    /// so incoming messages only reach the elements that could match them.
+    /// Call this after @ref begin(), and again after enabling elements.
+    /// @param  delivery
+    ///         Use @ref MIDIInputDelivery::AllMatches to allow multiple
+    ///         elements to listen to the same address.
+    /// @see    MIDIInputElement::buildIndex()
+    void buildInputIndices(
+        MIDIInputDelivery delivery = MIDIInputDelivery::FirstMatch);
+    /// Remove the address indices built by @ref buildInputIndices().
+    void clearInputIndices();
+
+    /// Stage incoming MIDI Channel Voice messages in the given queue, so
+    /// redundant updates of the same address can be collapsed before they are
+    /// passed to the channel message callback and the MIDIInputElement%s.
+    /// The queue is dispatched at the end of @ref updateMidiInput(), when it is
+    /// full, and before handling incoming System Exclusive and System Common
+    /// messages.
+    /// @param  queue
+    ///         The queue to use, or `nullptr` to dispatch all messages
+    ///         immediately (default).
+    void setInputQueue(BasicCoalescingMIDIInputQueue *queue);
+    /// Get the queue set by @ref setInputQueue.
+    BasicCoalescingMIDIInputQueue *getInputQueue() const { return inputQueue; }
+    /// Dispatch all messages in the input queue.
+    void flushInputQueue();
+    /// Drop outgoing MIDI Channel Voice messages that repeat the last value
+    /// that was sent to the same address.
+    /// Incoming messages invalidate the cached value of their address, so the
+    /// next outgoing message for that address is always sent.
+    /// @param  cache
+    ///         The cache to use, or `nullptr` to send all messages (default).
+    void setOutputCache(BasicMIDIOutputValueCache *cache) {
+        outputCache = cache;
+    }
+    /// Get the cache set by @ref setOutputCache.
+    BasicMIDIOutputValueCache *getOutputCache() const { return outputCache; }
     /// Initialize all displays that have at least one display element.
     void beginDisplays();
     /// Clear, draw and display all displays that contain display elements that
@@ -98,6 +140,10 @@ class Control_Surface_ : public MIDI_Sender<Control_Surface_>,
     void sinkMIDIfromPipe(SysCommonMessage msg);
     void sinkMIDIfromPipe(RealTimeMessage msg);
 #endif
+    /// Pass a channel message to the callback and the MIDIInputElement%s.
+    void dispatchChannelMessage(ChannelMessage msg);
+    /// Check the output cache to see if the given message has to be sent.
+    bool shouldSend(ChannelMessage msg);
 
   private:
     /// A timer to know when to refresh the displays.
@@ -143,6 +189,8 @@ class Control_Surface_ : public MIDI_Sender<Control_Surface_>,
     SysExMessageCallback sysExMessageCallback = nullptr;
     SysCommonMessageCallback sysCommonMessageCallback = nullptr;
     RealTimeMessageCallback realTimeMessageCallback = nullptr;
+    BasicCoalescingMIDIInputQueue *inputQueue = nullptr;
+    BasicMIDIOutputValueCache *outputCache = nullptr;
 #if !DISABLE_PIPES
     MIDI_Pipe inpipe, outpipe;
 #endif
@@ -0,0 +1,74 @@
+#include "MIDIOutputValueCache.hpp"
+#include "CoalescingMIDIInputQueue.hpp"
+
+BEGIN_CS_NAMESPACE
+
+bool BasicMIDIOutputValueCache::isCacheable(ChannelMessage msg) {
+    auto type = msg.getMessageType();
+    return type == MIDIMessageType::NoteOn ||
+           type == MIDIMessageType::NoteOff ||
+           BasicCoalescingMIDIInputQueue::isCoalescible(msg);
+}
+
+// Key layout: type (3 bits) | cable (4 bits) | channel (4 bits) | address (7)
+uint32_t BasicMIDIOutputValueCache::getKey(ChannelMessage msg) {
+    auto type = msg.getMessageType();
+    uint8_t address = 0;
+    if (type == MIDIMessageType::NoteOff) // Note On and Off share an entry
+        type = MIDIMessageType::NoteOn;
+    if (type == MIDIMessageType::NoteOn ||
+        type == MIDIMessageType::ControlChange ||
+        type == MIDIMessageType::KeyPressure)
+        address = msg.data1 & 0x7F;
+    return uint32_t((uint8_t(type) >> 4) & 0x7) << 15 |
+           uint32_t(msg.cable.getRaw()) << 11 |
+           uint32_t(msg.getChannel().getRaw()) << 7 | address;
+}
+
+uint16_t BasicMIDIOutputValueCache::getValue(ChannelMessage msg) {
+    switch (msg.getMessageType()) {
+        case MIDIMessageType::NoteOff: return 0x80 | msg.data2;
+        case MIDIMessageType::ChannelPressure: return msg.data1;
+        case MIDIMessageType::PitchBend: return msg.getData14bit();
+        default: return msg.data2;
+    }
+}
+
+uint16_t BasicMIDIOutputValueCache::getIndex(uint32_t key) const {
+    // Fibonacci hashing, keeps addresses that are close together apart
+    return ((key * 2654435769u) >> 16) & (capacity - 1);
+}
+
+bool BasicMIDIOutputValueCache::shouldSend(ChannelMessage msg, uint32_t now) {
+    if (!isCacheable(msg))
+        return true;
+    ++numChecked;
+    uint32_t key = getKey(msg);
+    uint32_t entry = key << 14 | getValue(msg);
+    uint16_t index = getIndex(key);
+    bool repeat = entries[index] == entry && !isBypassed() &&
+                  (window == 0 || now - times[index] < window);
+    if (repeat) {
+        ++numSuppressed;
+        return false;
+    }
+    entries[index] = entry;
+    times[index] = now;
+    return true;
+}
+
+void BasicMIDIOutputValueCache::invalidate(ChannelMessage msg) {
+    if (!isCacheable(msg))
+        return;
+    uint32_t key = getKey(msg);
+    uint16_t index = getIndex(key);
+    if ((entries[index] >> 14) == key)
+        entries[index] = EmptyEntry;
+}
+
+void BasicMIDIOutputValueCache::clear() {
+    for (uint16_t i = 0; i < capacity; ++i)
+        entries[i] = EmptyEntry;
+}
+
+END_CS_NAMESPACE
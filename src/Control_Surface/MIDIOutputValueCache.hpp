@@ -0,0 +1,164 @@
+#pragma once
+
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <Settings/NamespaceSettings.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Remembers the last value sent to each address, so outgoing MIDI
+ *          Channel Voice messages that repeat that value can be dropped.
+ *
+ * Output elements often send the same value to the same address more than
+ * once, e.g. after a bank change, a call to `forcedUpdate()`, or when a
+ * potentiometer jitters around the edge of its hysteresis band. Each of these
+ * repeats costs bandwidth on the MIDI bus without changing anything at the
+ * receiving end.
+ *
+ * The cache is keyed by cable, channel, message type and address (note or
+ * controller number). The following messages are cached:
+ *
+ * - Note On/Off, per note. Note On and Note Off share the same entry, so a
+ *   Note On is never dropped after a Note Off for the same note.
+ * - Control Change, per controller number, except for the order-dependent
+ *   controllers (see @ref BasicCoalescingMIDIInputQueue::isCoalescible).
+ * - Key Pressure, per note.
+ * - Channel Pressure and Pitch Bend, per channel.
+ *
+ * Program Change messages are always sent.
+ *
+ * Each entry is bit-packed into a single 32-bit word (18 bits of key and 14
+ * bits of value), plus a 32-bit time stamp. The entries are stored in a
+ * direct-mapped table: when two addresses map to the same slot, the oldest one
+ * is forgotten, which can only cause an unnecessary message to be sent, never
+ * a necessary message to be dropped.
+ *
+ * @see     @ref Control_Surface_::setOutputCache
+ * @see     @ref MIDIOutputValueCache
+ */
+class BasicMIDIOutputValueCache {
+  protected:
+    BasicMIDIOutputValueCache(uint32_t *entries, uint32_t *times,
+                              uint16_t capacity)
+        : entries(entries), times(times), capacity(capacity) {
+        clear();
+    }
+
+  public:
+    /// Check whether the given message should be sent, and remember its value.
+    /// @param  msg
+    ///         The message that is about to be sent.
+    /// @param  now
+    ///         The current time in milliseconds, e.g. `millis()` (only used
+    ///         if the window is nonzero, see @ref setWindow). The full 32 bits
+    ///         are stored, so a repeat is only suppressed incorrectly if it is
+    ///         sent exactly a multiple of 2³² ms (about 49.7 days) later.
+    /// @return False if the message repeats the value that was sent to the
+    ///         same address less than one window ago, true otherwise.
+    bool shouldSend(ChannelMessage msg, uint32_t now = 0);
+    /// Forget the value of the address of the given message, so the next
+    /// message for that address is sent, regardless of its value.
+    void invalidate(ChannelMessage msg);
+    /// Forget all values.
+    void clear();
+
+    /// Set the time (in milliseconds) after which a value is sent again, even
+    /// if it didn't change. Zero means that repeated values are never sent
+    /// (default).
+    void setWindow(uint16_t window) { this->window = window; }
+    /// Get the window set by @ref setWindow.
+    uint16_t getWindow() const { return window; }
+
+    /// @name   Bypass
+    /// @{
+
+    /// Send all messages while the bypass is enabled. Their values are still
+    /// remembered. Calls can be nested: the bypass stays enabled until each
+    /// call with @p bypass set to true has been matched by a call with
+    /// @p bypass set to false.
+    void setBypass(bool bypass) { bypassDepth += bypass ? 1 : -1; }
+    /// Check whether the bypass is enabled.
+    bool isBypassed() const { return bypassDepth > 0; }
+
+    /// Enables the bypass of the given cache for as long as it is in scope.
+    /// For example, to make sure that an element's value is resent:
+    /// ~~~cpp
+    /// {
+    ///     BasicMIDIOutputValueCache::ScopedBypass bypass {cache};
+    ///     potentiometer.forcedUpdate();
+    /// }
+    /// ~~~
+    class ScopedBypass {
+      public:
+        ScopedBypass(BasicMIDIOutputValueCache &cache) : cache(cache) {
+            cache.setBypass(true);
+        }
+        ~ScopedBypass() { cache.setBypass(false); }
+        ScopedBypass(const ScopedBypass &) = delete;
+        ScopedBypass &operator=(const ScopedBypass &) = delete;
+
+      private:
+        BasicMIDIOutputValueCache &cache;
+    };
+
+    /// @}
+
+    /// Check whether messages of the given type and address are cached.
+    static bool isCacheable(ChannelMessage msg);
+    /// Get the maximum number of addresses that can be remembered.
+    uint16_t getCapacity() const { return capacity; }
+
+    /// @name   Statistics
+    /// @{
+
+    /// Get the number of messages that were checked by @ref shouldSend.
+    uint32_t getNumberOfChecked() const { return numChecked; }
+    /// Get the number of messages that were dropped because they repeated the
+    /// previous value.
+    uint32_t getNumberOfSuppressed() const { return numSuppressed; }
+    /// Reset the statistics.
+    void resetCounters() { numChecked = numSuppressed = 0; }
+
+    /// @}
+
+  private:
+    /// Marks an unused entry. The type bits of a key are never all ones.
+    static constexpr uint32_t EmptyEntry = 0xFFFFFFFF;
+    static uint32_t getKey(ChannelMessage msg);
+    static uint16_t getValue(ChannelMessage msg);
+    uint16_t getIndex(uint32_t key) const;
+
+    uint32_t *entries;
+    uint32_t *times;
+    uint16_t capacity;
+    uint16_t window = 0;
+    int8_t bypassDepth = 0;
+    uint32_t numChecked = 0;
+    uint32_t numSuppressed = 0;
+};
+
+/**
+ * @brief   Remembers the last value sent to each address, so outgoing MIDI
+ *          Channel Voice messages that repeat that value can be dropped.
+ *
+ * @tparam  Capacity
+ *          The number of addresses that can be remembered. Must be a power of
+ *          two. Each address takes up eight bytes.
+ *
+ * @copydetails BasicMIDIOutputValueCache
+ */
+template <uint16_t Capacity>
+class MIDIOutputValueCache : public BasicMIDIOutputValueCache {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+  public:
+    MIDIOutputValueCache()
+        : BasicMIDIOutputValueCache(entryStorage, timeStorage, Capacity) {}
+
+  private:
+    uint32_t entryStorage[Capacity];
+    uint32_t timeStorage[Capacity];
+};
+
+END_CS_NAMESPACE
@@ -3,6 +3,7 @@
 #include <Banks/Bank.hpp>
 #include <Banks/BankConfig.hpp>
 #include <Def/MIDIAddress.hpp>
+#include <MIDI_Inputs/MIDIInputElementIndex.hpp>
 
 BEGIN_CS_NAMESPACE
 
@@ -226,6 +227,60 @@ uint8_t getRangeIndex(MIDIAddress tgt, MIDIAddress base,
                : tgt.getAddress() - base.getAddress();
 }
 
+/**
+ * @brief   Report all addresses that are matched by
+ *          @ref matchBankableInRange(MIDIAddress,MIDIAddress,BaseBankConfig<BankSize>,uint8_t)
+ *          to the given visitor.
+ * 
+ * @param   base
+ *          The base address (beginning of the range for bank setting 0).
+ * @param   config
+ *          The bank configuration.
+ * @param   length
+ *          The length of the range.
+ * @param   visitor
+ *          The visitor to report the ranges to, one range per bank setting.
+ */
+template <uint8_t BankSize>
+void visitBankableRanges(MIDIAddress base, BaseBankConfig<BankSize> config,
+                         uint8_t length, MIDIMatchRangeVisitor &visitor) {
+    if (!base.isValid())
+        return;
+    const int B = config.bank.getTracksPerBank();
+    const int F = config.bank.getSelectionOffset();
+    for (int s = 0; s < BankSize; ++s) {
+        const int offset = (F + s) * B;
+        switch (config.type) {
+            case BankType::ChangeAddress: {
+                int address = base.getAddress() + offset;
+                int rangeLen = length < B ? length : B;
+                if (address < 0) {
+                    rangeLen += address;
+                    address = 0;
+                }
+                if (address <= 127 && rangeLen > 0)
+                    visitor.visit({address, base.getChannelCable()},
+                                  static_cast<uint8_t>(rangeLen));
+            } break;
+            case BankType::ChangeChannel: {
+                int channel = base.getRawChannel() + offset;
+                if (channel >= 0 && channel <= 15)
+                    visitor.visit({base.getAddress(), Channel(channel),
+                                   base.getCableNumber()},
+                                  length);
+            } break;
+            case BankType::ChangeCable: {
+                int cable = base.getRawCableNumber() + offset;
+                if (cable >= 0 && cable <= 15)
+                    visitor.visit(
+                        {base.getAddress(), base.getChannel(), Cable(cable)},
+                        length);
+            } break;
+            default: break; // LCOV_EXCL_LINE
+        }
+    }
+}
+
 } // namespace BankableMIDIMatcherHelpers
 
 END_CS_NAMESPACE
\ No newline at end of file
@@ -436,6 +436,11 @@ class NoteCCKPRangeFastLED : public NoteCCKPRange<Type, BankSize, RangeLen> {
         Parent::onBankSettingChange();
         updateLEDs();
     }
+    /// The colors depend on the bank index as well, so the LEDs have to be
+    /// updated even if the values in both banks are the same.
+    bool isBankStateDifferent(setting_t, setting_t) const override {
+        return true;
+    }
 
   private:
     CRGB *ledcolors;
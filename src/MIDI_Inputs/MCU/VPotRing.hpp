@@ -24,6 +24,9 @@ struct VPotState {
         return changed;
     }
 
+    bool operator==(VPotState other) const { return value == other.value; }
+    bool operator!=(VPotState other) const { return !(*this == other); }
+
     /// Determines how the VPot value is displayed using the LEDs.
     enum Mode {
         SingleDot = 0, ///< Single dot.
@@ -341,6 +344,10 @@ class VPotRing
 
   protected:
     void onBankSettingChange() override { dirty = true; }
+    bool isBankStateDifferent(setting_t oldSetting,
+                              setting_t newSetting) const override {
+        return states[oldSetting] != states[newSetting];
+    }
 
   private:
     AH::Array<VPotState, BankSize> states = {{}};
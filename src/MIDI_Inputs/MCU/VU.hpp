@@ -75,6 +75,11 @@ struct VUState {
         value--;
         return true;
     }
+
+    bool operator==(VUState other) const {
+        return value == other.value && overload == other.overload;
+    }
+    bool operator!=(VUState other) const { return !(*this == other); }
 };
 
 // -------------------------------------------------------------------------- //
@@ -123,6 +128,11 @@ struct VUMatcher {
         return {true, data};
     }
 
+    /// Report the address (track, channel and cable) to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        visitor.visit(address, 1);
+    }
+
     MIDIAddress address; ///< MIDI address to compare incoming messages with.
 };
 
@@ -165,6 +175,12 @@ struct BankableVUMatcher {
     /// @see    @ref Bank<N>::getSelection()
     setting_t getSelection() const { return getBank().getSelection(); }
 
+    /// Report the addresses of all banks to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        BankableMIDIMatcherHelpers::visitBankableRanges(address, config, 1,
+                                                        visitor);
+    }
+
     BaseBankConfig<BankSize> config; ///< Bank configuration.
     MIDIAddress address; ///< MIDI address to compare incoming messages with.
 };
@@ -381,6 +397,10 @@ class VU
 
   protected:
     void onBankSettingChange() override { dirty = true; }
+    bool isBankStateDifferent(setting_t oldSetting,
+                              setting_t newSetting) const override {
+        return states[oldSetting] != states[newSetting];
+    }
 
   public:
     /// @name Data access
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "MIDIInputElementIndex.hpp"
 #include <Def/MIDIAddress.hpp>
 #include <MIDI_Parsers/MIDI_MessageTypes.hpp>
 
@@ -23,7 +24,9 @@ class MIDIInputElement : public AH::UpdatableCRTP<MIDIInputElement<Type>> {
     MIDIInputElement() = default;
 
   public:
-    virtual ~MIDIInputElement() = default;
+    /// Destructor: the index can no longer be used, because it might still
+    /// refer to this element.
+    virtual ~MIDIInputElement() { index.invalidate(); }
 
   public:
     using MessageType =
@@ -42,8 +45,18 @@ class MIDIInputElement : public AH::UpdatableCRTP<MIDIInputElement<Type>> {
     /// Receive a new MIDI message and update the internal state.
     virtual bool updateWith(MessageType midimsg) = 0;
 
+    /// Report the MIDI addresses this element listens to, so it can be added
+    /// to the address index (see @ref buildIndex()).
+    /// @return False if the element cannot report its addresses, in which
+    ///         case it is tried for every incoming message.
+    virtual bool visitMatchRanges(MIDIMatchRangeVisitor &) const {
+        return false;
+    }
+
     /// Update all
     static bool updateAllWith(MessageType midimsg) {
+        if (index.isValid())
+            return index.updateWith(midimsg);
         for (auto &el : MIDIInputElement::updatables) {
             if (el.updateWith(midimsg)) {
                 el.moveDown();
@@ -67,8 +80,53 @@ class MIDIInputElement : public AH::UpdatableCRTP<MIDIInputElement<Type>> {
     static void resetAll() {
         MIDIInputElement::applyToAll(&MIDIInputElement::reset);
     }
+
+    /// @name Address index
+    /// @{
+
+    /// Build a table that maps MIDI addresses to the enabled elements that
+    /// listen to them. After calling this function, @ref updateAllWith() only
+    /// tries the elements that could match the incoming message, instead of
+    /// iterating over the list of all elements.
+    /// @param  delivery
+    ///         Whether to deliver each message to the first matching element
+    ///         only, or to all matching elements.
+    /// @note   Call this function again after enabling elements or creating
+    ///         new ones. Destroying an element invalidates the index.
+    static void
+    buildIndex(MIDIInputDelivery delivery = MIDIInputDelivery::FirstMatch) {
+        index.build(MIDIInputElement::updatables, delivery);
+    }
+    /// Remove the address index, and go back to iterating over the list of all
+    /// elements for each incoming message.
+    static void clearIndex() { index.clear(); }
+    /// Get the address index.
+    static const MIDIInputElementIndex<Type> &getIndex() { return index; }
+
+    /// @}
+
+  private:
+    static MIDIInputElementIndex<Type> index;
 };
 
+template <MIDIMessageType Type>
+MIDIInputElementIndex<Type> MIDIInputElement<Type>::index;
+
+namespace detail {
+/// Report the match ranges of a matcher if it supports it.
+template <class Matcher>
+auto visitMatchRanges(const Matcher &matcher, MIDIMatchRangeVisitor &visitor,
+                      int) -> decltype(matcher.visitMatchRanges(visitor), bool()) {
+    matcher.visitMatchRanges(visitor);
+    return true;
+}
+/// Fallback for matchers that don't know their match ranges.
+template <class Matcher>
+bool visitMatchRanges(const Matcher &, MIDIMatchRangeVisitor &, long) {
+    return false;
+}
+} // namespace detail
+
 // -------------------------------------------------------------------------- //
 
 /// The @ref MIDIInputElement base class is very general: you give it a MIDI
@@ -101,6 +159,10 @@ class MatchingMIDIInputElement : public MIDIInputElement<Type> {
 
     virtual void handleUpdate(typename Matcher::Result match) = 0;
 
+    bool visitMatchRanges(MIDIMatchRangeVisitor &visitor) const override {
+        return detail::visitMatchRanges(matcher, visitor, 0);
+    }
+
   protected:
     Matcher matcher;
 };
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <Def/MIDIAddress.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+
+#include <AH/STL/vector>
+
+BEGIN_CS_NAMESPACE
+
+template <MIDIMessageType Type>
+class MIDIInputElement;
+
+/// @addtogroup MIDIInputMatchers
+/// @{
+
+/**
+ * @brief   Interface for objects that want to know which MIDI addresses a
+ *          MIDI input element or matcher listens to.
+ *
+ * Used by @ref MIDIInputElementIndex to build its address table.
+ */
+class MIDIMatchRangeVisitor {
+  protected:
+    ~MIDIMatchRangeVisitor() = default;
+
+  public:
+    /// Called for each range of consecutive MIDI addresses (on the channel
+    /// and cable of @p first) that could be matched. For messages that have no
+    /// address (Program Change, Channel Pressure, Pitch Bend), only the channel
+    /// and cable of @p first are used.
+    virtual void visit(MIDIAddress first, uint8_t length) = 0;
+};
+
+/// @}
+
+/// Determines which MIDI input elements receive an incoming message when using
+/// a @ref MIDIInputElementIndex.
+enum class MIDIInputDelivery : uint8_t {
+    /// Only the first element that matches the message receives it.
+    FirstMatch,
+    /// All elements that match the message receive it, e.g. an LED and a
+    /// display element that listen to the same address.
+    AllMatches,
+};
+
+/**
+ * @brief   Lookup table that maps MIDI addresses to the MIDI input elements
+ *          that listen to them.
+ *
+ * The table is built once (usually after `begin()`) from the elements' match
+ * ranges (see @ref MIDIInputElement::visitMatchRanges). It is stored as a hash
+ * table with the entries of all buckets in a single contiguous array, so
+ * looking up the candidates for an incoming message takes constant time,
+ * regardless of the total number of elements.
+ *
+ * Elements that cannot report their match ranges are kept in a separate list
+ * that is tried after the indexed candidates.
+ *
+ * Each address has its own list of subscribers, so the message can either be
+ * delivered to the first subscriber that matches, or to all of them (see
+ * @ref MIDIInputDelivery). In both cases, the cost is proportional to the
+ * number of subscribers of the address, not to the total number of elements.
+ *
+ * @tparam  Type
+ *          The type of MIDI input elements to index.
+ */
+template <MIDIMessageType Type>
+class MIDIInputElementIndex {
+  public:
+    using Element = MIDIInputElement<Type>;
+
+    /// Build the table for all elements in the given list.
+    template <class List>
+    void build(List &elements,
+               MIDIInputDelivery delivery = MIDIInputDelivery::FirstMatch);
+    /// Remove all elements from the table and free its memory.
+    void clear();
+    /// Mark the table as out of date, e.g. because one of the elements is
+    /// being destroyed. The table will no longer be used until it is rebuilt.
+    void invalidate() { valid = false; }
+    /// Check whether the table is up to date.
+    bool isValid() const { return valid; }
+
+    /// Update the first element or all elements that match the given message,
+    /// depending on the delivery mode.
+    /// @return True if at least one element matched the message.
+    bool updateWith(ChannelMessage msg) const;
+
+    /// Get the delivery mode that was used to build the table.
+    MIDIInputDelivery getDelivery() const { return delivery; }
+
+    /// Get the number of (address, element) entries in the table.
+    size_t getNumberOfEntries() const { return entries.size(); }
+    /// Get the number of elements that could not be indexed.
+    size_t getNumberOfUnindexed() const { return unindexed.size(); }
+    /// Get the number of hash buckets.
+    size_t getNumberOfBuckets() const { return 1u << bucketBits; }
+
+    /// Does the address (first data byte) of messages of this type matter?
+    constexpr static bool hasAddress() {
+        return Type == MIDIMessageType::NoteOn ||
+               Type == MIDIMessageType::KeyPressure ||
+               Type == MIDIMessageType::ControlChange;
+    }
+    /// Get the key of the given address, channel and cable.
+    static uint16_t getKey(uint8_t address, uint8_t channel, uint8_t cable) {
+        return (uint16_t(cable & 0x0F) << 11) | //
+               (uint16_t(channel & 0x0F) << 7) |
+               (hasAddress() ? (address & 0x7F) : 0);
+    }
+    /// Get the key of the given message.
+    static uint16_t getKey(ChannelMessage msg) {
+        return getKey(msg.data1, msg.header, msg.cable.getRaw());
+    }
+
+  private:
+    uint16_t getBucket(uint16_t key) const {
+        return bucketBits == 0
+                   ? 0
+                   : uint16_t(uint16_t(key * 0x9E37u) >> (16 - bucketBits));
+    }
+
+    struct Entry {
+        uint16_t key;
+        Element *element;
+    };
+
+    /// Visitor that feeds the match ranges of an element into the table.
+    /// The same visitor is used for counting the entries and for filling in
+    /// the table.
+    class Builder : public MIDIMatchRangeVisitor {
+      public:
+        enum Pass { CountTotal, CountBuckets, Fill };
+        Builder(MIDIInputElementIndex &index, Pass pass)
+            : index(index), pass(pass) {}
+        void visit(MIDIAddress first, uint8_t length) override;
+
+        MIDIInputElementIndex &index;
+        Pass pass;
+        Element *element = nullptr;
+        size_t total = 0;
+    };
+
+    /// Start index of each bucket in @ref entries, followed by the total
+    /// number of entries.
+    std::vector<uint16_t> buckets;
+    std::vector<Entry> entries;
+    std::vector<Element *> unindexed;
+    uint8_t bucketBits = 0;
+    MIDIInputDelivery delivery = MIDIInputDelivery::FirstMatch;
+    bool valid = false;
+};
+
+/// System Exclusive input elements have no address, so they are never indexed.
+template <>
+class MIDIInputElementIndex<MIDIMessageType::SysExStart> {
+  public:
+    template <class List>
+    void build(List &, MIDIInputDelivery = MIDIInputDelivery::FirstMatch) {}
+    void clear() {}
+    void invalidate() {}
+    constexpr bool isValid() const { return false; }
+    bool updateWith(SysExMessage) const { return false; }
+};
+
+// ---------------------------- Implementations ----------------------------- //
+
+template <MIDIMessageType Type>
+void MIDIInputElementIndex<Type>::Builder::visit(MIDIAddress first,
+                                                 uint8_t length) {
+    if (!first.isValid())
+        return;
+    unsigned begin = hasAddress() ? first.getAddress() : 0;
+    unsigned end = hasAddress() ? begin + length : 1;
+    if (end > 128)
+        end = 128;
+    for (unsigned address = begin; address < end; ++address) {
+        uint16_t key = getKey(address, first.getRawChannel(),
+                              first.getRawCableNumber());
+        switch (pass) {
+            case CountTotal: ++total; break;
+            case CountBuckets: ++index.buckets[index.getBucket(key) + 1]; break;
+            case Fill:
+                index.entries[index.buckets[index.getBucket(key)]++] = {
+                    key, element};
+                break;
+            default: break; // LCOV_EXCL_LINE
+        }
+        // Messages without address only need a single entry
+        if (!hasAddress())
+            break;
+    }
+}
+
+template <MIDIMessageType Type>
+template <class List>
+void MIDIInputElementIndex<Type>::build(List &elements,
+                                        MIDIInputDelivery delivery) {
+    clear();
+    this->delivery = delivery;
+
+    // Count the total number of entries to determine the table size.
+    Builder counter {*this, Builder::CountTotal};
+    for (Element &el : elements)
+        if (!el.visitMatchRanges(counter))
+            unindexed.push_back(&el);
+    if (counter.total > 0xFFFF)
+        return; // Too large to index, keep using the linked list
+    while ((1u << bucketBits) < counter.total)
+        ++bucketBits;
+
+    // Count the number of entries in each bucket, and convert the counts to
+    // start indices.
+    buckets.resize(getNumberOfBuckets() + 1);
+    Builder bucketCounter {*this, Builder::CountBuckets};
+    for (Element &el : elements)
+        el.visitMatchRanges(bucketCounter);
+    for (size_t b = 1; b < buckets.size(); ++b)
+        buckets[b] += buckets[b - 1];
+
+    // Fill in the entries, in the order of the list, so elements earlier in
+    // the list have priority within each bucket. This advances the start index
+    // of each bucket to the start of the next one, so shift them back after.
+    entries.resize(counter.total);
+    Builder filler {*this, Builder::Fill};
+    for (Element &el : elements) {
+        filler.element = &el;
+        el.visitMatchRanges(filler);
+    }
+    for (size_t b = buckets.size() - 1; b > 0; --b)
+        buckets[b] = buckets[b - 1];
+    buckets[0] = 0;
+
+    // An element can report the same key more than once (e.g. VU meters for
+    // different tracks on the same channel). Its entries within a bucket are
+    // contiguous, so only adjacent duplicates have to be removed.
+    size_t w = 0;
+    for (size_t b = 0; b + 1 < buckets.size(); ++b) {
+        size_t bucketStart = w;
+        for (size_t r = buckets[b]; r < buckets[b + 1]; ++r) {
+            const Entry &e = entries[r];
+            bool duplicate = w > bucketStart && entries[w - 1].key == e.key &&
+                             entries[w - 1].element == e.element;
+            if (!duplicate)
+                entries[w++] = e;
+        }
+        buckets[b] = bucketStart;
+    }
+    buckets.back() = w;
+    entries.resize(w);
+    valid = true;
+}
+
+template <MIDIMessageType Type>
+void MIDIInputElementIndex<Type>::clear() {
+    std::vector<uint16_t>().swap(buckets);
+    std::vector<Entry>().swap(entries);
+    std::vector<Element *>().swap(unindexed);
+    bucketBits = 0;
+    delivery = MIDIInputDelivery::FirstMatch;
+    valid = false;
+}
+
+template <MIDIMessageType Type>
+bool MIDIInputElementIndex<Type>::updateWith(ChannelMessage msg) const {
+    const bool firstOnly = delivery == MIDIInputDelivery::FirstMatch;
+    bool matched = false;
+    uint16_t key = getKey(msg);
+    uint16_t bucket = getBucket(key);
+    for (size_t i = buckets[bucket]; i < buckets[bucket + 1]; ++i) {
+        const Entry &e = entries[i];
+        if (e.key == key && e.element->isEnabled() &&
+            e.element->updateWith(msg)) {
+            if (firstOnly)
+                return true;
+            matched = true;
+        }
+    }
+    for (Element *el : unindexed) {
+        if (el->isEnabled() && el->updateWith(msg)) {
+            if (firstOnly)
+                return true;
+            matched = true;
+        }
+    }
+    return matched;
+}
+
+END_CS_NAMESPACE
@@ -27,6 +27,11 @@ struct OneByteMIDIMatcher {
         return {true, value};
     }
 
+    /// Report the channel and cable to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        visitor.visit(address, 1);
+    }
+
     MIDIChannelCable address;
 };
 
@@ -50,6 +55,11 @@ struct TwoByteMIDIMatcher {
         return {true, value};
     }
 
+    /// Report the address to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        visitor.visit(address, 1);
+    }
+
     MIDIAddress address;
 };
 
@@ -71,6 +81,11 @@ struct PitchBendMIDIMatcher {
         return {true, value};
     }
 
+    /// Report the channel and cable to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        visitor.visit(address, 1);
+    }
+
     MIDIChannelCable address;
 };
 
@@ -98,6 +113,11 @@ struct TwoByteRangeMIDIMatcher {
         return {true, value, index};
     }
 
+    /// Report the range of addresses to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        visitor.visit(address, length);
+    }
+
     MIDIAddress address;
     uint8_t length;
 };
@@ -138,6 +158,12 @@ struct BankableOneByteMIDIMatcher {
     /// @see    @ref Bank<N>::getSelection()
     setting_t getSelection() const { return getBank().getSelection(); }
 
+    /// Report the channel and cable of all banks to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        BankableMIDIMatcherHelpers::visitBankableRanges(address, config, 1,
+                                                        visitor);
+    }
+
     BaseBankConfig<BankSize> config;
     MIDIChannelCable address;
 };
@@ -177,6 +203,12 @@ struct BankableTwoByteMIDIMatcher {
     /// @see    @ref Bank<N>::getSelection()
     setting_t getSelection() const { return getBank().getSelection(); }
 
+    /// Report the addresses of all banks to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        BankableMIDIMatcherHelpers::visitBankableRanges(address, config, 1,
+                                                        visitor);
+    }
+
     BaseBankConfig<BankSize> config;
     MIDIAddress address;
 };
@@ -217,6 +249,12 @@ struct BankablePitchBendMIDIMatcher {
     /// @see    @ref Bank<N>::getSelection()
     setting_t getSelection() const { return getBank().getSelection(); }
 
+    /// Report the channel and cable of all banks to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        BankableMIDIMatcherHelpers::visitBankableRanges(address, config, 1,
+                                                        visitor);
+    }
+
     BaseBankConfig<BankSize> config;
     MIDIChannelCable address;
 };
@@ -259,6 +297,12 @@ struct BankableTwoByteRangeMIDIMatcher {
     /// @see    @ref Bank<N>::getSelection()
     setting_t getSelection() const { return config.bank.getSelection(); }
 
+    /// Report the ranges of addresses of all banks to the visitor.
+    void visitMatchRanges(MIDIMatchRangeVisitor &visitor) const {
+        BankableMIDIMatcherHelpers::visitBankableRanges(address, config, length,
+                                                        visitor);
+    }
+
     BaseBankConfig<BankSize> config;
     MIDIAddress address;
     uint8_t length;
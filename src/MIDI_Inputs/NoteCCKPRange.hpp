@@ -166,6 +166,10 @@ class NoteCCKPRange : public BankableMatchingMIDIInputElement<
 
   protected:
     void onBankSettingChange() override { dirty = true; }
+    bool isBankStateDifferent(setting_t oldSetting,
+                              setting_t newSetting) const override {
+        return values[oldSetting] != values[newSetting];
+    }
 
   private:
     AH::Array2D<uint8_t, BankSize, RangeLen> values = {{{}}};
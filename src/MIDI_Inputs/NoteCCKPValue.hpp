@@ -132,6 +132,10 @@ class NoteCCKPValue : public BankableMatchingMIDIInputElement<
 
   protected:
     void onBankSettingChange() override { dirty = true; }
+    bool isBankStateDifferent(setting_t oldSetting,
+                              setting_t newSetting) const override {
+        return values[oldSetting] != values[newSetting];
+    }
 
   private:
     AH::Array<uint8_t, BankSize> values = {{}};
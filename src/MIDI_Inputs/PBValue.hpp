@@ -100,6 +100,10 @@ class PBValue
 
   protected:
     void onBankSettingChange() override { dirty = true; }
+    bool isBankStateDifferent(setting_t oldSetting,
+                              setting_t newSetting) const override {
+        return values[oldSetting] != values[newSetting];
+    }
 
   private:
     AH::Array<uint16_t, BankSize> values = {{}};
@@ -134,6 +134,12 @@ class MIDIBLEInstance {
     /// Called by the BLE stack when the maximum transmission unit for the
     /// connection changes.
     virtual void handleMTU(BLEConnectionHandle conn_handle, uint16_t mtu) = 0;
+    /// Called by the BLE stack when the connection parameters are negotiated
+    /// or updated. The interval is a multiple of 1.25 ms. Optional: backends
+    /// that don't use this information can ignore it.
+    virtual void handleConnectionParameters(BLEConnectionHandle /* conn */,
+                                            uint16_t /* interval */,
+                                            uint16_t /* latency */) {}
     /// Called by the BLE stack when the central subscribes to receive
     /// notifications for the MIDI GATT characteristic.
     virtual void handleSubscribe(BLEConnectionHandle conn_handle,
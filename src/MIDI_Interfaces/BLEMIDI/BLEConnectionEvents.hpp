@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Settings/NamespaceSettings.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// Keeps track of the connection parameters of a BLE connection, and of the
+/// notifications that were handed to the BLE stack in each connection event.
+///
+/// Notifications can only be sent during connection events. If the BLE stack
+/// can only send a limited number of notifications per event, the sender
+/// should hold back full packets until the next event (see
+/// @ref setMaxNotificationsPerEvent).
+///
+/// The BLE stacks only report the connection interval and the peripheral
+/// latency, not when the connection events take place. The events are
+/// therefore assumed to start when the parameters are set. This estimate is
+/// only used to count the notifications per event: holding partially filled
+/// packets until the estimated next event adds up to a full interval of
+/// latency before the packet even gets to the real event, which is worse than
+/// using a short timeout.
+///
+/// All times are in microseconds, and are allowed to wrap around.
+/// This class is not thread-safe.
+class BLEConnectionEvents {
+  public:
+    /// Set the negotiated connection parameters.
+    /// @param  interval
+    ///         Connection interval, as a multiple of 1.25 ms (zero if unknown).
+    /// @param  latency
+    ///         Peripheral latency, the number of connection events the
+    ///         peripheral may skip if it has no data to send.
+    /// @param  now
+    ///         The current time, used as the (estimated) anchor for the
+    ///         connection events.
+    void setParameters(uint16_t interval, uint16_t latency, uint32_t now) {
+        this->interval = interval;
+        this->latency = latency;
+        this->anchor = now;
+        this->slot_count = 0;
+    }
+    /// Get the connection interval as a multiple of 1.25 ms.
+    uint16_t getInterval() const { return interval; }
+    /// Get the connection interval in microseconds.
+    uint32_t getIntervalMicros() const { return uint32_t(interval) * 1250; }
+    /// Check whether the connection interval is known.
+    bool isKnown() const { return interval != 0; }
+    /// Get the peripheral latency, the number of connection events the
+    /// peripheral may skip if it has no data to send.
+    uint16_t getLatency() const { return latency; }
+
+    /// Set how long before a connection event a notification should be handed
+    /// to the BLE stack to make it into that event.
+    void setGuardTime(uint32_t guard) { this->guard = guard; }
+    /// @see @ref setGuardTime
+    uint32_t getGuardTime() const { return guard; }
+    /// Set the maximum number of notifications that the BLE stack can send in
+    /// a single connection event (zero means no limit).
+    void setMaxNotificationsPerEvent(uint8_t n) { max_per_event = n; }
+    /// @see @ref setMaxNotificationsPerEvent
+    uint8_t getMaxNotificationsPerEvent() const { return max_per_event; }
+
+    /// Move the anchor to the most recent connection event before @p now, so
+    /// the time differences don't overflow. Should be called at least once
+    /// every half hour or so.
+    void update(uint32_t now) {
+        if (!isKnown())
+            return;
+        uint32_t itvl = getIntervalMicros();
+        int32_t d = int32_t(now - anchor);
+        if (d >= int32_t(itvl))
+            anchor += uint32_t(d) / itvl * itvl;
+    }
+
+    /// Get the time of the first connection event at or after time @p t.
+    uint32_t getNextEvent(uint32_t t) const {
+        int32_t itvl = int32_t(getIntervalMicros());
+        int32_t d = int32_t(t - anchor);
+        int32_t k = d >= 0 ? (d + itvl - 1) / itvl : -(-d / itvl);
+        return anchor + uint32_t(k) * uint32_t(itvl);
+    }
+
+    /// Get the earliest time at which the next notification can be handed to
+    /// the BLE stack, taking into account the maximum number of notifications
+    /// per connection event.
+    uint32_t getNotificationTime(uint32_t now) const {
+        if (!isKnown() || max_per_event == 0)
+            return now;
+        uint32_t event = getNextEvent(now + guard);
+        if (slot_count == 0 || event != slot_event ||
+            slot_count < max_per_event)
+            return now;
+        return event + getIntervalMicros() - guard;
+    }
+    /// Register that a notification was handed to the BLE stack at time
+    /// @p now.
+    void registerNotification(uint32_t now) {
+        if (!isKnown() || max_per_event == 0)
+            return;
+        uint32_t event = getNextEvent(now + guard);
+        if (slot_count > 0 && event == slot_event) {
+            ++slot_count;
+        } else {
+            slot_event = event;
+            slot_count = 1;
+        }
+    }
+
+  private:
+    uint16_t interval = 0;
+    uint16_t latency = 0;
+    uint8_t max_per_event = 0;
+    uint8_t slot_count = 0;
+    uint32_t guard = 1000;
+    uint32_t anchor = 0;
+    uint32_t slot_event = 0;
+};
+
+END_CS_NAMESPACE
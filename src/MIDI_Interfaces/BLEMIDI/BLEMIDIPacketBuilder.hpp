@@ -4,14 +4,60 @@
 
 #include <AH/STL/vector>
 
+#include <assert.h>
+
 BEGIN_CS_NAMESPACE
 
+/// Byte buffer with a fixed maximum capacity and inline storage, with the
+/// subset of the `std::vector` interface used by
+/// @ref BasicBLEMIDIPacketBuilder. It never allocates.
+/// @tparam MaxCapacity
+///         The maximum capacity of the buffer. Should be the largest ATT
+///         payload that will be used, i.e. the largest MTU minus three bytes.
+template <uint16_t MaxCapacity>
+class StaticBLEMIDIPacketBuffer {
+  public:
+    StaticBLEMIDIPacketBuffer() = default;
+    StaticBLEMIDIPacketBuffer(uint16_t) {}
+
+    void push_back(uint8_t b) {
+        assert(count < MaxCapacity);
+        storage[count++] = b;
+    }
+    uint16_t size() const { return count; }
+    uint16_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+    const uint8_t *data() const { return storage; }
+    const uint8_t *begin() const { return storage; }
+    const uint8_t *end() const { return storage + count; }
+    void resize(uint16_t) { count = 0; } ///< Only used to clear the buffer.
+    /// Set the capacity, limited to @p MaxCapacity. Like `std::vector`, the
+    /// capacity never becomes smaller than the size.
+    void reserve(uint16_t capacity) {
+        cap = capacity < MaxCapacity ? capacity : MaxCapacity;
+        if (cap < count)
+            cap = count;
+    }
+    void shrink_to_fit() {}
+
+  private:
+    uint16_t count = 0;
+    uint16_t cap = MaxCapacity;
+    uint8_t storage[MaxCapacity];
+};
+
 /// Class for building MIDI over Bluetooth Low Energy packets.
-class BLEMIDIPacketBuilder {
+/// @tparam Buffer
+///         The type of buffer to store the packet in, either
+///         `std::vector<uint8_t>` or @ref StaticBLEMIDIPacketBuffer.
+/// @see    @ref BLEMIDIPacketBuilder
+/// @see    @ref StaticBLEMIDIPacketBuilder
+template <class Buffer>
+class BasicBLEMIDIPacketBuilder {
   private:
     uint8_t runningHeader = 0;
     uint8_t runningTimestamp = 0;
-    std::vector<uint8_t> buffer = std::vector<uint8_t>(0);
+    Buffer buffer = Buffer(0);
 
     constexpr static const uint8_t SysExStart =
         static_cast<uint8_t>(MIDIMessageType::SysExStart);
@@ -66,14 +112,19 @@ class BLEMIDIPacketBuilder {
                  uint16_t timestamp);
 
   public:
-    BLEMIDIPacketBuilder(size_t capacity = 20) { buffer.reserve(capacity); }
+    BasicBLEMIDIPacketBuilder(size_t capacity = 20) {
+        buffer.reserve(capacity);
+    }
 
     /// Reset the builder to start a new packet.
     void reset();
 
     /// Set the maximum capacity of the buffer. Set this to the MTU of the BLE
-    /// link minus three bytes (for notify overhead).
+    /// link minus three bytes (for notify overhead). For a static buffer, the
+    /// capacity is limited to the size of its storage.
     void setCapacity(uint16_t capacity);
+    /// Get the maximum capacity of the buffer.
+    uint16_t getCapacity() const { return buffer.capacity(); }
 
     /// Get the size of the current packet.
     uint16_t getSize() const { return buffer.size(); }
@@ -82,8 +133,8 @@ class BLEMIDIPacketBuilder {
     /// Check if the packet buffer is empty.
     bool empty() const { return buffer.empty(); }
 
-    /// Return the packet as a vector of bytes.
-    const std::vector<uint8_t> &getPacket() const { return buffer; }
+    /// Return the packet buffer.
+    const Buffer &getPacket() const { return buffer; }
 
     /** 
      * @brief   Try adding a 3-byte MIDI channel voice message to the packet.
@@ -234,4 +285,19 @@ class BLEMIDIPacketBuilder {
                        uint16_t timestamp);
 };
 
+/// Builds MIDI over Bluetooth Low Energy packets in a dynamically allocated
+/// buffer that is resized when the capacity changes.
+using BLEMIDIPacketBuilder = BasicBLEMIDIPacketBuilder<std::vector<uint8_t>>;
+
+/// Builds MIDI over Bluetooth Low Energy packets in a buffer with inline
+/// storage, so adding messages or changing the capacity never allocates.
+/// @tparam MaxCapacity
+///         The largest ATT payload that will be used, i.e. the largest MTU
+///         minus three bytes.
+template <uint16_t MaxCapacity>
+using StaticBLEMIDIPacketBuilder =
+    BasicBLEMIDIPacketBuilder<StaticBLEMIDIPacketBuffer<MaxCapacity>>;
+
 END_CS_NAMESPACE
+
+#include "BLEMIDIPacketBuilder.ipp"
@@ -1,10 +1,14 @@
 #include "BLEMIDIPacketBuilder.hpp"
 
+#include <AH/Error/Error.hpp>
+
 BEGIN_CS_NAMESPACE
 
+template <class Buffer>
 template <bool ThreeBytes>
-bool BLEMIDIPacketBuilder::addImpl(uint8_t header, uint8_t data1, uint8_t data2,
-                                   uint16_t timestamp) {
+bool BasicBLEMIDIPacketBuilder<Buffer>::addImpl(uint8_t header, uint8_t data1,
+                                                uint8_t data2,
+                                                uint16_t timestamp) {
     initBuffer(timestamp);
 
     uint8_t timestampLSB = getTimestampLSB(timestamp);
@@ -45,31 +49,38 @@ bool BLEMIDIPacketBuilder::addImpl(uint8_t header, uint8_t data1, uint8_t data2,
     return true;
 }
 
-void BLEMIDIPacketBuilder::reset() {
+template <class Buffer>
+void BasicBLEMIDIPacketBuilder<Buffer>::reset() {
     buffer.resize(0);
     runningHeader = 0;
 }
 
-void BLEMIDIPacketBuilder::setCapacity(uint16_t capacity) {
+template <class Buffer>
+void BasicBLEMIDIPacketBuilder<Buffer>::setCapacity(uint16_t capacity) {
     if (capacity < 5)
         ERROR(F("capacity less than 5 bytes"), 0x2005); // LCOV_EXCL_LINE
     buffer.shrink_to_fit();
     buffer.reserve(capacity);
 }
 
-bool BLEMIDIPacketBuilder::add3B(uint8_t header, uint8_t data1, uint8_t data2,
-                                 uint16_t timestamp) {
+template <class Buffer>
+bool BasicBLEMIDIPacketBuilder<Buffer>::add3B(uint8_t header, uint8_t data1,
+                                              uint8_t data2,
+                                              uint16_t timestamp) {
     constexpr bool ThreeBytes = true;
     return addImpl<ThreeBytes>(header, data1, data2, timestamp);
 }
 
-bool BLEMIDIPacketBuilder::add2B(uint8_t header, uint8_t data1,
-                                 uint16_t timestamp) {
+template <class Buffer>
+bool BasicBLEMIDIPacketBuilder<Buffer>::add2B(uint8_t header, uint8_t data1,
+                                              uint16_t timestamp) {
     constexpr bool ThreeBytes = false;
     return addImpl<ThreeBytes>(header, data1, 0, timestamp);
 }
 
-bool BLEMIDIPacketBuilder::addRealTime(uint8_t rt, uint16_t timestamp) {
+template <class Buffer>
+bool BasicBLEMIDIPacketBuilder<Buffer>::addRealTime(uint8_t rt,
+                                                    uint16_t timestamp) {
     initBuffer(timestamp);
 
     if (!hasSpaceFor(2))
@@ -82,9 +93,12 @@ bool BLEMIDIPacketBuilder::addRealTime(uint8_t rt, uint16_t timestamp) {
     return true;
 }
 
-bool BLEMIDIPacketBuilder::addSysCommon(uint8_t num_data, uint8_t header,
-                                        uint8_t data1, uint8_t data2,
-                                        uint16_t timestamp) {
+template <class Buffer>
+bool BasicBLEMIDIPacketBuilder<Buffer>::addSysCommon(uint8_t num_data,
+                                                     uint8_t header,
+                                                     uint8_t data1,
+                                                     uint8_t data2,
+                                                     uint16_t timestamp) {
     initBuffer(timestamp);
 
     uint8_t timestampLSB = getTimestampLSB(timestamp);
@@ -102,8 +116,10 @@ bool BLEMIDIPacketBuilder::addSysCommon(uint8_t num_data, uint8_t header,
     return true;
 }
 
-bool BLEMIDIPacketBuilder::addSysEx(const uint8_t *&data, size_t &length,
-                                    uint16_t timestamp) {
+template <class Buffer>
+bool BasicBLEMIDIPacketBuilder<Buffer>::addSysEx(const uint8_t *&data,
+                                                 size_t &length,
+                                                 uint16_t timestamp) {
     initBuffer(timestamp);
 
     // We can't do anything with an empty message
@@ -134,8 +150,10 @@ bool BLEMIDIPacketBuilder::addSysEx(const uint8_t *&data, size_t &length,
     return true;
 }
 
-void BLEMIDIPacketBuilder::continueSysEx(const uint8_t *&data, size_t &length,
-                                         uint16_t timestamp) {
+template <class Buffer>
+void BasicBLEMIDIPacketBuilder<Buffer>::continueSysEx(const uint8_t *&data,
+                                                      size_t &length,
+                                                      uint16_t timestamp) {
     initBuffer(timestamp);
 
     if (length == 0) {
@@ -183,7 +201,9 @@ void BLEMIDIPacketBuilder::continueSysEx(const uint8_t *&data, size_t &length,
     }
 }
 
-constexpr const uint8_t BLEMIDIPacketBuilder::SysExStart;
-constexpr const uint8_t BLEMIDIPacketBuilder::SysExEnd;
+template <class Buffer>
+constexpr const uint8_t BasicBLEMIDIPacketBuilder<Buffer>::SysExStart;
+template <class Buffer>
+constexpr const uint8_t BasicBLEMIDIPacketBuilder<Buffer>::SysExEnd;
 
 END_CS_NAMESPACE
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Settings/NamespaceSettings.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// Reconstructs the sender's clock from the 13-bit BLE-MIDI timestamps of
+/// received messages, and computes when each message should be released, so
+/// the timing of the messages is the same as when they were sent.
+///
+/// Messages are batched per connection event, so they all arrive at the same
+/// time, up to a full connection interval after they were sent. Releasing each
+/// message a fixed latency after the (estimated) time it was sent removes this
+/// jitter, as intended by the BLE-MIDI specification.
+///
+/// The difference between the local arrival time and the sender time of a
+/// message is the offset between the two clocks plus the transmission delay.
+/// The lower envelope of these differences is the offset plus the minimal
+/// delay. It is estimated as a line through the minimum of every window of
+/// @ref window_length, which takes into account the drift of the two clocks.
+///
+/// Local times are in microseconds, sender times in milliseconds. Both are
+/// allowed to wrap around. This class is not thread-safe.
+class BLEMIDIPlayoutClock {
+  public:
+    /// Set the playout latency: how long after the estimated sending time (plus
+    /// the minimal transmission delay) a message is released.
+    void setLatency(uint32_t latency) { this->latency = latency; }
+    /// @see @ref setLatency
+    uint32_t getLatency() const { return latency; }
+
+    /// Forget everything about the sender's clock.
+    void reset() {
+        synchronized = false;
+        has_sender_time = false;
+        resetHistory();
+    }
+    /// Check whether any timestamps have been received yet.
+    bool isSynchronized() const { return synchronized; }
+
+    /// Get the local time at which a message with the given timestamp that
+    /// arrived at local time @p now should be released. Never earlier than
+    /// @p now, and never later than @p now + @ref getLatency.
+    uint32_t schedule(uint16_t timestamp, uint32_t now) {
+        uint32_t sender_time = unwrap(timestamp, now);
+        addSample(sender_time, now);
+        uint32_t t = toLocalTime(sender_time) + latency;
+        if (int32_t(t - now) < 0)
+            return now;
+        if (t - now > latency)
+            return now + latency;
+        return t;
+    }
+
+    /// Convert the 13-bit BLE-MIDI timestamp (in milliseconds) of a message
+    /// that arrived at local time @p now to the full sender time, using the
+    /// time that elapsed since the previous message to resolve the overflow.
+    uint32_t unwrap(uint16_t timestamp, uint32_t now) {
+        if (!has_sender_time) {
+            has_sender_time = true;
+            sender_time = timestamp;
+        } else {
+            int32_t elapsed = int32_t(now - sender_time_local) / 1000;
+            uint32_t expected = sender_time + uint32_t(elapsed);
+            // Sign-extend the 13-bit difference with the expected time
+            uint16_t diff = uint16_t(timestamp - expected) << 3;
+            sender_time = expected + uint32_t(int16_t(diff) >> 3);
+        }
+        sender_time_local = now;
+        return sender_time;
+    }
+    /// Get the sender time of the latest message passed to @ref unwrap.
+    uint32_t getSenderTime() const { return sender_time; }
+
+    /// Update the estimated offset with a message with the given sender time
+    /// that arrived at local time @p now.
+    void addSample(uint32_t sender_time, uint32_t now) {
+        uint32_t offset = now - sender_time * 1000;
+        int32_t error = int32_t(offset - getOffset(now));
+        // The first sample, after a long silence, or if the sender's clock
+        // jumped: start over
+        int32_t elapsed = int32_t(now - window_start);
+        if (!synchronized ||
+            elapsed > int32_t(window_length * max_history_length) ||
+            error < -int32_t(resync_threshold)) {
+            synchronized = true;
+            resetHistory();
+            drift = 0;
+            base = offset;
+            base_time = now;
+            startWindow(offset, now);
+            return;
+        }
+        if (int32_t(offset - window_min) < 0) {
+            window_min = offset;
+            window_min_time = now;
+        }
+        // The envelope should never be above any of the samples
+        if (error < 0)
+            base += uint32_t(error);
+        if (elapsed >= int32_t(window_length))
+            closeWindow(offset, now);
+    }
+
+    /// Get the estimated offset between the local clock (µs) and the sender's
+    /// clock (ms × 1000) at local time @p t, including the minimal delay.
+    uint32_t getOffset(uint32_t t) const {
+        return base + uint32_t(int32_t(drift * float(int32_t(t - base_time))));
+    }
+    /// Convert the given sender time to the local time at which a message
+    /// sent at that time would arrive with the minimal delay.
+    uint32_t toLocalTime(uint32_t sender_time) const {
+        uint32_t t = sender_time * 1000;
+        return t + getOffset(t + base);
+    }
+    /// Get the estimated drift of the local clock relative to the sender's
+    /// clock (e.g. 100e-6 if the local clock runs 100 ppm faster).
+    float getDrift() const { return drift; }
+
+    /// Length of the windows in which the minimum offset is determined.
+    constexpr static uint32_t window_length = 1000000;
+    /// Number of window minima used to estimate the drift.
+    constexpr static uint8_t max_history_length = 8;
+    /// Larger estimated drifts are assumed to be measurement errors.
+    constexpr static float max_drift = 1e-3f;
+    /// If all samples in a window are this much later than the estimated
+    /// envelope, the sender's clock is assumed to have jumped (e.g. because
+    /// a different device connected).
+    constexpr static uint32_t resync_threshold = 100000;
+
+  private:
+    void resetHistory() {
+        hist_index = 0;
+        hist_count = 0;
+    }
+
+    void startWindow(uint32_t offset, uint32_t now) {
+        window_start = now;
+        window_min = offset;
+        window_min_time = now;
+    }
+
+    void closeWindow(uint32_t offset, uint32_t now) {
+        if (int32_t(window_min - getOffset(window_min_time)) >
+            int32_t(resync_threshold)) {
+            resetHistory();
+            drift = 0;
+            base = window_min;
+            base_time = window_min_time;
+        }
+        hist_time[hist_index] = window_min_time;
+        hist_offset[hist_index] = window_min;
+        hist_index = (hist_index + 1) % max_history_length;
+        if (hist_count < max_history_length)
+            ++hist_count;
+        fit();
+        startWindow(offset, now);
+    }
+
+    /// Fit a line through the window minima using least squares, and move it
+    /// down so it's not above any of them.
+    void fit() {
+        uint8_t newest = (hist_index + max_history_length - 1) %
+                         max_history_length;
+        uint32_t ref_time = hist_time[newest];
+        uint32_t ref_offset = hist_offset[newest];
+        auto x = [&](uint8_t i) {
+            return float(int32_t(hist_time[i] - ref_time));
+        };
+        auto y = [&](uint8_t i) {
+            return float(int32_t(hist_offset[i] - ref_offset));
+        };
+        float slope = 0;
+        if (hist_count >= 2) {
+            float mean_x = 0, mean_y = 0;
+            for (uint8_t i = 0; i < hist_count; ++i) {
+                mean_x += x(i);
+                mean_y += y(i);
+            }
+            mean_x /= hist_count;
+            mean_y /= hist_count;
+            float sxy = 0, sxx = 0;
+            for (uint8_t i = 0; i < hist_count; ++i) {
+                sxy += (x(i) - mean_x) * (y(i) - mean_y);
+                sxx += (x(i) - mean_x) * (x(i) - mean_x);
+            }
+            if (sxx > 0)
+                slope = sxy / sxx;
+            if (slope > max_drift)
+                slope = max_drift;
+            else if (slope < -max_drift)
+                slope = -max_drift;
+        }
+        float intercept = 0;
+        for (uint8_t i = 0; i < hist_count; ++i) {
+            float residual = y(i) - slope * x(i);
+            if (residual < intercept)
+                intercept = residual;
+        }
+        drift = slope;
+        base = ref_offset + uint32_t(int32_t(intercept));
+        base_time = ref_time;
+    }
+
+  private:
+    uint32_t latency = 10000;
+    bool synchronized = false;
+    /// Latest unwrapped sender time, and the local time it arrived.
+    bool has_sender_time = false;
+    uint32_t sender_time = 0;
+    uint32_t sender_time_local = 0;
+    /// The estimated envelope: offset @ref base at local time @ref base_time,
+    /// with slope @ref drift.
+    uint32_t base = 0;
+    uint32_t base_time = 0;
+    float drift = 0;
+    /// The minimum offset in the current window.
+    uint32_t window_start = 0;
+    uint32_t window_min = 0;
+    uint32_t window_min_time = 0;
+    /// The minimum offsets of the previous windows.
+    uint32_t hist_time[max_history_length] {};
+    uint32_t hist_offset[max_history_length] {};
+    uint8_t hist_index = 0;
+    uint8_t hist_count = 0;
+};
+
+END_CS_NAMESPACE
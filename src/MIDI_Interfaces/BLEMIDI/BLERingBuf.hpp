@@ -158,6 +158,33 @@ class BLERingBuf {
             return header.getType();
         }
     }
+
+    /// Release the part of the current chunk (the one returned by the last
+    /// call to @ref pop) before @p next, so the writer can reuse that space
+    /// before the rest of the chunk has been read. The part of the chunk
+    /// starting at @p next remains valid until the next call to @ref pop.
+    /// Space is released in multiples of the header size, so up to one byte
+    /// before @p next may remain in use.
+    void consume(const uint8_t *next) {
+        assert(read_p < capacity);
+        assert(read_p % header_size == 0);
+        Header header;
+        std::memcpy(&header, buffer + read_p, sizeof(header));
+        if (header.getType() == BLEDataType::None)
+            return;
+        const unsigned char *chunk = buffer + read_p + header_size;
+        assert(next >= chunk && next <= chunk + header.size);
+        uint_fast16_t consumed = next - chunk;
+        consumed -= consumed % header_size;
+        if (consumed == 0)
+            return;
+        // The new header overwrites the last data bytes that were consumed,
+        // which are still owned by the reader until the size is updated
+        Header new_header {uint16_t(header.size - consumed), header.getType()};
+        read_p += consumed;
+        std::memcpy(buffer + read_p, &new_header, sizeof(new_header));
+        size.sub_release(consumed);
+    }
 };
 
 END_CS_NAMESPACE
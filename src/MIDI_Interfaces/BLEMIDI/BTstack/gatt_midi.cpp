@@ -54,9 +54,13 @@ void connection_handler(uint8_t *packet, [[maybe_unused]] uint16_t size) {
         settings.connection_interval.maximum, conn_latency,
         supervision_timeout);
     instance->handleConnect(BLEConnectionHandle {conn_handle});
+    instance->handleConnectionParameters(
+        BLEConnectionHandle {conn_handle},
+        hci_subevent_le_connection_complete_get_conn_interval(packet),
+        hci_subevent_le_connection_complete_get_conn_latency(packet));
 }
 // HCI_SUBEVENT_LE_CONNECTION_UPDATE_COMPLETE
-void connection_update_handler([[maybe_unused]] uint8_t *packet,
+void connection_update_handler(uint8_t *packet,
                                [[maybe_unused]] uint16_t size) {
     DEBUGREF( // clang-format off
         "Connection update: status="
@@ -68,6 +72,16 @@ void connection_update_handler([[maybe_unused]] uint8_t *packet,
         << ", supervision timeout="
         << hci_subevent_le_connection_update_complete_get_supervision_timeout(packet));
               // clang-format on
+    if (!instance)
+        return;
+    if (hci_subevent_le_connection_update_complete_get_status(packet) != 0)
+        return;
+    instance->handleConnectionParameters(
+        BLEConnectionHandle {
+            hci_subevent_le_connection_update_complete_get_connection_handle(
+                packet)},
+        hci_subevent_le_connection_update_complete_get_conn_interval(packet),
+        hci_subevent_le_connection_update_complete_get_conn_latency(packet));
 }
 // HCI_SUBEVENT_LE_REMOTE_CONNECTION_PARAMETER_REQUEST
 void connection_param_req_handler([[maybe_unused]] uint8_t *packet,
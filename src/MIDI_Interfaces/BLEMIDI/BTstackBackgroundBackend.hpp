@@ -31,6 +31,10 @@ class BTstackBackgroundBackend
     void handleMTU(BLEConnectionHandle, uint16_t mtu) override {
         Sender::updateMTU(mtu);
     }
+    void handleConnectionParameters(BLEConnectionHandle, uint16_t interval,
+                                    uint16_t latency) override {
+        Sender::updateConnectionParameters(interval, latency);
+    }
     void handleSubscribe(BLEConnectionHandle,
                          BLECharacteristicHandle char_handle,
                          bool notify) override {
@@ -126,7 +130,9 @@ class BTstackBackgroundBackend
     // Expose the necessary BLE sender functions.
     using Sender::acquirePacket;
     using Sender::forceMinMTU;
+    using Sender::getConnectionInterval;
     using Sender::getMinMTU;
+    using Sender::getPeripheralLatency;
     using Sender::releasePacketAndNotify;
     using Sender::sendNow;
     using Sender::setTimeout;
@@ -21,6 +21,8 @@ class BufferedBLEMIDIParser {
     BLEMIDIParser ble_parser {nullptr, 0};
     /// Parser for MIDI data extracted from the BLE packet by @ref ble_parser.
     SerialMIDI_Parser parser {false};
+    /// Run of MIDI bytes in the current chunk that hasn't been parsed yet.
+    const uint8_t *run_begin = nullptr, *run_end = nullptr;
 
   public:
     using IncomingMIDIMessage = AnyMIDIMessage;
@@ -32,10 +34,18 @@ class BufferedBLEMIDIParser {
     }
 
     /// Retrieve and remove a single incoming MIDI message from the buffer.
+    ///
+    /// The MIDI data is parsed directly from the storage of the ring buffer
+    /// (also for packets that wrap around), and the space of the data that
+    /// has been parsed is released after every message, so a large packet
+    /// doesn't block @ref pushPacket until it has been parsed completely.
     bool popMessage(IncomingMIDIMessage &incomingMessage) {
-        // Try reading a MIDI message from the parser
+        // Try reading a MIDI message from the current run of MIDI bytes
         auto try_read = [&] {
-            MIDIReadEvent event = parser.pull(ble_parser);
+            size_t run_length = run_end - run_begin;
+            BufferPuller_<uint8_t> puller {run_begin, run_length};
+            MIDIReadEvent event = parser.pull(puller);
+            run_begin = puller.begin();
             switch (event) {
                 case MIDIReadEvent::CHANNEL_MESSAGE:
                     incomingMessage = {parser.getChannelMessage(),
@@ -60,15 +70,29 @@ class BufferedBLEMIDIParser {
             return false;
         };
         while (true) {
-            // Try reading a MIDI message from the current buffer
-            if (try_read())
+            // Get the next run of MIDI bytes from the current chunk if the
+            // current run was parsed completely. If the parser still has a
+            // byte left from the previous message, parse that first, because
+            // the next run may update the timestamp.
+            bool has_run = run_begin != run_end || parser.hasStoredByte() ||
+                           ble_parser.pullRun(run_begin, run_end);
+            // Try reading a MIDI message from the current run
+            if (try_read()) {
+                // The parser copied everything it needs, so the data that
+                // was parsed can be overwritten by new packets
+                ble_buffer.consume(run_begin);
                 return true; // success, incomingMessage updated
+            }
+            // No complete message yet, try the next run
+            if (has_run)
+                continue;
             // Get the next chunk of the BLE packet (if available)
             BLEDataView chunk;
             auto popped = ble_buffer.pop(chunk);
             if (popped == BLEDataType::None)
                 return false; // no more BLE data available
-            else if (popped == BLEDataType::Continuation)
+            run_begin = run_end = chunk.data;
+            if (popped == BLEDataType::Continuation)
                 ble_parser.extend(chunk.data, chunk.length); // same BLE packet
             else if (popped == BLEDataType::Packet)
                 ble_parser = {chunk.data, chunk.length}; // new BLE packet
@@ -227,8 +227,12 @@ inline int cs_midi_ble_gap_callback(struct ble_gap_event *event, void *) {
                 }
                 // Update the connection parameters
                 update_connection_params(conn_handle, settings);
-                if (auto *inst = cs::midi_ble_nimble::state->instance)
+                if (auto *inst = cs::midi_ble_nimble::state->instance) {
                     inst->handleConnect(cs::BLEConnectionHandle {conn_handle});
+                    inst->handleConnectionParameters(
+                        cs::BLEConnectionHandle {conn_handle}, desc.conn_itvl,
+                        desc.conn_latency);
+                }
             } else {
                 // Connection failed; resume advertising
                 cs::midi_ble_nimble::advertise(
@@ -258,6 +262,10 @@ inline int cs_midi_ble_gap_callback(struct ble_gap_event *event, void *) {
             auto rc = ble_gap_conn_find(event->conn_update.conn_handle, &desc);
             assert(rc == 0);
             cs::midi_ble_nimble::print_conn_desc(&desc);
+            if (auto *inst = cs::midi_ble_nimble::state->instance)
+                inst->handleConnectionParameters(
+                    cs::BLEConnectionHandle {event->conn_update.conn_handle},
+                    desc.conn_itvl, desc.conn_latency);
         } break;
 
         // Advertising done (e.g. after reaching the specified timeout)
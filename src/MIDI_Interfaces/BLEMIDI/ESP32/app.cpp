@@ -30,6 +30,14 @@ void midi_ble_instance_handle_mtu(uint16_t conn_handle, uint16_t mtu) {
         midi_ble_bluedroid_instance->handleMTU(
             BLEConnectionHandle {conn_handle}, mtu);
 }
+void midi_ble_instance_handle_connection_parameters(uint16_t interval,
+                                                    uint16_t latency) {
+    // Bluedroid reports the connection parameters per device address rather
+    // than per connection
+    if (midi_ble_bluedroid_instance)
+        midi_ble_bluedroid_instance->handleConnectionParameters(
+            BLEConnectionHandle {}, interval, latency);
+}
 void midi_ble_instance_handle_subscribe(uint16_t conn_handle,
                                         uint16_t char_handle, bool notify) {
     if (midi_ble_bluedroid_instance)
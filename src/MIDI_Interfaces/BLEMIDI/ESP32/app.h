@@ -10,6 +10,8 @@ extern "C" {
 void midi_ble_instance_handle_connect(uint16_t conn_handle);
 void midi_ble_instance_handle_disconnect(uint16_t conn_handle);
 void midi_ble_instance_handle_mtu(uint16_t conn_handle, uint16_t mtu);
+void midi_ble_instance_handle_connection_parameters(uint16_t interval,
+                                                    uint16_t latency);
 void midi_ble_instance_handle_subscribe(uint16_t conn_handle,
                                         uint16_t char_handle, bool notify);
 void midi_ble_instance_handle_data(uint16_t conn_handle, const uint8_t *data,
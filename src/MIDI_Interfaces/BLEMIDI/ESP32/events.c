@@ -3,6 +3,7 @@
 #if CONFIG_BT_BLE_ENABLED
 
 #include "advertising.h"
+#include "app.h"
 #include "esp_enums2string.h"
 #include "events-debug.h"
 #include "logging.h"
@@ -50,7 +51,12 @@ void gap_event_handler(esp_gap_ble_cb_event_t event,
             }
             break;
 
-        case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT: break;
+        case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
+            if (param->update_conn_params.status == ESP_BT_STATUS_SUCCESS)
+                midi_ble_instance_handle_connection_parameters(
+                    param->update_conn_params.conn_int,
+                    param->update_conn_params.latency);
+            break;
 
         case ESP_GAP_BLE_PASSKEY_REQ_EVT: break;
         case ESP_GAP_BLE_OOB_REQ_EVT: break;
@@ -19,12 +19,18 @@ BEGIN_CS_NAMESPACE
 
 /// ESP32 backend intended to be plugged into @ref GenericBLEMIDI_Interface.
 /// @p Impl can be used to select different low-level BLE stacks.
+/// Packets are built in static storage that is large enough for the largest
+/// MTU (515 bytes, see @ref ThreadedBLEMIDISender::forceMinMTU), so sending
+/// never allocates.
 template <class Impl>
-class ESP32BLEBackend : private ThreadedBLEMIDISender<ESP32BLEBackend<Impl>>,
-                        private MIDIBLEInstance {
+class ESP32BLEBackend
+    : private ThreadedBLEMIDISender<ESP32BLEBackend<Impl>,
+                                    StaticBLEMIDIPacketBuilder<512>>,
+      private MIDIBLEInstance {
   protected:
     [[no_unique_address]] Impl impl;
-    using Sender = ThreadedBLEMIDISender<ESP32BLEBackend>;
+    using Sender = ThreadedBLEMIDISender<ESP32BLEBackend,
+                                         StaticBLEMIDIPacketBuilder<512>>;
     friend Sender;
     void sendData(BLEDataView data) {
         auto chr = characteristic.load();
@@ -54,6 +60,13 @@ class ESP32BLEBackend : private ThreadedBLEMIDISender<ESP32BLEBackend<Impl>>,
         ESP_LOGD("CS-BLEMIDI", "conn=%d, mtu=%d", conn_handle.conn, mtu);
         Sender::updateMTU(mtu);
     }
+    void handleConnectionParameters(
+        [[maybe_unused]] BLEConnectionHandle conn_handle, uint16_t interval,
+        uint16_t latency) override {
+        ESP_LOGD("CS-BLEMIDI", "conn=%d, interval=%d, latency=%d",
+                 conn_handle.conn, interval, latency);
+        Sender::updateConnectionParameters(interval, latency);
+    }
     void handleSubscribe(BLEConnectionHandle conn_handle,
                          BLECharacteristicHandle char_handle,
                          bool notify) override {
@@ -131,10 +144,14 @@ class ESP32BLEBackend : private ThreadedBLEMIDISender<ESP32BLEBackend<Impl>>,
     }
     using Sender::acquirePacket;
     using Sender::forceMinMTU;
+    using Sender::getConnectionInterval;
     using Sender::getMinMTU;
+    using Sender::getPeripheralLatency;
     using Sender::releasePacketAndNotify;
     using Sender::sendNow;
+    using Sender::setMaxNotificationsPerEvent;
     using Sender::setTimeout;
+    using Sender::waitUntilSent;
 };
 
 END_CS_NAMESPACE
\ No newline at end of file
@@ -5,12 +5,16 @@
 #include <chrono>
 
 #include "BLEAPI.hpp"
+#include "BLEConnectionEvents.hpp"
 #include <MIDI_Interfaces/BLEMIDI/BLEMIDIPacketBuilder.hpp>
 
 BEGIN_CS_NAMESPACE
 
 /// Class that buffers MIDI BLE packets.
-template <class Derived>
+/// @tparam  PacketBuilder
+///         The type used to build the packets, @ref BLEMIDIPacketBuilder or
+///         @ref StaticBLEMIDIPacketBuilder (which never allocates).
+template <class Derived, class PacketBuilder = BLEMIDIPacketBuilder>
 class PollingBLEMIDISender {
   public:
     PollingBLEMIDISender() = default;
@@ -47,18 +51,34 @@ class PollingBLEMIDISender {
     /// messages.
     void setTimeout(std::chrono::milliseconds timeout);
 
+    /// Set the connection interval (as a multiple of 1.25 ms, zero means
+    /// unknown) and the peripheral latency negotiated for the BLE link.
+    /// @see    @ref BLEConnectionEvents
+    void updateConnectionParameters(uint16_t interval, uint16_t latency);
+    /// Get the connection interval as a multiple of 1.25 ms (zero if unknown).
+    uint16_t getConnectionInterval() const {
+        return connection_events.getInterval();
+    }
+    /// Get the peripheral latency, the number of connection events the
+    /// peripheral may skip if it has no data to send.
+    uint16_t getPeripheralLatency() const {
+        return connection_events.getLatency();
+    }
+
   private:
     /// Actually perform the BLE notification with the given data.
     void sendData(BLEDataView) = delete; // should be implemented by subclass
 
   private:
     /// View of the data to send
-    BLEMIDIPacketBuilder packet;
-    /// Timeout before the sender thread sends a packet.
+    PacketBuilder packet;
+    /// Timeout (in microseconds) before the sender sends a packet.
     /// @see @ref setTimeout()
-    unsigned long timeout {10};
-    /// Time point when the packet was started.
-    unsigned long packet_start_time {0};
+    uint32_t timeout {10000};
+    /// Time point (in microseconds) when the packet was started.
+    uint32_t packet_start_time {0};
+    /// Connection parameters reported by the backend.
+    BLEConnectionEvents connection_events;
 
   private:
     /// The minimum MTU of all connected clients.
@@ -70,7 +90,7 @@ class PollingBLEMIDISender {
 
   public:
     struct ProtectedBuilder {
-        BLEMIDIPacketBuilder *packet;
+        PacketBuilder *packet;
     };
 };
 
@@ -4,27 +4,30 @@
 
 BEGIN_CS_NAMESPACE
 
-template <class Derived>
-PollingBLEMIDISender<Derived>::~PollingBLEMIDISender() = default;
+template <class Derived, class PacketBuilder>
+PollingBLEMIDISender<Derived, PacketBuilder>::~PollingBLEMIDISender() = default;
 
-template <class Derived>
-void PollingBLEMIDISender<Derived>::begin() {}
+template <class Derived, class PacketBuilder>
+void PollingBLEMIDISender<Derived, PacketBuilder>::begin() {}
 
-template <class Derived>
-auto PollingBLEMIDISender<Derived>::acquirePacket() -> ProtectedBuilder {
+template <class Derived, class PacketBuilder>
+auto PollingBLEMIDISender<Derived, PacketBuilder>::acquirePacket()
+    -> ProtectedBuilder {
     if (packet.getSize() == 0)
-        packet_start_time = millis();
+        packet_start_time = micros();
     return {&packet};
 }
 
-template <class Derived>
-void PollingBLEMIDISender<Derived>::releasePacketAndNotify(ProtectedBuilder &lck) {
-    if (lck.packet->getSize() > 0 && millis() - packet_start_time > timeout)
+template <class Derived, class PacketBuilder>
+void PollingBLEMIDISender<Derived, PacketBuilder>::releasePacketAndNotify(
+    ProtectedBuilder &lck) {
+    if (lck.packet->getSize() > 0 && micros() - packet_start_time > timeout)
         sendNow(lck);
 }
 
-template <class Derived>
-void PollingBLEMIDISender<Derived>::sendNow(ProtectedBuilder &lck) {
+template <class Derived, class PacketBuilder>
+void PollingBLEMIDISender<Derived, PacketBuilder>::sendNow(
+    ProtectedBuilder &lck) {
     BLEDataView data {lck.packet->getBuffer(), lck.packet->getSize()};
     if (data.length > 0) {
         CRTP(Derived).sendData(data);
@@ -33,8 +36,8 @@ void PollingBLEMIDISender<Derived>::sendNow(ProtectedBuilder &lck) {
     }
 }
 
-template <class Derived>
-void PollingBLEMIDISender<Derived>::updateMTU(uint16_t mtu) {
+template <class Derived, class PacketBuilder>
+void PollingBLEMIDISender<Derived, PacketBuilder>::updateMTU(uint16_t mtu) {
     if (force_min_mtu == 0)
         min_mtu = mtu;
     else
@@ -45,15 +48,22 @@ void PollingBLEMIDISender<Derived>::updateMTU(uint16_t mtu) {
         lck.packet->setCapacity(min_mtu - 3);
 }
 
-template <class Derived>
-void PollingBLEMIDISender<Derived>::forceMinMTU(uint16_t mtu) {
+template <class Derived, class PacketBuilder>
+void PollingBLEMIDISender<Derived, PacketBuilder>::forceMinMTU(uint16_t mtu) {
     force_min_mtu = mtu;
     updateMTU(min_mtu);
 }
 
-template <class Derived>
-void PollingBLEMIDISender<Derived>::setTimeout(std::chrono::milliseconds timeout) {
-    this->timeout = timeout.count();
+template <class Derived, class PacketBuilder>
+void PollingBLEMIDISender<Derived, PacketBuilder>::setTimeout(
+    std::chrono::milliseconds timeout) {
+    this->timeout = timeout.count() * 1000;
+}
+
+template <class Derived, class PacketBuilder>
+void PollingBLEMIDISender<Derived, PacketBuilder>::updateConnectionParameters(
+    uint16_t interval, uint16_t latency) {
+    connection_events.setParameters(interval, latency, micros());
 }
 
 END_CS_NAMESPACE
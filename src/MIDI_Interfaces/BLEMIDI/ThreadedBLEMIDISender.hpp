@@ -2,18 +2,33 @@
 
 #include <Settings/NamespaceSettings.hpp>
 
+#include <atomic>
 #include <chrono>
-#include <condition_variable>
-#include <mutex>
 #include <thread>
 
 #include "BLEAPI.hpp"
+#include "BLEConnectionEvents.hpp"
+#include "Util/BinarySemaphore.hpp"
 #include <MIDI_Interfaces/BLEMIDI/BLEMIDIPacketBuilder.hpp>
 
 BEGIN_CS_NAMESPACE
 
 /// Class that manages a background thread that sends BLE packets asynchronously.
-template <class Derived>
+/// @tparam  PacketBuilder
+///         The type used to build the packets, @ref BLEMIDIPacketBuilder or
+///         @ref StaticBLEMIDIPacketBuilder (which never allocates).
+///
+/// There are two packet buffers: the main thread fills one of them, while the
+/// sender thread transmits the other one. They are handed off using atomic
+/// operations only, so the main thread never has to wait for a lock that's
+/// held by the sender thread. It only has to wait if it has filled a packet
+/// before the previous packet was transmitted.
+///
+/// Partially filled packets are sent after a fixed timeout. If the backend
+/// reports the connection interval (see @ref updateConnectionParameters), the
+/// number of notifications per connection event can be limited (see
+/// @ref setMaxNotificationsPerEvent).
+template <class Derived, class PacketBuilder = BLEMIDIPacketBuilder>
 class ThreadedBLEMIDISender {
   public:
     ThreadedBLEMIDISender() = default;
@@ -24,9 +39,11 @@ class ThreadedBLEMIDISender {
     /// Start the background thread.
     void begin();
 
-    struct ProtectedBuilder;
+    class ProtectedBuilder;
 
-    /// Acquire exclusive access to the buffer to be sent by the timer.
+    /// Acquire exclusive access to the buffer that is being filled. Only the
+    /// main thread is allowed to fill the buffer, so this function should not
+    /// be called from any other thread (e.g. the BLE stack's callbacks).
     /// @return A RAII wrapper that automatically releases the buffer upon
     ///         destruction. Just make sure you don't keep any pointers to the
     ///         `packet` member.
@@ -35,11 +52,19 @@ class ThreadedBLEMIDISender {
     /// data is available.
     void releasePacketAndNotify(ProtectedBuilder &lck);
 
-    /// Sends the data immediately without waiting for the timeout.
+    /// Hand off the packet to the sender thread to be sent immediately, without
+    /// waiting for the timeout, and continue with the other (empty) buffer.
+    /// Never blocks: if the previous packet is still being sent, the sender
+    /// thread takes this packet as soon as it's done, and `lck.packet` keeps
+    /// pointing to the same (non-empty) buffer.
     void sendNow(ProtectedBuilder &lck);
+    /// Wait until all packets that were handed off using @ref sendNow have
+    /// been sent.
+    void waitUntilSent() const;
 
     /// Set the maximum transmission unit of the Bluetooth link. Used to compute
-    /// the MIDI BLE packet size.
+    /// the MIDI BLE packet size. Can be called from any thread, the new size
+    /// only applies to packets that are started afterwards.
     void updateMTU(uint16_t mtu);
     /// Get the minimum MTU of all connected clients.
     uint16_t getMinMTU() const { return min_mtu; }
@@ -50,36 +75,87 @@ class ThreadedBLEMIDISender {
     /// messages.
     void setTimeout(std::chrono::milliseconds timeout);
 
+    /// Set the connection interval (as a multiple of 1.25 ms, zero means
+    /// unknown) and the peripheral latency negotiated for the BLE link. Can be
+    /// called from any thread.
+    /// @see    @ref BLEConnectionEvents
+    void updateConnectionParameters(uint16_t interval, uint16_t latency);
+    /// Get the connection interval as a multiple of 1.25 ms (zero if unknown).
+    uint16_t getConnectionInterval() const { return connection_interval; }
+    /// Get the peripheral latency, the number of connection events the
+    /// peripheral may skip if it has no data to send.
+    uint16_t getPeripheralLatency() const { return peripheral_latency; }
+    /// Set the maximum number of notifications that the BLE stack can send in
+    /// a single connection event (zero means no limit). If the limit is
+    /// reached, full packets are held back until the next connection event.
+    void setMaxNotificationsPerEvent(uint8_t n);
+
   private:
     /// Actually perform the BLE notification with the given data.
     void sendData(BLEDataView) = delete; // should be implemented by subclass
 
     /// Function that waits for BLE packets and sends them in the background.
     /// It either sends them after a timeout (a given number of milliseconds
-    /// after the first data was added to the packet), or immediately when it
-    /// receives a flush signal from the main thread.
+    /// after the first data was added to the packet), or immediately when the
+    /// main thread hands off a packet.
     bool handleSendEvents();
+    /// Send the given packet, empty it, and update its size based on the MTU
+    /// of the connected clients.
+    void transmit(PacketBuilder &packet);
+    /// Apply the current MTU to the given buffer if it's empty. Should only be
+    /// called by the thread that owns the buffer.
+    void updateCapacity(PacketBuilder &packet);
+    /// Release the buffer acquired by @ref acquirePacket.
+    void release(bool has_data);
+
+    /// Apply the connection parameters reported by the backend.
+    void applyConnectionParameters(uint32_t now);
+
+    using clock = std::chrono::steady_clock;
+    static uint32_t now_us();
 
   private:
-    struct {
-        /// View of the data to send
-        BLEMIDIPacketBuilder packet;
-        /// Flag to stop the background thread.
-        bool stop = false;
-        /// Flag to tell the sender thread to send the packet immediately.
-        bool flush = false;
-        /// Timeout before the sender thread sends a packet.
-        /// @see @ref setTimeout()
-        std::chrono::milliseconds timeout {10};
-        /// Lock to protect all shared data in this struct.
-        std::mutex mtx;
-    } shared {};
-    /// Condition variable used by the background sender thread to wait for
-    /// data to send, and for the main thread to wait for the data to be flushed
-    /// by the sender thread.
-    std::condition_variable cv;
-    /// Lock type used to lock the mutex
-    using lock_t = std::unique_lock<std::mutex>;
+    /// Bits of @ref state.
+    enum : uint8_t {
+        /// Index of the buffer that is being filled by the main thread.
+        Fill = 1 << 0,
+        /// The main thread is currently accessing the buffer being filled.
+        Busy = 1 << 1,
+        /// The other buffer (index `Fill ^ 1`) belongs to the sender thread
+        /// and is being transmitted.
+        InFlight = 1 << 2,
+        /// The buffer being filled contains data.
+        Data = 1 << 3,
+        /// The main thread requested the buffer being filled to be sent as
+        /// soon as possible, but the other buffer was still in flight.
+        Flush = 1 << 4,
+    };
+    /// The two packet buffers.
+    PacketBuilder packets[2];
+    /// Ownership of the two packet buffers, see the enumerators above. The
+    /// sender thread can only take the buffer being filled if it's not
+    /// @ref Busy, and the main thread can only hand it off if the other buffer
+    /// is not @ref InFlight.
+    std::atomic<uint8_t> state {0};
+    /// Flag to stop the background thread.
+    std::atomic<bool> stop {false};
+    /// Time (in microseconds) when the first data was added to the packet.
+    std::atomic<uint32_t> packet_start_time {0};
+    /// Timeout (in microseconds) before the sender thread sends a packet.
+    /// @see @ref setTimeout()
+    std::atomic<uint32_t> timeout {10000};
+    /// Connection parameters reported by the backend, and the maximum number
+    /// of notifications per event.
+    std::atomic<uint16_t> connection_interval {0};
+    std::atomic<uint16_t> peripheral_latency {0};
+    std::atomic<uint8_t> max_notifications_per_event {0};
+    /// Timing of the connection events (only used by the sender thread).
+    BLEConnectionEvents connection_events;
+    uint16_t applied_connection_interval = 0;
+    uint16_t applied_peripheral_latency = 0;
+    /// Used to wake up the sender thread when the main thread starts a new
+    /// packet, or hands off a packet.
+    BinarySemaphore wakeup {0};
     /// The background thread responsible for sending the data.
     std::thread send_thread;
 
@@ -92,9 +168,26 @@ class ThreadedBLEMIDISender {
     std::atomic_uint_fast16_t force_min_mtu {515};
 
   public:
-    struct ProtectedBuilder {
-        BLEMIDIPacketBuilder *packet;
-        lock_t lck;
+    /// RAII wrapper that releases the buffer when it goes out of scope.
+    class ProtectedBuilder {
+      public:
+        ProtectedBuilder(PacketBuilder *packet, ThreadedBLEMIDISender *sender)
+            : packet(packet), sender(sender) {}
+        ProtectedBuilder(ProtectedBuilder &&other)
+            : packet(other.packet), sender(other.sender) {
+            other.sender = nullptr;
+        }
+        ProtectedBuilder &operator=(ProtectedBuilder &&) = delete;
+        ~ProtectedBuilder() {
+            if (sender != nullptr)
+                sender->release(!packet->empty());
+        }
+
+        PacketBuilder *packet;
+
+      private:
+        friend class ThreadedBLEMIDISender;
+        ThreadedBLEMIDISender *sender;
     };
 };
 
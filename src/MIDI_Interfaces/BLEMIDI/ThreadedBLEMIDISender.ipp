@@ -4,22 +4,18 @@
 
 BEGIN_CS_NAMESPACE
 
-template <class Derived>
-ThreadedBLEMIDISender<Derived>::~ThreadedBLEMIDISender() {
-    lock_t lck(shared.mtx);
-    // Tell the sender that this is the last packet
-    shared.stop = true;
-    // Tell the sender to not to wait for the timeout
-    shared.flush = true;
-    lck.unlock();
-    cv.notify_one();
-    // Wait for it to be sent, and join the thread when done
+template <class Derived, class PacketBuilder>
+ThreadedBLEMIDISender<Derived, PacketBuilder>::~ThreadedBLEMIDISender() {
+    // Tell the sender thread to stop
+    stop.store(true);
+    wakeup.release();
+    // Join the thread when done
     if (send_thread.joinable())
         send_thread.join();
 }
 
-template <class Derived>
-void ThreadedBLEMIDISender<Derived>::begin() {
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::begin() {
     send_thread = std::thread([this] {
         // As long as you didn't get the stop signal, wait for data to send
         while (handleSendEvents())
@@ -27,98 +23,220 @@ void ThreadedBLEMIDISender<Derived>::begin() {
     });
 }
 
-template <class Derived>
-auto ThreadedBLEMIDISender<Derived>::acquirePacket() -> ProtectedBuilder {
-    return {&shared.packet, lock_t {shared.mtx}};
+template <class Derived, class PacketBuilder>
+uint32_t ThreadedBLEMIDISender<Derived, PacketBuilder>::now_us() {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    return duration_cast<microseconds>(clock::now().time_since_epoch()).count();
 }
 
-template <class Derived>
-void ThreadedBLEMIDISender<Derived>::releasePacketAndNotify(
+template <class Derived, class PacketBuilder>
+auto ThreadedBLEMIDISender<Derived, PacketBuilder>::acquirePacket()
+    -> ProtectedBuilder {
+    // Prevent the sender thread from taking the buffer while we're using it.
+    // Only fails if the sender thread just took the buffer.
+    uint8_t s = state.load(std::memory_order_relaxed);
+    while (!state.compare_exchange_weak(s, s | Busy, std::memory_order_acquire,
+                                        std::memory_order_relaxed))
+        ; // retry
+    updateCapacity(packets[s & Fill]);
+    return {&packets[s & Fill], this};
+}
+
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::updateCapacity(
+    PacketBuilder &packet) {
+    // The MTU may have changed since the buffer was emptied. Only empty
+    // buffers are resized, so the data that was already added is not affected.
+    uint16_t capacity = min_mtu - 3;
+    if (packet.getSize() == 0 && packet.getCapacity() != capacity)
+        packet.setCapacity(capacity);
+}
+
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::release(bool has_data) {
+    // The Data bit can only be cleared by the sender thread when we're not
+    // busy, so it's safe to check it here
+    uint8_t s = state.load(std::memory_order_relaxed);
+    bool start = has_data && !(s & Data);
+    if (start)
+        packet_start_time.store(now_us(), std::memory_order_relaxed);
+    uint8_t new_state;
+    do {
+        new_state = (s & ~Busy) | (has_data ? Data : 0);
+    } while (!state.compare_exchange_weak(
+        s, new_state, std::memory_order_release, std::memory_order_relaxed));
+    // Start the timeout if this is a new packet, and let the sender thread
+    // take the packet if it was waiting for us to finish
+    if (start || (new_state & Flush))
+        wakeup.release();
+}
+
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::releasePacketAndNotify(
     ProtectedBuilder &lck) {
-    lck.lck.unlock();
-    cv.notify_one();
+    lck.sender = nullptr;
+    release(!lck.packet->empty());
 }
 
-template <class Derived>
-void ThreadedBLEMIDISender<Derived>::sendNow(ProtectedBuilder &lck) {
-    assert(lck.lck.owns_lock());
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::sendNow(
+    ProtectedBuilder &lck) {
     // No need to send empty packets
-    if (shared.packet.empty())
+    if (lck.packet->empty())
         return;
 
-    // Tell the background sender thread to send the packet now
-    shared.flush = true;
-    lck.lck.unlock();
-    cv.notify_one();
+    // While we're busy, the sender thread can only clear the InFlight bit
+    uint8_t s = state.load(std::memory_order_relaxed), new_state;
+    do {
+        // If the previous packet is still being sent, let the sender thread
+        // take this packet when it's done
+        if (s & InFlight)
+            new_state = s | Flush;
+        // Otherwise, hand off this packet, and continue with the other buffer
+        else
+            new_state = ((s ^ Fill) | InFlight) & ~(Data | Flush);
+    } while (!state.compare_exchange_weak(
+        s, new_state, std::memory_order_acq_rel, std::memory_order_relaxed));
+    lck.packet = &packets[new_state & Fill];
+    updateCapacity(*lck.packet);
+    wakeup.release();
+    // If the caller is waiting for the packet to be handed off because it's
+    // full, give the sender thread a chance to run (important on single-core
+    // systems)
+    if (new_state & Flush)
+        std::this_thread::yield();
+}
 
-    // Wait for flush to complete (when the sender clears the flush flag)
-    lck.lck.lock();
-    cv.wait(lck.lck, [this] { return !shared.flush; });
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::waitUntilSent() const {
+    while (state.load(std::memory_order_acquire) & (InFlight | Flush))
+        std::this_thread::yield();
 }
 
-template <class Derived>
-void ThreadedBLEMIDISender<Derived>::updateMTU(uint16_t mtu) {
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::updateMTU(uint16_t mtu) {
     uint16_t force_min_mtu_c = force_min_mtu;
     if (force_min_mtu_c == 0)
         min_mtu = mtu;
     else
         min_mtu = std::min(force_min_mtu_c, mtu);
     DEBUGFN(NAMEDVALUE(min_mtu));
-    auto lck = acquirePacket();
-    if (lck.packet->getSize() == 0)
-        lck.packet->setCapacity(min_mtu - 3);
+    // This function is called from the BLE stack's task, so it must not touch
+    // the packet buffers: the new capacity is applied by whichever thread owns
+    // a buffer, the main thread in acquirePacket, or the sender thread in
+    // transmit.
 }
 
-template <class Derived>
-void ThreadedBLEMIDISender<Derived>::forceMinMTU(uint16_t mtu) {
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::forceMinMTU(uint16_t mtu) {
     force_min_mtu = mtu;
     updateMTU(min_mtu);
 }
 
-template <class Derived>
-void ThreadedBLEMIDISender<Derived>::setTimeout(
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::setTimeout(
     std::chrono::milliseconds timeout) {
-    lock_t lck(shared.mtx);
-    shared.timeout = timeout;
-}
-
-template <class Derived>
-bool ThreadedBLEMIDISender<Derived>::handleSendEvents() {
-    lock_t lck(shared.mtx);
-
-    // Wait for a packet to be started (or for a stop signal)
-    cv.wait(lck, [this] { return !shared.packet.empty() || shared.stop; });
-    // Wait for flush signal or timeout.
-    auto timeout = shared.timeout;
-    cv.wait_for(lck, timeout, [this] { return shared.flush; });
-
-    // Stop this thread
-    if (shared.stop)
-        return false;
-    // Note: do not send anything in this case, because we might be in the base
-    // class destructor, and the subclass implementing the sendData function
-    // might already be destroyed.
-
-    // Send the packet over BLE, empty the buffer, and update the buffer
-    // size based on the MTU of the connected clients.
-    BLEDataView data {shared.packet.getBuffer(), shared.packet.getSize()};
+    this->timeout.store(timeout.count() * 1000);
+}
+
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::updateConnectionParameters(
+    uint16_t interval, uint16_t latency) {
+    peripheral_latency.store(latency);
+    connection_interval.store(interval);
+    // Let the sender thread reconsider when to send the held back packet
+    wakeup.release();
+}
+
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::setMaxNotificationsPerEvent(
+    uint8_t n) {
+    max_notifications_per_event.store(n);
+}
+
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::applyConnectionParameters(
+    uint32_t now) {
+    // New parameters move the (estimated) connection events
+    uint16_t interval = connection_interval.load();
+    uint16_t latency = peripheral_latency.load();
+    if (interval != applied_connection_interval ||
+        latency != applied_peripheral_latency) {
+        connection_events.setParameters(interval, latency, now);
+        applied_connection_interval = interval;
+        applied_peripheral_latency = latency;
+    }
+    connection_events.setMaxNotificationsPerEvent(
+        max_notifications_per_event.load());
+    connection_events.update(now);
+}
+
+template <class Derived, class PacketBuilder>
+void ThreadedBLEMIDISender<Derived, PacketBuilder>::transmit(
+    PacketBuilder &packet) {
+    BLEDataView data {packet.getBuffer(), packet.getSize()};
     if (data.length > 0)
         CRTP(Derived).sendData(data);
-    shared.packet.reset();
-    shared.packet.setCapacity(min_mtu - 3);
+    packet.reset();
+    updateCapacity(packet);
     // Note: the MTU may have been reduced asynchronously, in which case the
     // sending of the data may fail, or it may be truncated. However, since
     // updating the MTU while a transmission is already going on is rare, we
     // don't handle this case, as it would require parsing and re-encoding the
     // buffer into two or more packets.
+}
 
-    // Notify the main thread that the flush was done.
-    if (shared.flush) {
-        shared.flush = false;
-        lck.unlock();
-        cv.notify_one();
+template <class Derived, class PacketBuilder>
+bool ThreadedBLEMIDISender<Derived, PacketBuilder>::handleSendEvents() {
+    // Wait for a packet to be started or handed off (or for a stop signal)
+    wakeup.acquire();
+    while (true) {
+        // Stop this thread
+        if (stop.load())
+            return false;
+        // Note: do not send anything in this case, because we might be in the
+        // base class destructor, and the subclass implementing the sendData
+        // function might already be destroyed.
+
+        uint32_t now = now_us();
+        applyConnectionParameters(now);
+        uint8_t s = state.load(std::memory_order_acquire);
+        // Send the packet that was handed off by the main thread, and give the
+        // buffer back
+        if (s & InFlight) {
+            // Hold it back if the current connection event is full already
+            auto t = connection_events.getNotificationTime(now);
+            if (int32_t(t - now) > 0) {
+                wakeup.try_acquire_for(std::chrono::microseconds {t - now});
+                continue;
+            }
+            connection_events.registerNotification(now);
+            transmit(packets[(s & Fill) ^ 1]);
+            state.fetch_and(uint8_t(~InFlight), std::memory_order_acq_rel);
+            continue;
+        }
+        // Nothing to send (yet)
+        if (!(s & Data))
+            return true;
+        // Wait for the timeout to expire (or for a flush request)
+        if (!(s & Flush)) {
+            auto t = packet_start_time.load() + timeout.load();
+            if (int32_t(t - now) > 0) {
+                wakeup.try_acquire_for(std::chrono::microseconds {t - now});
+                continue;
+            }
+        }
+        // The main thread is adding data to the packet, wait for it to finish
+        if (s & Busy) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Take the packet from the main thread, which continues with the other
+        // buffer
+        uint8_t new_state = ((s ^ Fill) | InFlight) & ~(Data | Flush);
+        state.compare_exchange_strong(s, new_state, std::memory_order_acq_rel);
     }
-    return true;
 }
 
 END_CS_NAMESPACE
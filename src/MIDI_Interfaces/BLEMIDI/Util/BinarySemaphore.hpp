@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Settings/NamespaceSettings.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+BEGIN_CS_NAMESPACE
+
+/// Binary semaphore with the same interface as C++20's
+/// `std::binary_semaphore`, except that @ref release() may be called when the
+/// semaphore is already available (it's idempotent, whereas this is undefined
+/// behavior for `std::binary_semaphore`). The mutex is only held for a few
+/// instructions, never while waiting, so @ref release() never has to wait for
+/// the thread that calls @ref acquire().
+class BinarySemaphore {
+  public:
+    explicit BinarySemaphore(std::ptrdiff_t desired) : count {desired > 0} {}
+    BinarySemaphore(const BinarySemaphore &) = delete;
+    BinarySemaphore &operator=(const BinarySemaphore &) = delete;
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lck {mtx};
+            count = true;
+        }
+        cv.notify_one();
+    }
+    void acquire() {
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait(lck, [this] { return count; });
+        count = false;
+    }
+    template <class Rep, class Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period> &timeout) {
+        std::unique_lock<std::mutex> lck {mtx};
+        if (!cv.wait_for(lck, timeout, [this] { return count; }))
+            return false;
+        count = false;
+        return true;
+    }
+
+  private:
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool count;
+};
+
+END_CS_NAMESPACE
@@ -3,7 +3,9 @@
 #include <AH/Error/Error.hpp>
 
 #include "BLEMIDI/BLEAPI.hpp"
+#include "BLEMIDI/BLEMIDIPlayoutClock.hpp"
 #include "MIDI_Interface.hpp"
+#include <MIDI_Parsers/MIDIStatusTable.hpp>
 
 #include <chrono>
 
@@ -81,11 +83,42 @@ class GenericBLEMIDI_Interface : public MIDI_Interface {
 
     /// @}
 
+  public:
+    /// @name   Timestamps and playout
+    /// @{
+
+    /// Release the incoming channel, system common and real-time messages
+    /// based on their BLE-MIDI timestamps instead of as soon as they're read,
+    /// which removes the jitter caused by the batching of messages per BLE
+    /// connection event. Each message is released the given latency after
+    /// the estimated time at which it was sent (plus the minimal transmission
+    /// delay). A later message is never released before an earlier one.
+    /// The latency should be at least the connection interval.
+    /// @see    @ref BLEMIDIPlayoutClock
+    void setPlayoutLatency(std::chrono::milliseconds latency);
+    /// Release all incoming messages as soon as they're read (default).
+    void disablePlayout() { playout_enabled = false; }
+    /// Get the sender time (in milliseconds) of the latest MIDI message,
+    /// reconstructed from its BLE-MIDI timestamp.
+    /// @note Only valid if playout is enabled, and not for SysEx messages.
+    uint32_t getSenderTime() const { return playout.getSenderTime(); }
+    /// Get the reconstructed clock of the sender.
+    const BLEMIDIPlayoutClock &getPlayoutClock() const { return playout; }
+
+    /// @}
+
   private:
     /// Incoming message that can be from retrieved using the
     /// `getChannelMessage()`, `getSysCommonMessage()`, `getRealTimeMessage()`
     /// and `getSysExMessage()` methods.
     typename Backend::IncomingMIDIMessage incomingMessage;
+    /// Reconstructs the sender's clock and schedules the incoming messages.
+    BLEMIDIPlayoutClock playout;
+    bool playout_enabled = false;
+    /// Whether @ref incomingMessage was read but not yet released.
+    bool playout_held = false;
+    /// The time (in microseconds) at which @ref incomingMessage is released.
+    uint32_t playout_time = 0;
 
   public:
     /// @name   BLE configuration options
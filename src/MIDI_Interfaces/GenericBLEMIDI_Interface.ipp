@@ -15,11 +15,13 @@ void GenericBLEMIDI_Interface<BackendT>::sendImpl(L &lck, F add_to_buffer) {
 
     // Try adding the message to the current packet
     if (!add_to_buffer()) {
-        // If that doesn't work, flush the packet (send it now and wait until
-        // it is sent)
-        backend.sendNow(lck);
-        // And then add it to the (now emtpy) buffer
-        add_to_buffer();
+        // If that doesn't work, flush the packet (hand it off to be sent now)
+        // and add it to the (now emtpy) buffer. If the previous packet is
+        // still being sent, the buffer isn't handed off yet, so retry until
+        // it is.
+        do
+            backend.sendNow(lck);
+        while (!add_to_buffer());
     }
     // Notify the sending thread that data has been added to the buffer
     backend.releasePacketAndNotify(lck);
@@ -30,7 +32,7 @@ void GenericBLEMIDI_Interface<BackendT>::sendChannelMessageImpl(
     ChannelMessage msg) {
     uint16_t timestamp = millis(); // BLE MIDI timestamp
     auto lck = backend.acquirePacket();
-    if (msg.hasTwoDataBytes()) {
+    if (getMIDIStatusInfo(msg.header).getLength() == 2) {
         sendImpl(lck, [&] {
             return lck.packet->add3B(msg.header, msg.data1, msg.data2,
                                      timestamp);
@@ -56,8 +58,9 @@ void GenericBLEMIDI_Interface<BackendT>::sendSysCommonImpl(
     uint16_t timestamp = millis(); // BLE MIDI timestamp
     auto lck = backend.acquirePacket();
     sendImpl(lck, [&] {
-        return lck.packet->addSysCommon(msg.getNumberOfDataBytes(), msg.header,
-                                        msg.data1, msg.data2, timestamp);
+        uint8_t numData = getMIDIStatusInfo(msg.header).getLength();
+        return lck.packet->addSysCommon(numData, msg.header, msg.data1,
+                                        msg.data2, timestamp);
     });
 }
 
@@ -78,16 +81,19 @@ void GenericBLEMIDI_Interface<BackendT>::sendSysExImpl(SysExMessage msg) {
 
     // Try adding at least the SysExStart header to the current packet
     if (!lck.packet->addSysEx(data, length, timestamp)) {
-        // If that didn't fit, flush the packet
-        backend.sendNow(lck);
-        // Add the first part of the SysEx message to this packet
-        lck.packet->addSysEx(data, length, timestamp);
+        // If that didn't fit, flush the packet and add the first part of the
+        // SysEx message to the next packet (retry if the packet couldn't be
+        // handed off yet)
+        do
+            backend.sendNow(lck);
+        while (!lck.packet->addSysEx(data, length, timestamp));
     }
     // As long as there's data to be sent in the next packet
     while (data) {
         // Send the previous (full) packet
         backend.sendNow(lck);
         // And add the next part of the SysEx message to a continuation packet
+        // (adds nothing if the previous packet is still full)
         lck.packet->continueSysEx(data, length, timestamp);
     }
     // Notify the sending thread that data has been added to the buffer
@@ -104,9 +110,23 @@ void GenericBLEMIDI_Interface<BackendT>::sendNowImpl() {
 
 template <class BackendT>
 MIDIReadEvent GenericBLEMIDI_Interface<BackendT>::read() {
-    // Pop a new message from the queue
-    if (!backend.popMessage(incomingMessage))
+    if (!playout_held) {
+        // Pop a new message from the queue
+        if (!backend.popMessage(incomingMessage))
+            return MIDIReadEvent::NO_MESSAGE;
+        auto evt = incomingMessage.eventType;
+        // SysEx messages are not scheduled, the timestamps of the chunks are
+        // invalid
+        if (!playout_enabled || evt == MIDIReadEvent::SYSEX_MESSAGE ||
+            evt == MIDIReadEvent::SYSEX_CHUNK)
+            return evt;
+        playout_time = playout.schedule(incomingMessage.timestamp, micros());
+        playout_held = true;
+    }
+    // Hold the message (and all messages after it) until its scheduled time
+    if (playout_enabled && int32_t(micros() - playout_time) < 0)
         return MIDIReadEvent::NO_MESSAGE;
+    playout_held = false;
     return incomingMessage.eventType;
 }
 
@@ -153,6 +173,13 @@ void GenericBLEMIDI_Interface<BackendT>::setName(const char *name) {
     ble_settings.device_name = name;
 }
 
+template <class BackendT>
+void GenericBLEMIDI_Interface<BackendT>::setPlayoutLatency(
+    std::chrono::milliseconds latency) {
+    playout.setLatency(latency.count() * 1000);
+    playout_enabled = true;
+}
+
 template <class BackendT>
 void GenericBLEMIDI_Interface<BackendT>::begin() {
     backend.begin(ble_settings);
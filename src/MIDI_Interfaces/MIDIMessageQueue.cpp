@@ -0,0 +1,89 @@
+#include "MIDIMessageQueue.hpp"
+
+#if DISABLE_PIPES
+#include "MIDI_Interface.hpp"
+#endif
+#include <string.h>
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+template <class Message>
+void sendQueued(BasicMIDIMessageQueue &queue, Message msg) {
+#if DISABLE_PIPES
+    static_cast<void>(queue);
+    if (auto iface = MIDI_Interface::getDefault())
+        iface->send(msg);
+#else
+    queue.sourceMIDItoPipe(msg);
+#endif
+}
+} // namespace
+
+bool BasicMIDIMessageQueue::pushEntry(Entry e) {
+    uint16_t w = writeIndex.load(relaxed);
+    uint16_t n = next(w);
+    uint16_t r = readIndex.load(acquire);
+    if (n == r) {
+        increment(numOverflows);
+        return false;
+    }
+    entries[w] = e;
+    writeIndex.store(n, release);
+    uint16_t used = n >= r ? n - r : n + size - r;
+    if (used > peakUsage.load(relaxed))
+        peakUsage.store(used, relaxed);
+    return true;
+}
+
+bool BasicMIDIMessageQueue::push(SysExMessage msg) {
+    uint8_t used = sysexPushed - sysexPopped.load(acquire);
+    if (used >= numSysExSlots || msg.length > sysexSlotSize) {
+        increment(numSysExOverflows);
+        return false;
+    }
+    uint8_t slot = sysexNextSlot;
+    memcpy(sysexData + slot * sysexSlotSize, msg.data, msg.length);
+    if (!pushEntry({MIDIReadEvent::SYSEX_MESSAGE, 0, 0, 0, msg.cable.getRaw(),
+                    slot, msg.length}))
+        return false;
+    ++sysexPushed;
+    sysexNextSlot = slot + 1 == numSysExSlots ? 0 : slot + 1;
+    return true;
+}
+
+uint16_t BasicMIDIMessageQueue::flush() {
+    uint16_t r = readIndex.load(relaxed);
+    uint16_t w = writeIndex.load(acquire);
+    uint16_t count = 0;
+    for (; r != w; r = next(r), ++count) {
+        const Entry &e = entries[r];
+        Cable cable = Cable(e.cable);
+        switch (e.type) {
+            case MIDIReadEvent::CHANNEL_MESSAGE:
+                sendQueued(*this, ChannelMessage(e.header, e.data1, e.data2,
+                                                 cable));
+                break;
+            case MIDIReadEvent::SYSCOMMON_MESSAGE:
+                sendQueued(*this, SysCommonMessage(e.header, e.data1, e.data2,
+                                                   cable));
+                break;
+            case MIDIReadEvent::REALTIME_MESSAGE:
+                sendQueued(*this, RealTimeMessage(e.header, cable));
+                break;
+            case MIDIReadEvent::SYSEX_MESSAGE:
+                sendQueued(*this,
+                           SysExMessage(sysexData + e.slot * sysexSlotSize,
+                                        e.length, cable));
+                sysexPopped.store(sysexPopped.load(relaxed) + 1, release);
+                break;
+            case MIDIReadEvent::NO_MESSAGE: // fallthrough
+            case MIDIReadEvent::SYSEX_CHUNK: // fallthrough
+            default: break; // LCOV_EXCL_LINE
+        }
+        readIndex.store(next(r), release);
+    }
+    return count;
+}
+
+END_CS_NAMESPACE
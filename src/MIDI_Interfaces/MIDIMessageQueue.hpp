@@ -0,0 +1,227 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+
+#if !defined(ARDUINO) || defined(ESP32) || defined(ARDUINO_ARCH_RP2040) ||    \
+    defined(ARDUINO_ARCH_MBED) || defined(TEENSYDUINO)
+#define CS_HAS_MIDI_MESSAGE_QUEUE 1
+#else
+#define CS_HAS_MIDI_MESSAGE_QUEUE 0
+#endif
+
+#include "MIDI_Pipes.hpp"
+#include <AH/Containers/Updatable.hpp>
+#if CS_HAS_MIDI_MESSAGE_QUEUE
+#include <MIDI_Interfaces/USBMIDI/util/Atomic.hpp>
+#endif
+#include <MIDI_Parsers/MIDIReadEvent.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Queue for sending MIDI messages from interrupt handlers or other
+ *          threads.
+ *
+ * The MIDI pipes are not re-entrant, so messages that are produced in an
+ * interrupt handler, a BLE callback or a different task cannot be sent to the
+ * pipes directly. Instead, they can be pushed into this queue, which is then
+ * emptied into the pipes by @ref Control_Surface_::loop, or by calling
+ * @ref flush manually.
+ *
+ * The queue is a wait-free ring buffer with a single producer and a single
+ * consumer: all messages have to be pushed from the same interrupt handler or
+ * thread, and @ref flush has to be called from the main program. Use one queue
+ * per producer.
+ *
+ * System Exclusive messages are copied into a slot of a fixed size, which is
+ * reused once the message has been sent.
+ *
+ * On platforms without atomic operations (e.g. AVR), @ref MIDIMessageQueue is
+ * not available (see `CS_HAS_MIDI_MESSAGE_QUEUE`), and BasicMIDIMessageQueue
+ * can only be used from the main program, e.g. by @ref MIDIStallBuffer.
+ *
+ * The queue is a MIDI source, so it has to be connected to one or more sinks
+ * using pipes:
+ * ~~~cpp
+ * MIDIMessageQueue<32> queue;
+ * queue >> pipes >> midi;
+ * ~~~
+ *
+ * @see     @ref MIDIMessageQueue
+ */
+class BasicMIDIMessageQueue : public TrueMIDI_Source,
+                              public AH::Updatable<BasicMIDIMessageQueue> {
+  public:
+    /// Compact storage of a queued message.
+    struct Entry {
+        MIDIReadEvent type;
+        uint8_t header;
+        uint8_t data1;
+        uint8_t data2;
+        uint8_t cable;
+        /// Index of the SysEx slot that holds the data of a SysEx message.
+        uint8_t slot;
+        /// Length of a SysEx message.
+        uint16_t length;
+    };
+
+  protected:
+    BasicMIDIMessageQueue(Entry *entries, uint16_t size, uint8_t *sysexData,
+                          uint8_t numSysExSlots, uint16_t sysexSlotSize)
+        : entries(entries), size(size), sysexData(sysexData),
+          numSysExSlots(numSysExSlots), sysexSlotSize(sysexSlotSize) {}
+
+  public:
+    /// @name   Producer
+    /// @{
+
+    /// Add a Channel message to the queue.
+    /// @return False if the queue is full, true otherwise.
+    bool push(ChannelMessage msg) {
+        return pushEntry({MIDIReadEvent::CHANNEL_MESSAGE, msg.header, msg.data1,
+                          msg.data2, msg.cable.getRaw(), 0, 0});
+    }
+    /// Add a System Common message to the queue.
+    /// @return False if the queue is full, true otherwise.
+    bool push(SysCommonMessage msg) {
+        return pushEntry({MIDIReadEvent::SYSCOMMON_MESSAGE, msg.header,
+                          msg.data1, msg.data2, msg.cable.getRaw(), 0, 0});
+    }
+    /// Add a Real-Time message to the queue.
+    /// @return False if the queue is full, true otherwise.
+    bool push(RealTimeMessage msg) {
+        return pushEntry({MIDIReadEvent::REALTIME_MESSAGE, msg.message, 0, 0,
+                          msg.cable.getRaw(), 0, 0});
+    }
+    /// Copy a System Exclusive message into a free SysEx slot and add it to
+    /// the queue.
+    /// @return False if the queue is full, if all SysEx slots are in use, or
+    ///         if the message is larger than a slot, true otherwise.
+    bool push(SysExMessage msg);
+
+    /// @}
+
+    /// @name   Consumer
+    /// @{
+
+    /// Send all messages that are currently in the queue to the pipes.
+    /// Messages that are pushed while flushing are sent on the next call.
+    /// @return The number of messages that were sent.
+    uint16_t flush();
+    /// Check whether there are any messages in the queue.
+    bool empty() const {
+        return readIndex.load(relaxed) == writeIndex.load(acquire);
+    }
+
+    /// Does nothing.
+    void begin() override {}
+    /// Calls @ref flush.
+    void update() override { flush(); }
+
+    /// @}
+
+    /// @name   Statistics
+    /// @{
+
+    /// Get the maximum number of messages the queue can hold.
+    uint16_t getCapacity() const { return size - 1; }
+    /// Get the largest number of messages that were in the queue at the same
+    /// time. Useful to choose the capacity of the queue.
+    uint16_t getPeakUsage() const {
+        return peakUsage.load(relaxed);
+    }
+    /// Get the number of messages that were dropped because the queue was
+    /// full.
+    uint32_t getNumberOfOverflows() const {
+        return numOverflows.load(relaxed);
+    }
+    /// Get the number of SysEx messages that were dropped because all slots
+    /// were in use, or because they didn't fit in a slot.
+    uint32_t getNumberOfSysExOverflows() const {
+        return numSysExOverflows.load(relaxed);
+    }
+
+    /// @}
+
+  protected:
+#if CS_HAS_MIDI_MESSAGE_QUEUE
+    template <class T>
+    using atomic_type = interrupt_atomic<T>;
+    constexpr static std::memory_order relaxed = std::memory_order_relaxed;
+    constexpr static std::memory_order acquire = std::memory_order_acquire;
+    constexpr static std::memory_order release = std::memory_order_release;
+#else
+    /// Without atomic operations, the producer and the consumer both have to
+    /// run in the main program, so plain variables are enough.
+    template <class T>
+    struct atomic_type {
+        T value;
+        T load(uint8_t) const { return value; }
+        void store(T t, uint8_t) { value = t; }
+    };
+    constexpr static uint8_t relaxed = 0, acquire = 0, release = 0;
+#endif
+
+  private:
+    bool pushEntry(Entry e);
+    uint16_t next(uint16_t i) const { return i + 1 == size ? 0 : i + 1; }
+    /// Only called by the producer, so it doesn't need a read-modify-write.
+    static void increment(atomic_type<uint32_t> &counter) {
+        counter.store(counter.load(relaxed) + 1, relaxed);
+    }
+
+  private:
+    Entry *entries;
+    /// Number of entries, one more than the capacity, so a full queue can be
+    /// told apart from an empty one.
+    uint16_t size;
+    uint8_t *sysexData;
+    uint8_t numSysExSlots;
+    uint16_t sysexSlotSize;
+
+    /// Producer state.
+    atomic_type<uint16_t> writeIndex {0};
+    uint8_t sysexNextSlot = 0;
+    uint8_t sysexPushed = 0;
+    atomic_type<uint16_t> peakUsage {0};
+    atomic_type<uint32_t> numOverflows {0};
+    atomic_type<uint32_t> numSysExOverflows {0};
+    /// Consumer state.
+    atomic_type<uint16_t> readIndex {0};
+    atomic_type<uint8_t> sysexPopped {0};
+};
+
+#if CS_HAS_MIDI_MESSAGE_QUEUE
+
+/**
+ * @brief   Queue for sending MIDI messages from interrupt handlers or other
+ *          threads.
+ *
+ * @tparam  Capacity
+ *          The maximum number of messages in the queue.
+ * @tparam  SysExSlots
+ *          The maximum number of System Exclusive messages in the queue.
+ * @tparam  SysExSlotSize
+ *          The maximum size of a single System Exclusive message.
+ *
+ * @copydetails BasicMIDIMessageQueue
+ */
+template <uint16_t Capacity, uint8_t SysExSlots = 0,
+          uint16_t SysExSlotSize = 0>
+class MIDIMessageQueue : public BasicMIDIMessageQueue {
+  public:
+    MIDIMessageQueue()
+        : BasicMIDIMessageQueue(storage, Capacity + 1, sysexStorage,
+                                SysExSlots, SysExSlotSize) {}
+
+  private:
+    Entry storage[Capacity + 1];
+    uint8_t sysexStorage[SysExSlots * SysExSlotSize > 0
+                             ? SysExSlots * SysExSlotSize
+                             : 1];
+};
+
+#endif
+
+END_CS_NAMESPACE
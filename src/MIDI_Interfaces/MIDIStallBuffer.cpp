@@ -0,0 +1,64 @@
+#include "MIDIStallBuffer.hpp"
+#if !DISABLE_PIPES
+
+#include <AH/Arduino-Wrapper.h> // millis
+
+BEGIN_CS_NAMESPACE
+
+template <class Message>
+void BasicMIDIStallBuffer::park(Message msg) {
+    if (empty()) {
+        if (!isStalledByOthers())
+            return sourceMIDItoPipe(msg);
+        parkStart = millis();
+    }
+    if (push(msg))
+        return;
+    // No space left, wait for the stall to be resolved
+    handleStallers();
+    replay();
+    sourceMIDItoPipe(msg);
+}
+
+void BasicMIDIStallBuffer::sinkMIDIfromPipe(ChannelMessage msg) { park(msg); }
+void BasicMIDIStallBuffer::sinkMIDIfromPipe(SysExMessage msg) { park(msg); }
+void BasicMIDIStallBuffer::sinkMIDIfromPipe(SysCommonMessage msg) {
+    park(msg);
+}
+void BasicMIDIStallBuffer::sinkMIDIfromPipe(RealTimeMessage msg) {
+    // Real-Time messages are never delayed
+    sourceMIDItoPipe(msg);
+}
+
+void BasicMIDIStallBuffer::replay() {
+    unsigned long duration = millis() - parkStart;
+    flush();
+    if (duration > longestStall)
+        longestStall = duration;
+}
+
+void BasicMIDIStallBuffer::update() {
+    if (!empty() && !isStalledByOthers())
+        replay();
+}
+
+void BasicMIDIStallBuffer::stallDownstream(MIDIStaller *cause, MIDI_Source *) {
+    // Our source wants exclusive access, so the parked messages have to be
+    // sent first
+    if (isStalledByOthers())
+        handleStallers();
+    if (!empty())
+        replay();
+    upstreamStaller = cause;
+    stall(cause);
+}
+
+void BasicMIDIStallBuffer::unstallDownstream(MIDIStaller *cause,
+                                             MIDI_Source *) {
+    unstall(cause);
+    upstreamStaller = nullptr;
+}
+
+END_CS_NAMESPACE
+
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "MIDIMessageQueue.hpp"
+#if !DISABLE_PIPES
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Parks the messages of a source while its sinks are stalled, instead
+ *          of waiting for the stall to be resolved.
+ *
+ * When a source sends a message to a sink that is stalled by a chunked System
+ * Exclusive message from another interface, @ref MIDI_Interface::handleStall
+ * keeps reading from that other interface until the SysEx message is complete.
+ * During that time, the rest of the program has to wait.
+ *
+ * The stall buffer is inserted between a source and its pipes. Messages that
+ * arrive while the sinks are stalled are stored in the buffer, and they are
+ * sent by @ref Control_Surface_::loop once the stall is resolved, in their
+ * original order. Real-Time messages are never delayed. When the buffer is
+ * full, or when a SysEx message doesn't fit, it falls back to waiting for the
+ * stall to be resolved.
+ *
+ * The messages are stored in a @ref BasicMIDIMessageQueue. The buffer is only
+ * accessed from the main loop, so it is available on all platforms, including
+ * the ones without @ref MIDIMessageQueue.
+ *
+ * ~~~cpp
+ * MIDIStallBuffer<32, 2, 64> buffer;
+ * Control_Surface >> pipes >> buffer;
+ * buffer >> pipes >> midiA;
+ * buffer >> pipes >> midiB;
+ * ~~~
+ *
+ * @see     @ref MIDIStallBuffer
+ */
+class BasicMIDIStallBuffer : public BasicMIDIMessageQueue,
+                             public TrueMIDI_Sink {
+  protected:
+    BasicMIDIStallBuffer(Entry *entries, uint16_t size, uint8_t *sysexData,
+                         uint8_t numSysExSlots, uint16_t sysexSlotSize)
+        : BasicMIDIMessageQueue(entries, size, sysexData, numSysExSlots,
+                                sysexSlotSize) {}
+
+  public:
+    void sinkMIDIfromPipe(ChannelMessage msg) override;
+    void sinkMIDIfromPipe(SysExMessage msg) override;
+    void sinkMIDIfromPipe(SysCommonMessage msg) override;
+    void sinkMIDIfromPipe(RealTimeMessage msg) override;
+
+    /// Send the parked messages if the stall was resolved.
+    void update() override;
+
+    /// Get the longest time (in milliseconds) that messages were parked.
+    /// The peak number of parked messages is given by @ref getPeakUsage.
+    unsigned long getLongestStall() const { return longestStall; }
+
+  private:
+    /// Messages are only added by the sink and sent by @ref update.
+    using BasicMIDIMessageQueue::flush;
+    using BasicMIDIMessageQueue::push;
+
+    /// Send the message now, or park it if the sinks are stalled.
+    template <class Message>
+    void park(Message msg);
+    /// Send all parked messages.
+    void replay();
+    /// Check whether the sinks are stalled by someone other than the source
+    /// of this buffer.
+    bool isStalledByOthers() const {
+        return isStalled() && getStaller() != upstreamStaller;
+    }
+
+    /// The source of this buffer stalls its sinks: pass it on to our sinks.
+    void stallDownstream(MIDIStaller *cause, MIDI_Source *) override;
+    /// @copydoc stallDownstream
+    void unstallDownstream(MIDIStaller *cause, MIDI_Source *) override;
+
+  private:
+    MIDIStaller *upstreamStaller = nullptr;
+    unsigned long parkStart = 0;
+    unsigned long longestStall = 0;
+};
+
+/**
+ * @brief   Parks the messages of a source while its sinks are stalled, instead
+ *          of waiting for the stall to be resolved.
+ *
+ * @tparam  Capacity
+ *          The maximum number of parked messages.
+ * @tparam  SysExSlots
+ *          The maximum number of parked System Exclusive messages.
+ * @tparam  SysExSlotSize
+ *          The maximum size of a single parked System Exclusive message.
+ *
+ * @copydetails BasicMIDIStallBuffer
+ */
+template <uint16_t Capacity, uint8_t SysExSlots = 0,
+          uint16_t SysExSlotSize = 0>
+class MIDIStallBuffer : public BasicMIDIStallBuffer {
+  public:
+    MIDIStallBuffer()
+        : BasicMIDIStallBuffer(storage, Capacity + 1, sysexStorage, SysExSlots,
+                               SysExSlotSize) {}
+
+  private:
+    Entry storage[Capacity + 1];
+    uint8_t sysexStorage[SysExSlots * SysExSlotSize > 0
+                             ? SysExSlots * SysExSlotSize
+                             : 1];
+};
+
+END_CS_NAMESPACE
+
+#endif
@@ -30,6 +30,15 @@ MIDI_Interface *MIDI_Interface::DefaultMIDI_Interface = nullptr;
 
 // -------------------------------------------------------------------------- //
 
+// Batched output
+
+void MIDI_Interface::endLoopAll() {
+    for (auto &el : updatables)
+        DOWN_CAST<MIDI_Interface &>(el).endLoop();
+}
+
+// -------------------------------------------------------------------------- //
+
 // Handling incoming MIDI events
 
 void MIDI_Interface::onChannelMessage(ChannelMessage message) {
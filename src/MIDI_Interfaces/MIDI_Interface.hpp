@@ -49,6 +49,18 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
 
     /// @}
 
+    /// @name   Batched output
+    /// @{
+
+    /// Called by @ref Control_Surface_::loop after all output elements have
+    /// been updated. Interfaces that collect outgoing messages in a batch can
+    /// send them here. Does nothing by default.
+    virtual void endLoop() {}
+    /// Call @ref endLoop() for all MIDI interfaces.
+    static void endLoopAll();
+
+    /// @}
+
     /// @name   MIDI Input Callbacks
     /// @{
 
@@ -119,6 +131,7 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
     /// Un-stall the given MIDI interface. Assumes the interface has been
     /// stalled because of a chunked SysEx messages. Waits until that message
     /// is finished.
+    /// @see    @ref MIDIStallBuffer for a way to avoid waiting.
     template <class MIDIInterface_t>
     static void handleStall(MIDIInterface_t *self);
     using MIDIStaller::handleStall;
@@ -64,6 +64,8 @@ MIDIStaller *const eternal_stall =
 class MIDI_Pipe;
 class MIDI_Source;
 class MIDI_Sink;
+template <uint8_t NumSources, uint8_t NumSinks>
+class MIDI_RoutingMatrix;
 /// A MIDI_Sink that is not a MIDI_Pipe.
 using TrueMIDI_Sink = MIDI_Sink;
 /// A MIDI_Source that is not a MIDI_Pipe.
@@ -585,6 +587,8 @@ class MIDI_Pipe : private MIDI_Sink, private MIDI_Source {
 
     friend class MIDI_Sink;
     friend class MIDI_Source;
+    template <uint8_t NumSources, uint8_t NumSinks>
+    friend class MIDI_RoutingMatrix;
 };
 
 // :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::: //
@@ -627,7 +631,10 @@ inline TrueMIDI_Source &operator<<(MIDI_Pipe &pipe, TrueMIDI_Source &source) {
 MIDI_Pipe &operator<<(MIDI_Pipe &, MIDI_Pipe &) = delete;
 
 /// Connect a pipe to a sink+source (`pipe | source+sink`).
-inline TrueMIDI_SinkSource &operator|(BidirectionalMIDI_Pipe &pipe,
+/// @note   Any pair of pipes can be used as a bidirectional pipe, e.g. a pair
+///         of @ref StaticMIDI_Pipe%s.
+template <class First, class Second>
+inline TrueMIDI_SinkSource &operator|(std::pair<First, Second> &pipe,
                                       TrueMIDI_SinkSource &sinksource) {
     sinksource.connectSinkPipe(&pipe.first);
     sinksource.connectSourcePipe(&pipe.second);
@@ -635,8 +642,9 @@ inline TrueMIDI_SinkSource &operator|(BidirectionalMIDI_Pipe &pipe,
 }
 
 /// Connect a sink+source to a pipe (`source+sink | pipe`).
-inline BidirectionalMIDI_Pipe &operator|(TrueMIDI_SinkSource &sinksource,
-                                         BidirectionalMIDI_Pipe &pipe) {
+template <class First, class Second>
+inline std::pair<First, Second> &
+operator|(TrueMIDI_SinkSource &sinksource, std::pair<First, Second> &pipe) {
     sinksource.connectSinkPipe(&pipe.second);
     sinksource.connectSourcePipe(&pipe.first);
     return pipe;
@@ -703,17 +711,17 @@ inline TrueMIDI_Source &operator<<(MIDI_PipeFactory<N, Pipe> &pipe_fact,
     return pipe_fact.getNext() << source;
 }
 
-template <size_t N>
+template <size_t N, class First, class Second>
 inline TrueMIDI_SinkSource &
-operator|(BidirectionalMIDI_PipeFactory<N> &pipe_fact,
+operator|(MIDI_PipeFactory<N, std::pair<First, Second>> &pipe_fact,
           TrueMIDI_SinkSource &sinksource) {
     return pipe_fact.getNext() | sinksource;
 }
 
-template <size_t N>
-inline BidirectionalMIDI_Pipe &
+template <size_t N, class First, class Second>
+inline std::pair<First, Second> &
 operator|(TrueMIDI_SinkSource &sinksource,
-          BidirectionalMIDI_PipeFactory<N> &pipe_fact) {
+          MIDI_PipeFactory<N, std::pair<First, Second>> &pipe_fact) {
     return sinksource | pipe_fact.getNext();
 }
 
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "MIDI_Pipes.hpp"
+#if !DISABLE_PIPES
+
+#include <AH/Containers/BitArray.hpp>
+#include <AH/Error/Error.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Routes MIDI messages from multiple sources to multiple sinks, using
+ *          a table of routes instead of a separate pipe per connection.
+ *
+ * With normal @ref MIDI_Pipe%s, a source that is connected to N sinks has a
+ * chain of N pipes, linked through their “through” outputs, and every message
+ * travels down the entire chain. The routing matrix connects to every source
+ * and every sink only once. The routes are stored as one bit per pair of
+ * source and sink, so sending a message to all sinks of a source is a single
+ * loop over the bits of that source, and routes can be added and removed at
+ * any time by flipping a bit.
+ *
+ * ~~~cpp
+ * MIDI_RoutingMatrix<2, 3> matrix;
+ * uint8_t usb = matrix.addSource(midiUSB);
+ * uint8_t din = matrix.addSource(midiDIN);
+ * uint8_t usbOut = matrix.addSink(midiUSB);
+ * uint8_t dinOut = matrix.addSink(midiDIN);
+ * uint8_t bleOut = matrix.addSink(midiBLE);
+ * matrix.route(usb, dinOut);
+ * matrix.route(din, usbOut);
+ * matrix.route(din, bleOut);
+ * ~~~
+ *
+ * Sources and sinks can be connected to other pipes and routing matrices as
+ * well. Stalling works in the same way as with normal pipes: when a source
+ * stalls, all sinks it is routed to are stalled, and all other sources that
+ * are routed to those sinks have to wait until the stall is handled.
+ *
+ * @note    Routes should not be changed while one of the sources or sinks
+ *          involved is stalled.
+ *
+ * @tparam  NumSources
+ *          The maximum number of sources.
+ * @tparam  NumSinks
+ *          The maximum number of sinks.
+ *
+ * @ingroup MIDI_Routing
+ */
+template <uint8_t NumSources, uint8_t NumSinks>
+class MIDI_RoutingMatrix {
+  public:
+    MIDI_RoutingMatrix() {
+        for (uint8_t i = 0; i < NumSources; ++i) {
+            inputs[i].matrix = this;
+            inputs[i].index = i;
+            inputPipes[i] >> inputs[i];
+        }
+        for (uint8_t k = 0; k < NumSinks; ++k) {
+            outputs[k].matrix = this;
+            outputs[k].index = k;
+            outputs[k] >> outputPipes[k];
+        }
+    }
+
+    MIDI_RoutingMatrix(const MIDI_RoutingMatrix &) = delete;
+    MIDI_RoutingMatrix &operator=(const MIDI_RoutingMatrix &) = delete;
+
+    /// @name   Connecting sources and sinks
+    /// @{
+
+    /// Connect the given source to the matrix.
+    /// @return The index of the source, used to add routes.
+    uint8_t addSource(TrueMIDI_Source &source) {
+        if (numSources >= NumSources)
+            FATAL_ERROR(F("Not enough routing matrix inputs"), 0x245A);
+        source >> inputPipes[numSources];
+        return numSources++;
+    }
+    /// Connect the given sink to the matrix.
+    /// @return The index of the sink, used to add routes.
+    uint8_t addSink(TrueMIDI_Sink &sink) {
+        if (numSinks >= NumSinks)
+            FATAL_ERROR(F("Not enough routing matrix outputs"), 0x245B);
+        outputPipes[numSinks] >> sink;
+        return numSinks++;
+    }
+
+    /// @}
+
+    /// @name   Managing routes
+    /// @{
+
+    /// Send all messages from the given source to the given sink, or stop
+    /// doing so if `enable` is false.
+    void route(uint8_t source, uint8_t sink, bool enable = true) {
+        if (!checkRoute(source, sink))
+            return; // LCOV_EXCL_LINE
+        routes[source].set(sink, enable);
+    }
+    /// Stop sending messages from the given source to the given sink.
+    void unroute(uint8_t source, uint8_t sink) { route(source, sink, false); }
+    /// Check whether messages from the given source are sent to the given
+    /// sink.
+    bool isRouted(uint8_t source, uint8_t sink) const {
+        if (!checkRoute(source, sink))
+            return false; // LCOV_EXCL_LINE
+        return routes[source].get(sink);
+    }
+    /// Remove all routes.
+    void clearRoutes() {
+        for (auto &row : routes)
+            row = {};
+    }
+
+    /// @}
+
+  private:
+    /// Check that the given source and sink have been added to the matrix.
+    bool checkRoute(uint8_t source, uint8_t sink) const {
+        if (source >= numSources) {
+            ERROR(F("Invalid routing matrix source: ")
+                      << source << F(" ≥ ") << numSources,
+                  0x245C);
+            return false; // LCOV_EXCL_LINE
+        }
+        if (sink >= numSinks) {
+            ERROR(F("Invalid routing matrix sink: ")
+                      << sink << F(" ≥ ") << numSinks,
+                  0x245D);
+            return false; // LCOV_EXCL_LINE
+        }
+        return true;
+    }
+
+    /// Call the given function for all sinks that the given source is routed
+    /// to.
+    template <class Function>
+    void forEachSink(uint8_t source, Function f) const {
+        const auto &row = routes[source];
+        for (uint16_t b = 0; b < row.getBufferLength(); ++b)
+            for (uint8_t bits = row.getByte(b), k = b * 8; bits; bits >>= 1, ++k)
+                if (bits & 1)
+                    f(k);
+    }
+    /// Call the given function for all sources that are routed to the given
+    /// sink.
+    template <class Function>
+    void forEachSource(uint8_t sink, Function f) const {
+        for (uint8_t i = 0; i < NumSources; ++i)
+            if (routes[i].get(sink))
+                f(i);
+    }
+
+    /// Send a message from the given source to all of its sinks.
+    template <class Message>
+    void forward(uint8_t source, Message msg) {
+        forEachSink(source, [&](uint8_t k) {
+            outputPipes[k].sourceMIDItoSink(msg);
+        });
+    }
+
+    /// The given source stalled (or un-stalled) its sinks: stall (or un-stall)
+    /// the sinks and all other sources that are routed to those sinks.
+    void stallFromSource(uint8_t source, MIDIStaller *cause, bool stall) {
+        forEachSink(source, [&](uint8_t k) {
+            if (stall)
+                outputPipes[k].stallDownstream(cause, &outputs[k]);
+            else
+                outputPipes[k].unstallDownstream(cause, &outputs[k]);
+            forEachSource(k, [&](uint8_t i) {
+                if (i != source)
+                    stallSource(i, cause, stall);
+            });
+        });
+    }
+    /// The given sink was stalled (or un-stalled) by a source outside of the
+    /// matrix: stall (or un-stall) all sources that are routed to this sink.
+    void stallFromSink(uint8_t sink, MIDIStaller *cause, bool stall) {
+        forEachSource(sink, [&](uint8_t i) { stallSource(i, cause, stall); });
+    }
+    /// Stall (or un-stall) the given source, so it has to wait for the cause
+    /// to be handled before it can send again.
+    void stallSource(uint8_t source, MIDIStaller *cause, bool stall) {
+        if (stall)
+            inputPipes[source].stallUpstream(cause, &inputs[source]);
+        else
+            inputPipes[source].unstallUpstream(cause, &inputs[source]);
+    }
+
+  private:
+    /// Receives the messages of one source from its pipe.
+    class Input : public TrueMIDI_Sink {
+        void sinkMIDIfromPipe(ChannelMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void sinkMIDIfromPipe(SysExMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void sinkMIDIfromPipe(SysCommonMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void sinkMIDIfromPipe(RealTimeMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void stallDownstream(MIDIStaller *cause, MIDI_Source *) override {
+            matrix->stallFromSource(index, cause, true);
+        }
+        void unstallDownstream(MIDIStaller *cause, MIDI_Source *) override {
+            matrix->stallFromSource(index, cause, false);
+        }
+
+        MIDI_RoutingMatrix *matrix;
+        uint8_t index;
+        friend class MIDI_RoutingMatrix;
+    };
+
+    /// Sends the messages to the pipe of one sink.
+    class Output : public TrueMIDI_Source {
+        void stallUpstream(MIDIStaller *cause, MIDI_Sink *) override {
+            matrix->stallFromSink(index, cause, true);
+        }
+        void unstallUpstream(MIDIStaller *cause, MIDI_Sink *) override {
+            matrix->stallFromSink(index, cause, false);
+        }
+
+        MIDI_RoutingMatrix *matrix;
+        uint8_t index;
+        friend class MIDI_RoutingMatrix;
+    };
+
+  private:
+    Input inputs[NumSources];
+    Output outputs[NumSinks];
+    MIDI_Pipe inputPipes[NumSources];
+    MIDI_Pipe outputPipes[NumSinks];
+    AH::BitArray<NumSinks> routes[NumSources];
+    uint8_t numSources = 0;
+    uint8_t numSinks = 0;
+};
+
+END_CS_NAMESPACE
+
+#endif
@@ -1,8 +1,11 @@
 #include "SerialMIDI_Interface.hpp"
+#include <MIDI_Parsers/BufferPuller.hpp>
 #include <MIDI_Parsers/StreamPuller.hpp>
 
 #include "PicoUSBInit.hpp"
 
+#include <string.h>
+
 BEGIN_CS_NAMESPACE
 
 // -------------------------------------------------------------------------- //
@@ -12,10 +15,43 @@ BEGIN_CS_NAMESPACE
 MIDIReadEvent StreamMIDI_Interface::read() {
     if (!ensure_usb_init(stream))
         return MIDIReadEvent::NO_MESSAGE;
-    return parser.pull(StreamPuller(stream));
+    if (rxBuffer == nullptr)
+        return parser.pull(StreamPuller(stream));
+    while (true) {
+        // Parse the data that's left in the receive buffer
+        auto puller = BufferPuller(rxBuffer + rxIndex, rxLength - rxIndex);
+        MIDIReadEvent event = parser.pull(puller);
+        rxIndex = puller.begin() - rxBuffer;
+        if (event != MIDIReadEvent::NO_MESSAGE)
+            return event;
+        // All data was consumed, refill the buffer
+        int available = stream.available();
+        if (available <= 0)
+            return MIDIReadEvent::NO_MESSAGE;
+        uint16_t count = available < rxSize ? available : rxSize;
+        rxLength = stream.readBytes(rxBuffer, count);
+        rxIndex = 0;
+        if (rxLength == 0)
+            return MIDIReadEvent::NO_MESSAGE; // LCOV_EXCL_LINE
+    }
 }
 
-void StreamMIDI_Interface::update() { MIDI_Interface::updateIncoming(this); }
+void StreamMIDI_Interface::setReceiveBuffer(uint8_t *buffer, uint16_t size) {
+    rxBuffer = buffer;
+    rxSize = buffer == nullptr ? 0 : size;
+    rxLength = rxIndex = 0;
+#if !IGNORE_SYSEX
+    parser.setZeroCopySysEx(buffer != nullptr);
+#endif
+}
+
+void StreamMIDI_Interface::update() {
+    if (batchedWrites)
+        sendNowImpl();
+    else
+        drainTransmitBuffer(true);
+    MIDI_Interface::updateIncoming(this);
+}
 
 // -------------------------------------------------------------------------- //
 
@@ -41,34 +77,132 @@ SysExMessage StreamMIDI_Interface::getSysExMessage() const {
 
 // Sending MIDI
 
+void StreamMIDI_Interface::setTransmitBuffer(uint8_t *buffer, uint16_t size) {
+    sendNowImpl();
+    txBuffer = buffer;
+    txSize = buffer == nullptr ? 0 : size;
+    txHead = txLength = 0;
+}
+
+uint16_t StreamMIDI_Interface::popTransmitBuffer(uint16_t count) {
+    uint16_t contiguous = txSize - txHead;
+    if (count > contiguous)
+        count = contiguous;
+    if (count > txLength)
+        count = txLength;
+    stream.write(txBuffer + txHead, count);
+    txHead = txHead + count == txSize ? 0 : txHead + count;
+    txLength -= count;
+    if (txLength == 0) // Start from the beginning again, to avoid wrapping
+        txHead = 0;
+    return count;
+}
+
+void StreamMIDI_Interface::drainTransmitBuffer(bool block) {
+    while (txLength > 0) {
+        int available = stream.availableForWrite();
+        if (available > 0) {
+            txWriteSpaceKnown = true;
+            popTransmitBuffer(available < 0xFFFF ? available : 0xFFFF);
+            continue;
+        }
+        // Either the stream is full, or it doesn't know how much space it has
+        // left (the default implementation of availableForWrite returns zero).
+        // In the latter case, make sure the data is sent anyway, like without
+        // transmit buffer.
+        if (block && !txWriteSpaceKnown)
+            sendNowImpl();
+        break;
+    }
+}
+
+void StreamMIDI_Interface::write(const uint8_t *data, uint16_t length) {
+    if (txBuffer == nullptr) {
+        stream.write(data, length);
+        return;
+    }
+    if (batchedWrites && length > txSize - txLength) {
+        // Full, write the entire batch at once to make room
+        sendNowImpl();
+        if (length > txSize) {
+            stream.write(data, length);
+            return;
+        }
+    }
+    while (length > 0) {
+        if (txLength == txSize) // Full, make room by writing the oldest data
+            popTransmitBuffer(length);
+        uint16_t tail = txHead + txLength;
+        if (tail >= txSize)
+            tail -= txSize;
+        uint16_t space = tail >= txHead ? txSize - tail : txHead - tail;
+        uint16_t count = length < space ? length : space;
+        memcpy(txBuffer + tail, data, count);
+        txLength += count;
+        data += count;
+        length -= count;
+    }
+    if (!batchedWrites)
+        drainTransmitBuffer(false);
+}
+
+void StreamMIDI_Interface::sendNowImpl() {
+    while (txLength > 0)
+        popTransmitBuffer(txLength);
+}
+
+void StreamMIDI_Interface::endLoop() {
+    if (batchedWrites)
+        sendNowImpl();
+}
+
 void StreamMIDI_Interface::sendChannelMessageImpl(ChannelMessage msg) {
     if (!ensure_usb_init(stream))
         return;
-    stream.write(msg.header);
-    stream.write(msg.data1);
-    if (msg.hasTwoDataBytes())
-        stream.write(msg.data2);
+    uint8_t length = msg.hasTwoDataBytes() ? 3 : 2;
+    if (!runningStatusEnabled) {
+        const uint8_t data[] {msg.header, msg.data1, msg.data2};
+        write(data, length);
+        return;
+    }
+    if (noteOffAsNoteOn && msg.getMessageType() == MIDIMessageType::NoteOff) {
+        msg.setMessageType(MIDIMessageType::NoteOn);
+        msg.data2 = 0;
+    }
+    const uint8_t data[] {msg.header, msg.data1, msg.data2};
+    bool refresh = runningStatusRefresh != 0 &&
+                   txRunningStatusCount >= runningStatusRefresh;
+    if (msg.header == txRunningStatus && !refresh) {
+        ++txRunningStatusCount;
+        write(data + 1, length - 1);
+    } else {
+        txRunningStatus = msg.header;
+        txRunningStatusCount = 0;
+        write(data, length);
+    }
 }
 
 void StreamMIDI_Interface::sendSysCommonImpl(SysCommonMessage msg) {
     if (!ensure_usb_init(stream))
         return;
-    stream.write(msg.header);
-    if (msg.getNumberOfDataBytes() >= 1)
-        stream.write(msg.data1);
-    if (msg.getNumberOfDataBytes() >= 2)
-        stream.write(msg.data2);
+    if (sysCommonCancelsRunningStatus)
+        txRunningStatus = 0;
+    const uint8_t data[] {msg.header, msg.data1, msg.data2};
+    write(data, 1 + msg.getNumberOfDataBytes());
 }
 
 void StreamMIDI_Interface::sendSysExImpl(SysExMessage msg) {
     if (!ensure_usb_init(stream))
         return;
-    stream.write(msg.data, msg.length);
+    if (sysExCancelsRunningStatus && msg.length > 0)
+        txRunningStatus = 0;
+    write(msg.data, msg.length);
 }
 
 void StreamMIDI_Interface::sendRealTimeImpl(RealTimeMessage msg) {
     if (!ensure_usb_init(stream))
         return;
+    // Real-Time messages skip the transmit buffer
     stream.write(msg.message);
 }
 
@@ -38,13 +38,172 @@ class StreamMIDI_Interface : public MIDI_Interface {
     SysExMessage getSysExMessage() const;
 
     void update() override;
+    /// Write the batched data to the stream, if batching is enabled.
+    /// @see    @ref enableBatchedWrites
+    void endLoop() override;
+
+    /**
+     * @brief   Read incoming data from the stream in blocks, using the given
+     *          receive buffer.
+     * 
+     * SysEx messages that are entirely contained in a single block are passed
+     * on without copying them, the SysExMessage points straight into the 
+     * receive buffer. The buffer is only refilled after all messages in it 
+     * have been dispatched to the sinks.
+     * 
+     * Should be called before any MIDI data is read, data that is still in the
+     * old receive buffer is discarded.
+     * 
+     * @param   buffer
+     *          The receive buffer, or `nullptr` to read the stream one byte at
+     *          a time (default).
+     * @param   size
+     *          The size of the receive buffer in bytes.
+     */
+    void setReceiveBuffer(uint8_t *buffer, uint16_t size);
+
+    /**
+     * @brief   Queue outgoing data in the given transmit buffer, so Real-Time
+     *          messages can be sent ahead of it.
+     *
+     * Without a transmit buffer, all messages are written to the stream in
+     * the order in which they are sent, so a MIDI Timing Clock message that
+     * is sent right after a long SysEx message has to wait until the entire
+     * SysEx message has been transmitted.
+     *
+     * With a transmit buffer, Channel, System Common and SysEx messages are
+     * added to the buffer, and only as many bytes as the stream can accept
+     * without blocking (see `Stream::availableForWrite()`) are written at a
+     * time. The rest is written by @ref update and @ref sendNow. Streams that
+     * don't implement `availableForWrite()` (e.g. `SoftwareSerial`) always
+     * report zero: until the stream reports some free space, @ref update
+     * writes the entire buffer, which may block, just like without transmit
+     * buffer. Real-Time
+     * messages skip the buffer and are written to the stream immediately,
+     * possibly in the middle of another message, as allowed by the MIDI
+     * specification. When the buffer is full, the oldest data is written to
+     * the stream first, which blocks.
+     *
+     * @param   buffer
+     *          The transmit buffer, or `nullptr` to write all messages to the
+     *          stream directly (default).
+     * @param   size
+     *          The size of the transmit buffer in bytes.
+     */
+    void setTransmitBuffer(uint8_t *buffer, uint16_t size);
+    /// Get the number of bytes that are waiting in the transmit buffer.
+    uint16_t getTransmitBufferUsage() const { return txLength; }
+    /**
+     * @brief   Collect outgoing data in the transmit buffer, and write all of
+     *          it to the stream at once.
+     *
+     * By default, every message is written to the stream as soon as it is
+     * sent, using one write call per message. Some streams have a large cost
+     * per call, e.g. USB CDC serial ports, where a call can result in its own
+     * USB transfer, or `SoftwareSerial`.
+     *
+     * When batching is enabled, Channel, System Common and SysEx messages are
+     * only added to the transmit buffer. Its contents are written using a
+     * single call to `Stream::write(const uint8_t *, size_t)` when
+     * @ref sendNow or @ref update is called, when the buffer is full, or at
+     * the end of @ref Control_Surface_::loop. Real-Time messages are still
+     * written immediately. Has no effect without a transmit buffer.
+     *
+     * @see     @ref setTransmitBuffer
+     */
+    void enableBatchedWrites(bool enable = true) {
+        if (!enable)
+            sendNowImpl();
+        batchedWrites = enable;
+    }
+    /// Check whether outgoing data is written to the stream in batches.
+    bool isBatchedWritesEnabled() const { return batchedWrites; }
+
+    /// @name   Running status
+    /// @{
+
+    /**
+     * @brief   Omit the status byte of outgoing Channel messages that have the
+     *          same status (message type and channel) as the previous one.
+     *
+     * This saves up to a third of the bandwidth for long runs of Control
+     * Change, Pitch Bend or Note On messages on the same channel, e.g. when
+     * moving a fader. Real-Time messages don't affect the running status, so
+     * they can still be sent in between. Disabled by default.
+     *
+     * @see     @ref setNoteOffAsNoteOn
+     * @see     @ref setRunningStatusCancellation
+     * @see     @ref setRunningStatusRefresh
+     */
+    void enableRunningStatus(bool enable = true) {
+        runningStatusEnabled = enable;
+        txRunningStatus = 0;
+    }
+    /// Check whether running status is enabled for outgoing messages.
+    bool isRunningStatusEnabled() const { return runningStatusEnabled; }
+    /**
+     * @brief   Send Note Off messages as Note On messages with a velocity of
+     *          zero, so they can share the running status of the Note On
+     *          messages.
+     *
+     * The release velocity of the Note Off messages is lost. Only has an effect
+     * if running status is enabled.
+     */
+    void setNoteOffAsNoteOn(bool noteOffAsNoteOn = true) {
+        this->noteOffAsNoteOn = noteOffAsNoteOn;
+    }
+    /**
+     * @brief   Select which messages cancel the running status, so the next
+     *          Channel message is sent with its status byte.
+     *
+     * The MIDI specification requires receivers to cancel running status after
+     * System Exclusive and System Common messages (default). Only disable this
+     * if the receiver is known to keep the running status, like the parser of
+     * this library when `sysCommonCancelsRunningStatus` is false.
+     */
+    void setRunningStatusCancellation(bool sysExCancels,
+                                      bool sysCommonCancels) {
+        this->sysExCancelsRunningStatus = sysExCancels;
+        this->sysCommonCancelsRunningStatus = sysCommonCancels;
+    }
+    /**
+     * @brief   Repeat the status byte after the given number of messages that
+     *          were sent with running status.
+     *
+     * A receiver that was connected in the middle of a run, or that missed the
+     * status byte because of a transmission error, can only interpret the
+     * messages again after the next status byte. Refreshing the status limits
+     * the number of messages that are lost this way.
+     *
+     * @param   messages
+     *          The maximum number of consecutive messages without status byte,
+     *          or zero to never repeat the status byte (default).
+     */
+    void setRunningStatusRefresh(uint8_t messages) {
+        runningStatusRefresh = messages;
+    }
+
+    /// @}
 
   protected:
     void sendChannelMessageImpl(ChannelMessage) override;
     void sendSysCommonImpl(SysCommonMessage) override;
     void sendSysExImpl(SysExMessage) override;
     void sendRealTimeImpl(RealTimeMessage) override;
-    void sendNowImpl() override {}
+    void sendNowImpl() override;
+
+  private:
+    /// Write the given data to the transmit buffer, or directly to the stream
+    /// if there is no transmit buffer.
+    void write(const uint8_t *data, uint16_t length);
+    /// Write at most the given number of bytes from the transmit buffer to the
+    /// stream. Blocks if the stream can't accept them yet.
+    /// @return The number of bytes written.
+    uint16_t popTransmitBuffer(uint16_t count);
+    /// Write as many bytes from the transmit buffer to the stream as it can
+    /// accept without blocking. If the stream doesn't report how many bytes
+    /// it can accept and @p block is true, write all of them, which may block.
+    void drainTransmitBuffer(bool block);
 
   protected:
 #if !DISABLE_PIPES
@@ -57,6 +216,39 @@ class StreamMIDI_Interface : public MIDI_Interface {
   protected:
     Stream &stream;
     SerialMIDI_Parser parser;
+
+  private:
+    /// @see @ref setReceiveBuffer
+    uint8_t *rxBuffer = nullptr;
+    uint16_t rxSize = 0;
+    /// Number of valid bytes in @ref rxBuffer.
+    uint16_t rxLength = 0;
+    /// Index of the next byte in @ref rxBuffer to parse.
+    uint16_t rxIndex = 0;
+    /// @see @ref setTransmitBuffer
+    uint8_t *txBuffer = nullptr;
+    uint16_t txSize = 0;
+    /// Index of the oldest byte in @ref txBuffer.
+    uint16_t txHead = 0;
+    /// Number of bytes in @ref txBuffer that still have to be written.
+    uint16_t txLength = 0;
+    /// Whether `Stream::availableForWrite()` ever returned a nonzero value,
+    /// i.e. whether a zero return value means that the stream is full.
+    bool txWriteSpaceKnown = false;
+    /// @see @ref enableBatchedWrites
+    bool batchedWrites = false;
+    /// @see @ref enableRunningStatus
+    bool runningStatusEnabled = false;
+    bool noteOffAsNoteOn = false;
+    bool sysExCancelsRunningStatus = true;
+    bool sysCommonCancelsRunningStatus = true;
+    uint8_t runningStatusRefresh = 0;
+    /// Status byte of the last Channel message that was sent, or zero if the
+    /// next message has to include its status byte.
+    uint8_t txRunningStatus = 0;
+    /// Number of messages that were sent without status byte since the last
+    /// status byte.
+    uint8_t txRunningStatusCount = 0;
 };
 
 // -------------------------------------------------------------------------- //
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "MIDI_Pipes.hpp"
+#if !DISABLE_PIPES
+
+#include <AH/STL/utility> // std::pair
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @addtogroup MIDI_Routing
+ * @{
+ */
+
+/// Stages that can be composed into a @ref StaticMIDI_Pipe.
+///
+/// A stage is a function object that is called with a (mutable) reference to
+/// a message. It returns true to pass on the (possibly modified) message to
+/// the next stage, or false to drop it. A stage only has to handle the message
+/// types it is interested in, all other messages pass through unchanged.
+namespace MIDIPipeStages {
+
+/// Drop all messages of the given type, e.g. `MIDIMessageType::ActiveSensing`.
+template <MIDIMessageType Type>
+struct Drop {
+    bool operator()(ChannelMessage &msg) const {
+        return msg.getMessageType() != Type;
+    }
+    bool operator()(SysExMessage &) const {
+        return Type != MIDIMessageType::SysExStart;
+    }
+    bool operator()(SysCommonMessage &msg) const {
+        return msg.getMessageType() != Type;
+    }
+    bool operator()(RealTimeMessage &msg) const {
+        return msg.getMessageType() != Type;
+    }
+};
+
+/// Only let through Channel messages on the given channel (1-16), other
+/// Channel messages are dropped.
+template <uint8_t OneBasedChannel>
+struct OnlyChannel {
+    static_assert(OneBasedChannel >= 1 && OneBasedChannel <= 16,
+                  "Invalid channel");
+    bool operator()(ChannelMessage &msg) const {
+        return msg.getChannel().getRaw() == OneBasedChannel - 1;
+    }
+};
+
+/// Change the channel of all Channel messages on channel `From` to channel
+/// `To` (1-16).
+template <uint8_t From, uint8_t To>
+struct MapChannel {
+    static_assert(From >= 1 && From <= 16, "Invalid channel");
+    static_assert(To >= 1 && To <= 16, "Invalid channel");
+    bool operator()(ChannelMessage &msg) const {
+        if (msg.getChannel().getRaw() == From - 1)
+            msg.setChannel(Channel(To - 1));
+        return true;
+    }
+};
+
+/// Change the cable number of all messages on cable `From` to cable `To`
+/// (1-16).
+template <uint8_t From, uint8_t To>
+struct MapCable {
+    static_assert(From >= 1 && From <= 16, "Invalid cable");
+    static_assert(To >= 1 && To <= 16, "Invalid cable");
+    template <class Message>
+    bool operator()(Message &msg) const {
+        if (msg.getCable().getRaw() == From - 1)
+            msg.setCable(Cable(To - 1));
+        return true;
+    }
+};
+
+/// Transpose Note On, Note Off and Key Pressure messages by the given number
+/// of semitones. Notes that end up outside of the MIDI range are dropped.
+template <int8_t Semitones>
+struct Transpose {
+    bool operator()(ChannelMessage &msg) const {
+        auto type = msg.getMessageType();
+        if (type != MIDIMessageType::NoteOff &&
+            type != MIDIMessageType::NoteOn &&
+            type != MIDIMessageType::KeyPressure)
+            return true;
+        int16_t note = int16_t(msg.data1) + Semitones;
+        msg.data1 = uint8_t(note);
+        return note >= 0 && note <= 0x7F;
+    }
+};
+
+/// Apply a single stage to a message if the stage handles messages of this
+/// type.
+template <class Stage, class Message>
+auto apply(Stage &stage, Message &msg, int) -> decltype(bool(stage(msg))) {
+    return stage(msg);
+}
+/// Messages of types that the stage doesn't handle are passed on unchanged.
+template <class Stage, class Message>
+bool apply(Stage &, Message &, long) {
+    return true;
+}
+
+/// Composition of multiple stages, which are applied from left to right.
+template <class... Stages>
+struct Chain;
+
+/// @cond
+
+template <>
+struct Chain<> {
+    template <class Message>
+    bool operator()(Message &) {
+        return true;
+    }
+};
+
+template <class First, class... Rest>
+struct Chain<First, Rest...> {
+    Chain() = default;
+    Chain(First first, Rest... rest) : first(first), rest(rest...) {}
+
+    template <class Message>
+    bool operator()(Message &msg) {
+        return apply(first, msg, 0) && rest(msg);
+    }
+
+    First first;
+    Chain<Rest...> rest;
+};
+
+/// @endcond
+
+} // namespace MIDIPipeStages
+
+/**
+ * @brief   MIDI pipe that filters and maps messages using stages that are
+ *          composed at compile time.
+ *
+ * Chaining multiple @ref MIDI_Pipe%s that each override
+ * @ref MIDI_Pipe::mapForwardMIDI costs two virtual function calls per pipe
+ * for every message. The stages of a static pipe are inlined into a single
+ * forwarding function instead, and the stages in @ref MIDIPipeStages have no
+ * state, so they take up no memory either.
+ *
+ * ~~~cpp
+ * using namespace MIDIPipeStages;
+ * // Drop Active Sensing, and move channel 1 to channel 3
+ * StaticMIDI_Pipe<Drop<MIDIMessageType::ActiveSensing>, MapChannel<1, 3>> pipe;
+ * midiA >> pipe >> midiB;
+ * ~~~
+ *
+ * Static pipes can be used with @ref MIDI_PipeFactory and with all routing
+ * operators, just like normal pipes:
+ *
+ * ~~~cpp
+ * MIDI_PipeFactory<2, StaticMIDI_Pipe<MapChannel<1, 3>>> pipes;
+ * midiA >> pipes >> midiB;
+ * midiA >> pipes >> midiC;
+ * ~~~
+ *
+ * Custom stages can be written as function objects, see
+ * @ref MIDIPipeStages.
+ *
+ * @tparam  Stages
+ *          The stages that are applied to the messages, from left to right.
+ */
+template <class... Stages>
+class StaticMIDI_Pipe : public MIDI_Pipe {
+  public:
+    StaticMIDI_Pipe() = default;
+    /// Initialize the stages that have state.
+    template <class First, class... Rest>
+    StaticMIDI_Pipe(First first, Rest... rest) : stages(first, rest...) {}
+
+    /// The stages of this pipe.
+    MIDIPipeStages::Chain<Stages...> stages;
+
+  private:
+    template <class Message>
+    void mapForward(Message msg) {
+        if (stages(msg))
+            sourceMIDItoSink(msg);
+    }
+
+    void mapForwardMIDI(ChannelMessage msg) override { mapForward(msg); }
+    void mapForwardMIDI(SysExMessage msg) override { mapForward(msg); }
+    void mapForwardMIDI(SysCommonMessage msg) override { mapForward(msg); }
+    void mapForwardMIDI(RealTimeMessage msg) override { mapForward(msg); }
+};
+
+/// A bidirectional pipe that consists of two static pipes. When connected as
+/// `A | pipe | B`, the first pipe carries the messages from B to A, and the
+/// second pipe carries the messages from A to B.
+template <class First, class Second>
+using BidirectionalStaticMIDI_Pipe = std::pair<First, Second>;
+
+/// @}
+
+END_CS_NAMESPACE
+
+#endif
@@ -17,6 +17,29 @@ struct BulkRX {
     /// @return Whether a message was available.
     bool read(MessageType &message);
 
+    /// The messages of a received packet that haven't been read yet.
+    struct PacketView {
+        const MessageType *data = nullptr;
+        uint32_t size = 0;
+
+        const MessageType *begin() const { return data; }
+        const MessageType *end() const { return data + size; }
+        bool empty() const { return size == 0; }
+    };
+
+    /// Get the messages of the oldest received packet that haven't been read
+    /// yet, without removing them. The view remains valid until the messages
+    /// are marked as read using @ref consume().
+    /// @return An empty view if no messages are available.
+    PacketView peek_packet();
+    /// Mark the first @p num_msgs messages of the view returned by
+    /// @ref peek_packet() as read. When all messages of the packet have been
+    /// read, its buffer is used to receive a new packet.
+    void consume(uint32_t num_msgs);
+    /// Read up to @p num_msgs messages, possibly from multiple packets.
+    /// @return The number of messages that were read.
+    uint32_t read_many(MessageType *msgs, uint32_t num_msgs);
+
   protected:
     void reset(uint16_t packet_size = MaxPacketSize);
 
@@ -24,6 +47,9 @@ struct BulkRX {
     static constexpr uint16_t MaxPacketSize = MaxPacketSizeV;
     static constexpr uint16_t SizeReserved = MaxPacketSize + 1;
     static constexpr uint16_t NumRxPackets = MaxPacketSize == 64 ? 16 : 4;
+    static constexpr uint16_t MaxPacketMessages =
+        MaxPacketSize / sizeof(MessageType);
+    static_assert(MaxPacketSize % sizeof(MessageType) == 0, "");
 
   protected:
     // Derived should implement the following methods:
@@ -43,12 +69,18 @@ struct BulkRX {
     /// State for reading incoming USB data.
     struct Reading {
         struct Buffer {
+            /// Number of messages in the buffer.
             uint16_t size = 0;
+            /// Index of the next message to read.
             uint16_t index = 0;
-            alignas(uint32_t) uint8_t buffer[MaxPacketSize];
+            MessageType buffer[MaxPacketMessages];
         } buffers[NumRxPackets];
         interrupt_atomic<uint32_t> available {0};
         uint32_t read_idx {0};
+        /// Whether the buffer at `read_idx` is known to contain a packet, so
+        /// `available` doesn't have to be checked for every message. Only used
+        /// by the main program.
+        bool have_packet = false;
         interrupt_atomic<uint32_t> write_idx {0};
         interrupt_atomic<bool> reading {false};
         uint16_t packet_size = MaxPacketSize;
@@ -3,6 +3,7 @@
 #include <AH/Arduino-Wrapper.h>
 #include <AH/Containers/CRTP.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 #ifdef FATAL_ERRORS
@@ -19,48 +20,84 @@ void BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::reset(
     reading.packet_size = packet_size;
     reading.available.store(0, mo_rlx);
     reading.read_idx = 0;
+    reading.have_packet = false;
     reading.write_idx.store(0, mo_rlx);
     reading.reading.store(true, mo_rlx);
     CRTP(Derived).rx_start(reading.buffers[0].buffer, reading.packet_size);
 }
 
 template <class Derived, class MessageTypeT, uint16_t MaxPacketSizeV>
-bool BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::read(MessageType &message) {
-    // Check if there are any bytes available for reading
-    uint32_t available = reading.available.load(mo_acq);
-    if (available == 0)
-        return false;
+auto BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::peek_packet()
+    -> PacketView {
+    // Check if there are any packets available for reading, only once per
+    // packet
+    if (!reading.have_packet) {
+        if (reading.available.load(mo_acq) == 0)
+            return {};
+        reading.have_packet = true;
+    }
+    // Get the buffer with received data (data is at least as new as available)
+    rbuffer_t &read_buffer = reading.buffers[reading.read_idx];
+    CS_MIDI_USB_ASSERT(read_buffer.index < read_buffer.size);
+    return {
+        read_buffer.buffer + read_buffer.index,
+        uint32_t(read_buffer.size - read_buffer.index),
+    };
+}
 
-    // Get the buffer with received data
+template <class Derived, class MessageTypeT, uint16_t MaxPacketSizeV>
+void BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::consume(
+    uint32_t num_msgs) {
+    if (num_msgs == 0)
+        return;
+    CS_MIDI_USB_ASSERT(reading.have_packet);
     uint32_t r = reading.read_idx;
     rbuffer_t &read_buffer = reading.buffers[r];
-
-    // Read the data from the buffer (data is at least as new as available)
-    memcpy(&message, &read_buffer.buffer[read_buffer.index],
-           sizeof(MessageType));
-
-    static_assert(MaxPacketSize % sizeof(MessageType) == 0, "");
-    CS_MIDI_USB_ASSERT(reading.packet_size % sizeof(MessageType) == 0);
-    read_buffer.index += sizeof(MessageType);
-    // If we've read all messages from this buffer
-    if (read_buffer.index == read_buffer.size) {
-        // Increment the read index (and wrap around)
-        r = (r + 1 == NumRxPackets) ? 0 : r + 1;
-        reading.read_idx = r;
-        reading.available.fetch_sub(1, mo_rel);
-        // There is now space in the queue
-        // Check if the next read is already in progress
-        if (reading.reading.exchange(true, mo_acq) == false) {
-            // If not, start the next read now
-            uint32_t w = reading.write_idx.load(mo_rlx);
-            CRTP(Derived).rx_start(reading.buffers[w].buffer,
-                                   reading.packet_size);
-        }
+    CS_MIDI_USB_ASSERT(read_buffer.index + num_msgs <= read_buffer.size);
+    read_buffer.index += num_msgs;
+    // If we haven't read all messages from this buffer yet, we're done
+    if (read_buffer.index != read_buffer.size)
+        return;
+    // Increment the read index (and wrap around)
+    r = (r + 1 == NumRxPackets) ? 0 : r + 1;
+    reading.read_idx = r;
+    reading.have_packet = false;
+    reading.available.fetch_sub(1, mo_rel);
+    // There is now space in the queue
+    // Check if the next read is already in progress
+    if (reading.reading.exchange(true, mo_acq) == false) {
+        // If not, start the next read now
+        uint32_t w = reading.write_idx.load(mo_rlx);
+        CRTP(Derived).rx_start(reading.buffers[w].buffer, reading.packet_size);
     }
+}
 
+template <class Derived, class MessageTypeT, uint16_t MaxPacketSizeV>
+bool BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::read(MessageType &message) {
+    PacketView packet = peek_packet();
+    if (packet.empty())
+        return false;
+    message = *packet.begin();
+    consume(1);
     return true;
 }
 
+template <class Derived, class MessageTypeT, uint16_t MaxPacketSizeV>
+uint32_t BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::read_many(
+    MessageType *msgs, uint32_t num_msgs) {
+    uint32_t total = 0;
+    while (total < num_msgs) {
+        PacketView packet = peek_packet();
+        if (packet.empty())
+            break;
+        uint32_t count = std::min(packet.size, num_msgs - total);
+        std::copy(packet.begin(), packet.begin() + count, msgs + total);
+        consume(count);
+        total += count;
+    }
+    return total;
+}
+
 template <class Derived, class MessageTypeT, uint16_t MaxPacketSizeV>
 void BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::rx_callback(
     uint32_t num_bytes_read) {
@@ -75,10 +112,10 @@ void BulkRX<Derived, MessageTypeT, MaxPacketSizeV>::rx_callback(
         return;
     }
 
-    // Otherwise, store how many bytes were read
+    // Otherwise, store how many messages were read
     rbuffer_t &write_buffer = reading.buffers[w];
     write_buffer.index = 0;
-    write_buffer.size = num_bytes_read;
+    write_buffer.size = num_bytes_read / sizeof(MessageType);
     // Increment the write index (and wrap around)
     w = (w + 1 == NumRxPackets) ? 0 : w + 1;
     reading.write_idx.store(w, mo_rlx);
@@ -8,7 +8,14 @@
 BEGIN_CS_NAMESPACE
 
 /// Sends Bulk packets (IN for device mode, OUT for host mode)
-template <class Derived, class MessageTypeT, uint16_t MaxPacketSizeV>
+///
+/// Outgoing messages are collected in a ring of @p NumBuffersV packet buffers.
+/// One packet is being transmitted at a time, the main program fills the
+/// next free buffer, and full buffers are queued in between. More buffers
+/// allow the main program to continue writing when the host polls slowly, or
+/// during large SysEx dumps.
+template <class Derived, class MessageTypeT, uint16_t MaxPacketSizeV,
+          uint8_t NumBuffersV = 2>
 struct BulkTX {
   public:
     using MessageType = MessageTypeT;
@@ -55,13 +62,36 @@ struct BulkTX {
     /// Get and clear the number messages that failed to send.
     uint32_t clearWriteError() { return writing.error.exchange(0, mo_rlx); }
 
+    /// Get the number of full packets that are queued or being sent.
+    uint32_t getQueueDepth() const {
+        return writing.head.load(mo_rlx) - writing.tail.load(mo_rlx);
+    }
+    /// Get the largest number of packets that were queued at the same time.
+    uint32_t getMaxQueueDepth() const {
+        return writing.max_depth.load(mo_rlx);
+    }
+    /// Get and clear the largest number of packets that were queued at the
+    /// same time.
+    uint32_t clearMaxQueueDepth() {
+        return writing.max_depth.exchange(0, mo_rlx);
+    }
+    /// Get the total time (in microseconds) that @ref write() had to wait for
+    /// a free buffer.
+    uint32_t getStallTime() const { return writing.stall_time.load(mo_rlx); }
+    /// Get and clear the total time (in microseconds) that @ref write() had to
+    /// wait for a free buffer.
+    uint32_t clearStallTime() { return writing.stall_time.exchange(0, mo_rlx); }
+
   protected:
     void reset(uint16_t packet_size = MaxPacketSize);
     bool wait_connect();
 
   private:
     static constexpr uint16_t MaxPacketSize = MaxPacketSizeV;
-    static constexpr uint16_t SizeReserved = MaxPacketSize + 1;
+    static constexpr uint8_t NumBuffers = NumBuffersV;
+    static_assert(NumBuffers >= 2, "BulkTX needs at least two buffers");
+    static_assert((NumBuffers & (NumBuffers - 1)) == 0,
+                  "The number of buffers should be a power of two");
 
   protected:
     // Derived should implement the following methods:
@@ -86,26 +116,51 @@ struct BulkTX {
     constexpr static std::memory_order mo_acq_rel = std::memory_order_acq_rel;
 
     /// State for writing outgoing USB-MIDI data.
+    /// Buffers with indices (modulo @ref NumBuffers) in the range
+    /// [`tail`, `head`) are full and queued for sending, the oldest one may be
+    /// in the process of being sent. The buffer at index `head` is being
+    /// filled by the main program.
     struct Writing {
         struct Buffer {
             uint16_t size {0};
             alignas(MessageType) uint8_t buffer[MaxPacketSize];
-        } buffers[2];
-        interrupt_atomic<Buffer *> active_writebuffer {&buffers[0]};
-        interrupt_atomic<Buffer *> sending {nullptr};
-        interrupt_atomic<Buffer *> send_later {nullptr};
-        interrupt_atomic<Buffer *> send_now {nullptr};
+        } buffers[NumBuffers];
+        /// Index of the buffer that is being filled. Only modified by the owner
+        /// of the `filling` lock.
+        interrupt_atomic<uint32_t> head {0};
+        /// Index of the oldest queued buffer. Only modified by the owner of the
+        /// `sending` lock.
+        interrupt_atomic<uint32_t> tail {0};
+        /// Lock for the buffer at index `head`.
+        interrupt_atomic<bool> filling {false};
+        /// Lock for starting transfers, held as long as a transfer is busy.
+        interrupt_atomic<bool> sending {false};
+        /// Set if the buffer at index `head` should be queued as soon as
+        /// possible, because it is full, or because of a timeout or an explicit
+        /// call to @ref send_now().
+        interrupt_atomic<bool> flush {false};
         interrupt_atomic<uint32_t> error {0};
+        interrupt_atomic<uint32_t> max_depth {0};
+        interrupt_atomic<uint32_t> stall_time {0};
         uint16_t packet_size = MaxPacketSize;
     } writing;
     using wbuffer_t = typename Writing::Buffer;
     bool disconnected = false;
 
-    uint32_t index_of(wbuffer_t *p) const { return p - writing.buffers; }
-    wbuffer_t *other_buf(wbuffer_t *p) {
-        return &writing.buffers[!index_of(p)];
+    /// The context a transfer is started from.
+    enum class Context { Main, Timeout, ISR };
+
+    wbuffer_t &buffer_at(uint32_t index) {
+        return writing.buffers[index % NumBuffers];
     }
     uint32_t write_impl(const MessageType *msgs, uint32_t num_msgs);
+    /// Queue the buffer that is being filled if the `flush` flag is set and
+    /// if there's a free buffer to continue writing in.
+    void try_flush();
+    /// Start sending the oldest queued buffer if no transfer is busy.
+    void try_send(Context ctx);
+    void start_transfer(Context ctx, wbuffer_t &buffer);
+    static uint32_t now_us();
 
   protected:
     void timeout_callback();
@@ -32,6 +32,10 @@ class TeensyHostMIDI
     }
 
     using BulkRX<TeensyHostMIDI, uint32_t, MaxPacketSize>::read;
+    using typename BulkRX<TeensyHostMIDI, uint32_t, MaxPacketSize>::PacketView;
+    using BulkRX<TeensyHostMIDI, uint32_t, MaxPacketSize>::peek_packet;
+    using BulkRX<TeensyHostMIDI, uint32_t, MaxPacketSize>::consume;
+    using BulkRX<TeensyHostMIDI, uint32_t, MaxPacketSize>::read_many;
     using BulkTX<TeensyHostMIDI, uint32_t, MaxPacketSize>::write;
     using BulkTX<TeensyHostMIDI, uint32_t, MaxPacketSize>::write_nonblock;
     using BulkTX<TeensyHostMIDI, uint32_t, MaxPacketSize>::send_now;
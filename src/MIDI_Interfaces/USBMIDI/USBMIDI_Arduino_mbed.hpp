@@ -8,6 +8,9 @@ BEGIN_CS_NAMESPACE
 struct Arduino_mbed_USBDeviceMIDIBackend {
     using MIDIUSBPacket_t = AH::Array<uint8_t, 4>;
     MIDIUSBPacket_t read() { return u32_to_bytes(backend.read()); }
+    using PacketView = PluggableUSBMIDI::PacketView;
+    PacketView peekPacket() { return backend.peek_packet(); }
+    void consume(uint32_t num_msgs) { backend.consume(num_msgs); }
     void write(MIDIUSBPacket_t data) { backend.write(bytes_to_u32(data)); }
     void sendNow() { backend.send_now(); }
     bool preferImmediateSend() { return false; }
@@ -66,6 +66,10 @@ class PluggableUSBMIDI : protected arduino::internal::PluggableUSBModule,
     }
 
     using BulkRX<PluggableUSBMIDI, uint32_t, 64>::read;
+    using BulkRX<PluggableUSBMIDI, uint32_t, 64>::PacketView;
+    using BulkRX<PluggableUSBMIDI, uint32_t, 64>::peek_packet;
+    using BulkRX<PluggableUSBMIDI, uint32_t, 64>::consume;
+    using BulkRX<PluggableUSBMIDI, uint32_t, 64>::read_many;
     using BulkTX<PluggableUSBMIDI, uint32_t, 64>::write;
     using BulkTX<PluggableUSBMIDI, uint32_t, 64>::write_nonblock;
     using BulkTX<PluggableUSBMIDI, uint32_t, 64>::send_now;
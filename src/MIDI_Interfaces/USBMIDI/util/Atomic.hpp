@@ -12,8 +12,9 @@
 
 BEGIN_CS_NAMESPACE
 
-#ifndef ARDUINO
+#if !defined(ARDUINO) || defined(ESP32)
 
+// The ESP32 has multiple cores, so compiler fences are not enough.
 #define CS_USE_REAL_ATOMIC 1
 
 #elif defined(ARDUINO_ARCH_RP2040)
@@ -79,6 +79,10 @@ class GenericUSBMIDI_Interface : public MIDI_Interface {
 
     /// @}
 
+  private:
+    MIDIReadEvent read(std::false_type);
+    MIDIReadEvent read(std::true_type);
+
   public:
     /// @name Underlying USB communication
     /// @{
@@ -105,6 +109,8 @@ class GenericUSBMIDI_Interface : public MIDI_Interface {
     USBMIDI_Sender sender;
     /// @see neverSendImmediately()
     bool alwaysSendImmediately_ = true;
+    /// @see sendAtEndOfLoop()
+    bool sendAtEndOfLoop_ = false;
 
   public:
     /// @name   Buffering USB packets
@@ -125,6 +131,21 @@ class GenericUSBMIDI_Interface : public MIDI_Interface {
     /// Send the USB packets immediately after sending a MIDI message.
     /// @see @ref neverSendImmediately()
     void alwaysSendImmediately() { alwaysSendImmediately_ = true; }
+    /// Send the buffered USB packets at the end of every iteration of
+    /// @ref Control_Surface_::loop, even if they're not full yet. Only useful
+    /// in combination with @ref neverSendImmediately(): all messages that
+    /// are sent during one loop iteration then share USB packets, and the
+    /// latency is limited to the duration of the loop. Packets are still sent
+    /// earlier when they are full, or when the backend's timeout expires (see
+    /// e.g. `PluggableUSBMIDI::setTimeout()`).
+    void sendAtEndOfLoop(bool enable = true) { sendAtEndOfLoop_ = enable; }
+    /// @see @ref sendAtEndOfLoop()
+    bool sendsAtEndOfLoop() const { return sendAtEndOfLoop_; }
+
+    void endLoop() override {
+        if (sendAtEndOfLoop_)
+            backend.sendNow();
+    }
 
     /// @}
 };
@@ -6,8 +6,21 @@ BEGIN_CS_NAMESPACE
 // Reading MIDI
 // -----------------------------------------------------------------------------
 
+template <class, class = void>
+struct has_method_peekPacket : std::false_type {};
+
+template <class T>
+struct has_method_peekPacket<
+    T, void_t<decltype(std::declval<T>().peekPacket())>> : std::true_type {};
+
 template <class Backend>
 MIDIReadEvent GenericUSBMIDI_Interface<Backend>::read() {
+    return read(has_method_peekPacket<Backend>());
+}
+
+// Backends that only return one USB MIDI event at a time
+template <class Backend>
+MIDIReadEvent GenericUSBMIDI_Interface<Backend>::read(std::false_type) {
     auto pullpacket = [this](typename Backend::MIDIUSBPacket_t &packet) {
         packet = backend.read();
         return packet[0] != 0x00;
@@ -15,6 +28,27 @@ MIDIReadEvent GenericUSBMIDI_Interface<Backend>::read() {
     return parser.pull(LambdaPuller(std::move(pullpacket)));
 }
 
+// Backends that give access to an entire received USB packet at once
+template <class Backend>
+MIDIReadEvent GenericUSBMIDI_Interface<Backend>::read(std::true_type) {
+    while (true) {
+        auto packet = backend.peekPacket();
+        auto next = packet.begin(), end = packet.end();
+        auto pullpacket = [&](typename Backend::MIDIUSBPacket_t &event) {
+            if (next == end)
+                return false;
+            event = u32_to_bytes(*next++);
+            return true;
+        };
+        MIDIReadEvent evt = parser.pull(LambdaPuller(std::move(pullpacket)));
+        backend.consume(next - packet.begin());
+        // Continue with the next packet if this one didn't contain a complete
+        // message
+        if (evt != MIDIReadEvent::NO_MESSAGE || packet.empty())
+            return evt;
+    }
+}
+
 template <class Backend>
 void GenericUSBMIDI_Interface<Backend>::begin() {
 #ifndef __SAM3X8E__ // Due compiler too old, doesn't support begin_if_possible()
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <MIDI_Parsers/MIDIStatusTable.hpp>
 #include <MIDI_Parsers/MIDI_MessageTypes.hpp>
 #include <Settings/SettingsWrapper.hpp>
 
@@ -81,7 +82,7 @@ void USBMIDI_Sender::sendChannelMessage(ChannelMessage msg, Send &&send) {
 template <class Send>
 void USBMIDI_Sender::sendSysCommonMessage(SysCommonMessage msg, Send &&send) {
     auto cn = msg.cable;
-    switch (msg.getNumberOfDataBytes()) {
+    switch (getMIDIStatusInfo(msg.header).getLength()) {
         case 2: // 3B
             send(cn, CIN::SystemCommon3B, msg.header, msg.data1, msg.data2);
             break;
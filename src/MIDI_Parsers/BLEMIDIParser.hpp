@@ -17,32 +17,7 @@ class BLEMIDIParser {
   public:
     BLEMIDIParser(const uint8_t *data, size_t length)
         : data(data), end(data + length) {
-        // Need at least two bytes to be useful.
-        // Usually, we have header, timestamp and at least one MIDI byte,
-        // but a SysEx continuation could perhaps have only a header and a
-        // single data byte (this is not explicitly allowed by the spec, but
-        // handling this case requires no extra effort)
-        if (length < 2) {
-            this->data = end;
-        }
-        // First byte should be a header. If it's a data byte, discard packet.
-        else if (isData(data[0])) {
-            this->data = end;
-        }
-        // If the second byte is a data byte, this is a SysEx continuation
-        // packet
-        else if (isData(data[1])) {
-            this->timestamp = data[0] & 0x7F;
-            this->timestamp <<= 7;
-            this->data += 1;
-        }
-        // Otherwise, the second byte is a timestamp, so skip it
-        else {
-            this->timestamp = data[0] & 0x7F;
-            this->timestamp <<= 7;
-            this->timestamp |= data[1] & 0x7F;
-            this->data += 2;
-        }
+        parseHeader();
     }
 
     /// Extend the BLE packet with the given buffer.
@@ -53,6 +28,8 @@ class BLEMIDIParser {
     void extend(const uint8_t *data, size_t length) {
         this->data = data;
         this->end = data + length;
+        // The header and timestamp could be split over two buffers as well
+        parseHeader();
     }
 
     /// Get the next MIDI byte from the BLE packet (if available).
@@ -78,31 +55,100 @@ class BLEMIDIParser {
                 }
                 // Otherwise it's a time stamp
                 else {
-                    uint16_t timestampLow = *data++ & 0x7F;
-                    // The BLE MIDI spec has the following to say about overflow:
-                    // > Should the timestamp value of a subsequent MIDI message
-                    // > in the same packet overflow/wrap (i.e., the
-                    // > timestampLow is smaller than a preceding timestampLow),
-                    // > the receiver is responsible for tracking this by
-                    // > incrementing the timestampHigh by one (the incremented
-                    // > value is not transmitted, only understood as a result
-                    // > of the overflow condition).
-                    if (timestampLow < (timestamp & 0x7F)) // overflow
-                        timestamp += 0x80;
-                    timestamp = (timestamp & 0x3F80) | timestampLow;
+                    updateTimestamp(*data++);
                 }
             }
         }
         return false;
     }
 
+    /// Get the next run of MIDI bytes from the BLE packet (if available): at
+    /// most one status byte, followed by data bytes. Timestamps are never part
+    /// of a run. The run points into the buffer of the BLE packet, so the MIDI
+    /// parser can read it directly, without copying it byte by byte.
+    /// Can be mixed with calls to @ref pull.
+    /// @param[out] runBegin
+    ///             Pointer to the first byte of the run.
+    /// @param[out] runEnd
+    ///             Pointer past the last byte of the run.
+    /// @return True if a run was available, false otherwise.
+    bool pullRun(const uint8_t *&runBegin, const uint8_t *&runEnd) {
+        // Skip the timestamps, stop at the first status or data byte
+        while (data != end && !isData(*data)) {
+            prevWasTimestamp = !prevWasTimestamp;
+            if (!prevWasTimestamp)
+                break; // status byte
+            updateTimestamp(*data++);
+        }
+        if (data == end)
+            return false;
+        runBegin = data;
+        // A status byte can only be followed by data bytes, the next non-data
+        // byte is always a timestamp
+        if (!isData(*data))
+            ++data;
+        while (data != end && isData(*data))
+            ++data;
+        prevWasTimestamp = false;
+        runEnd = data;
+        return true;
+    }
+
     uint16_t getTimestamp() const { return timestamp; }
 
+  private:
+    /// Parse the header and timestamp bytes at the start of the packet.
+    void parseHeader() {
+        // First byte should be a header. If it's a data byte, discard packet.
+        if (headerState == ExpectHeader && data != end) {
+            if (isData(*data)) {
+                headerState = Invalid;
+            } else {
+                timestamp = *data++ & 0x7F;
+                timestamp <<= 7;
+                headerState = ExpectTimestamp;
+            }
+        }
+        // If the second byte is a data byte, this is a SysEx continuation
+        // packet (the timestamp is omitted). Otherwise, the second byte is a
+        // timestamp, so skip it.
+        // Note: a SysEx continuation could perhaps have only a header and a
+        // single data byte (this is not explicitly allowed by the spec, but
+        // handling this case requires no extra effort)
+        if (headerState == ExpectTimestamp && data != end) {
+            if (!isData(*data))
+                timestamp |= *data++ & 0x7F;
+            headerState = Body;
+        }
+        if (headerState == Invalid)
+            data = end;
+    }
+
+    void updateTimestamp(uint8_t timestampByte) {
+        uint16_t timestampLow = timestampByte & 0x7F;
+        // The BLE MIDI spec has the following to say about overflow:
+        // > Should the timestamp value of a subsequent MIDI message in the
+        // > same packet overflow/wrap (i.e., the timestampLow is smaller than
+        // > a preceding timestampLow), the receiver is responsible for
+        // > tracking this by incrementing the timestampHigh by one (the
+        // > incremented value is not transmitted, only understood as a result
+        // > of the overflow condition).
+        if (timestampLow < (timestamp & 0x7F)) // overflow
+            timestamp += 0x80;
+        timestamp = (timestamp & 0x3F80) | timestampLow;
+    }
+
   private:
     const uint8_t *data;
     const uint8_t *end;
     bool prevWasTimestamp = true;
     uint16_t timestamp = 0;
+    enum : uint8_t {
+        ExpectHeader,
+        ExpectTimestamp,
+        Body,
+        Invalid,
+    } headerState = ExpectHeader;
 
   private:
     /// Check if the given byte is a data byte (and not a header, timestamp or
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <AH/STL/vector> // std::vector
+#include <AH/STL/cstddef> // size_t
+#include <AH/STL/cstdint> // uint8_t
+#include <AH/STL/vector>  // std::vector
 #include <Settings/NamespaceSettings.hpp>
 
 BEGIN_CS_NAMESPACE
@@ -27,6 +29,13 @@ class BufferPuller_ {
         return false;
     }
 
+    /// Get a pointer to the next value in the buffer.
+    const T *begin() const { return buffer; }
+    /// Get a pointer past the last value in the buffer.
+    const T *getEnd() const { return end; }
+    /// Mark all values before @p next as pulled.
+    void skipTo(const T *next) { buffer = next; }
+
   private:
     const T *buffer;
     const T *const end;
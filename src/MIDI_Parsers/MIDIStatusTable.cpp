@@ -0,0 +1,65 @@
+#include "MIDIStatusTable.hpp"
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+constexpr auto None = MIDIStatusClass::None;
+constexpr auto Channel = MIDIStatusClass::Channel;
+constexpr auto SysExStart = MIDIStatusClass::SysExStart;
+constexpr auto SysExEnd = MIDIStatusClass::SysExEnd;
+constexpr auto SysCommon = MIDIStatusClass::SysCommon;
+constexpr auto RealTime = MIDIStatusClass::RealTime;
+constexpr uint8_t entry(MIDIStatusClass cls, uint8_t length) {
+    return MIDIStatusInfo::make(cls, length).bits;
+}
+} // namespace
+
+const uint8_t MIDIStatusTable[32] PROGMEM = {
+    // Data bytes (0x00-0x7F)
+    entry(None, 0), entry(None, 0), entry(None, 0), entry(None, 0),
+    entry(None, 0), entry(None, 0), entry(None, 0), entry(None, 0),
+    // Channel Voice messages (0x80-0xE0)
+    entry(Channel, 2), // Note Off
+    entry(Channel, 2), // Note On
+    entry(Channel, 2), // Key Pressure
+    entry(Channel, 2), // Control Change
+    entry(Channel, 1), // Program Change
+    entry(Channel, 1), // Channel Pressure
+    entry(Channel, 2), // Pitch Bend
+    entry(None, 0),    // Unused (0xF0-0xFF use the entries below)
+    // System messages (0xF0-0xFF)
+    entry(SysExStart, 0), // SysEx Start
+    entry(SysCommon, 1),  // MTC Quarter Frame
+    entry(SysCommon, 2),  // Song Position Pointer
+    entry(SysCommon, 1),  // Song Select
+    entry(SysCommon, 0),  // Undefined
+    entry(SysCommon, 0),  // Undefined
+    entry(SysCommon, 0),  // Tune Request
+    entry(SysExEnd, 0),   // SysEx End
+    entry(RealTime, 0), entry(RealTime, 0), entry(RealTime, 0),
+    entry(RealTime, 0), entry(RealTime, 0), entry(RealTime, 0),
+    entry(RealTime, 0), entry(RealTime, 0),
+};
+
+// https://usb.org/sites/default/files/midi10.pdf (Table 4-1)
+const uint8_t USBMIDICodeIndexTable[16] PROGMEM = {
+    entry(None, 0),       // Miscellaneous function codes (reserved)
+    entry(None, 0),       // Cable events (reserved)
+    entry(SysCommon, 2),  // Two-byte System Common message
+    entry(SysCommon, 3),  // Three-byte System Common message
+    entry(SysExStart, 3), // SysEx starts or continues
+    entry(SysExEnd, 1),   // SysEx ends with one byte, or single-byte System
+                          // Common message
+    entry(SysExEnd, 2),   // SysEx ends with two bytes
+    entry(SysExEnd, 3),   // SysEx ends with three bytes
+    entry(Channel, 3),    // Note Off
+    entry(Channel, 3),    // Note On
+    entry(Channel, 3),    // Key Pressure
+    entry(Channel, 3),    // Control Change
+    entry(Channel, 2),    // Program Change
+    entry(Channel, 2),    // Channel Pressure
+    entry(Channel, 3),    // Pitch Bend
+    entry(RealTime, 1),   // Single byte
+};
+
+END_CS_NAMESPACE
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <AH/Arduino-Wrapper.h> // PROGMEM, pgm_read_byte_near
+#include <Settings/NamespaceSettings.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// The class of a MIDI status byte or USB MIDI Code Index Number, see
+/// @ref MIDIStatusInfo.
+enum class MIDIStatusClass : uint8_t {
+    None = 0,       ///< Data byte, or reserved Code Index Number.
+    Channel = 1,    ///< Channel Voice message.
+    SysExStart = 2, ///< Start (or continuation) of a System Exclusive message.
+    SysExEnd = 3,   ///< End of a System Exclusive message.
+    SysCommon = 4,  ///< System Common message.
+    RealTime = 5,   ///< System Real-Time message.
+};
+
+/// Properties of a MIDI status byte or USB MIDI Code Index Number, packed in a
+/// single byte so they can be looked up in a table instead of being derived
+/// by a chain of comparisons.
+/// @see    @ref getMIDIStatusInfo
+/// @see    @ref getUSBMIDIStatusInfo
+struct MIDIStatusInfo {
+    uint8_t bits;
+
+    constexpr static MIDIStatusInfo make(MIDIStatusClass cls, uint8_t length) {
+        return {uint8_t(uint8_t(cls) << 2 | length)};
+    }
+
+    /// Get the class of message.
+    MIDIStatusClass getClass() const { return MIDIStatusClass(bits >> 2); }
+    /// For status bytes, get the number of data bytes that follow the status
+    /// byte (0, 1 or 2). For Code Index Numbers, get the number of MIDI bytes
+    /// in the USB packet (1, 2 or 3).
+    uint8_t getLength() const { return bits & 0x03; }
+    /// Check whether a status byte of this class can be used as running
+    /// status.
+    bool isRunningStatus() const {
+        return getClass() == MIDIStatusClass::Channel;
+    }
+};
+
+/// Properties of all MIDI bytes, indexed by the upper nibble for data bytes
+/// and Channel Voice messages, and by 0x10 plus the lower nibble for system
+/// messages (0xF0-0xFF).
+extern const uint8_t MIDIStatusTable[32] PROGMEM;
+/// Properties of all USB MIDI Code Index Numbers.
+extern const uint8_t USBMIDICodeIndexTable[16] PROGMEM;
+
+/// Look up the properties of the given MIDI status (or data) byte.
+inline MIDIStatusInfo getMIDIStatusInfo(uint8_t status) {
+    uint8_t index = status >= 0xF0 ? status - 0xE0 : status >> 4;
+    return {pgm_read_byte_near(&MIDIStatusTable[index])};
+}
+
+/// Look up the properties of the given USB MIDI Code Index Number.
+inline MIDIStatusInfo getUSBMIDIStatusInfo(uint8_t cin) {
+    return {pgm_read_byte_near(&USBMIDICodeIndexTable[cin & 0x0F])};
+}
+
+END_CS_NAMESPACE
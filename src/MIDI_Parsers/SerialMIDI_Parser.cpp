@@ -1,4 +1,6 @@
 #include "SerialMIDI_Parser.hpp"
+#include "MIDIStatusTable.hpp"
+#include <string.h> // memcpy
 
 BEGIN_CS_NAMESPACE
 
@@ -44,6 +46,7 @@ MIDIReadEvent SerialMIDI_Parser::handleNonRealTimeStatus(uint8_t midiByte) {
             if (sysCommonCancelsRunningStatus)
                 runningHeader = 0;
             currentHeader = 0;
+            thirdByte = false;
             return MIDIReadEvent::SYSCOMMON_MESSAGE;
         }
 #if !IGNORE_SYSEX
@@ -54,6 +57,7 @@ MIDIReadEvent SerialMIDI_Parser::handleNonRealTimeStatus(uint8_t midiByte) {
             addSysExByte(uint8_t(MIDIMessageType::SysExStart));
             runningHeader = 0;
             currentHeader = midiByte;
+            thirdByte = false;
             return MIDIReadEvent::NO_MESSAGE;
         }
         // This should already have been handled by the if (untermSysEx) above.
@@ -106,89 +110,67 @@ MIDIReadEvent SerialMIDI_Parser::handleData(uint8_t midiByte) {
 
     midimsg.header = currentHeader;
 
-    // If this is the third byte of three (second data byte)
-    if (thirdByte) {
-        // If it's a channel message
-        if (midimsg.hasValidChannelMessageHeader()) {
-            midimsg.data2 = midiByte;
-            // Next byte is either a header or the first data byte of the next
-            // message, so clear the thirdByte flag
+    // The class and length of the message are looked up in a table, instead
+    // of deriving them from the header for every data byte.
+    MIDIStatusInfo info = getMIDIStatusInfo(currentHeader);
+    switch (info.getClass()) {
+        // Channel and System Common messages
+        case MIDIStatusClass::Channel: // fallthrough
+        case MIDIStatusClass::SysCommon: {
+            // If this is the third byte of three (second data byte)
+            if (thirdByte) {
+                midimsg.data2 = midiByte;
+            }
+            // If it's the second byte (first data byte) of a message with two
+            // data bytes
+            else if (info.getLength() == 2) {
+                midimsg.data1 = midiByte;
+                // We've received the second byte, expect the third byte next
+                thirdByte = true;
+                return MIDIReadEvent::NO_MESSAGE;
+            }
+            // If it's the only data byte of the message
+            else if (info.getLength() == 1) {
+                midimsg.data1 = midiByte;
+                midimsg.data2 = 0;
+            }
+            // System Common messages without data bytes can't be followed by
+            // a data byte
+            else {
+                break;
+            }
+            // The message is finished. The next byte is either a header or the
+            // first data byte of the next message, so clear the thirdByte flag
             thirdByte = false;
-            runningHeader = midimsg.header;
             currentHeader = 0;
-            return MIDIReadEvent::CHANNEL_MESSAGE;
-        }
-        // If it's a system common message
-        else if (midimsg.hasValidSystemCommonHeader()) {
-            midimsg.data2 = midiByte;
-            thirdByte = false;
+            if (info.isRunningStatus()) {
+                runningHeader = midimsg.header;
+                return MIDIReadEvent::CHANNEL_MESSAGE;
+            }
             if (sysCommonCancelsRunningStatus)
                 runningHeader = 0;
-            currentHeader = 0;
             return MIDIReadEvent::SYSCOMMON_MESSAGE;
         }
-    }
 
-    // If this is not the third byte of three, it's either the second byte
-    // (first data byte) of a channel or system common message,
-    // or a SysEx data byte
-
-    // If it's a channel message
-    else if (midimsg.hasValidChannelMessageHeader()) {
-        // If it's a channel message with two data bytes
-        if (ChannelMessage(midimsg).hasTwoDataBytes()) {
-            midimsg.data1 = midiByte;
-            // We've received the second byte, expect the third byte next
-            thirdByte = true;
-            return MIDIReadEvent::NO_MESSAGE;
-        }
-        // If it's a channel message with one data byte
-        else {
-            midimsg.data1 = midiByte;
-            midimsg.data2 = 0;
-            runningHeader = midimsg.header;
-            currentHeader = 0;
-            // The message is finished
-            return MIDIReadEvent::CHANNEL_MESSAGE;
-        }
-    }
+#if !IGNORE_SYSEX
+        // If we're receiving a SysEx message, it's a SysEx data byte
+        case MIDIStatusClass::SysExStart: {
+            // Check if the SysEx buffer has enough space to store the data
+            if (!hasSysExSpace()) {
+                storeByte(midiByte); // Remember to add it next time
+                return MIDIReadEvent::SYSEX_CHUNK;
+            }
 
-    // If it's a system common message
-    else if (midimsg.hasValidSystemCommonHeader()) {
-        // If it's a system common message with two data bytes
-        if (SysCommonMessage(midimsg).getNumberOfDataBytes() == 2) {
-            midimsg.data1 = midiByte;
-            // We've received the second byte, expect the third byte next
-            thirdByte = true;
+            addSysExByte(midiByte);
             return MIDIReadEvent::NO_MESSAGE;
         }
-        // If it's a system common message with one data byte
-        else if (SysCommonMessage(midimsg).getNumberOfDataBytes() == 1) {
-            midimsg.data1 = midiByte;
-            midimsg.data2 = 0;
-            if (sysCommonCancelsRunningStatus)
-                runningHeader = 0;
-            currentHeader = 0;
-            // The message is finished
-            return MIDIReadEvent::SYSCOMMON_MESSAGE;
-        }
-    }
-
-    // Otherwise, it's not a channel message
-
-#if !IGNORE_SYSEX
-    // If we're receiving a SysEx message, it's a SysEx data byte
-    else if (currentHeader == uint8_t(MIDIMessageType::SysExStart)) {
-        // Check if the SysEx buffer has enough space to store the data
-        if (!hasSysExSpace()) {
-            storeByte(midiByte); // Remember to add it next time
-            return MIDIReadEvent::SYSEX_CHUNK;
-        }
+#endif // IGNORE_SYSEX
 
-        addSysExByte(midiByte);
-        return MIDIReadEvent::NO_MESSAGE;
+        case MIDIStatusClass::None:     // fallthrough
+        case MIDIStatusClass::SysExEnd: // fallthrough
+        case MIDIStatusClass::RealTime: // fallthrough
+        default: break;
     }
-#endif // IGNORE_SYSEX
 
     DEBUGREF(F("Data byte after invalid header")); // LCOV_EXCL_LINE
     runningHeader = 0;                             // LCOV_EXCL_LINE
@@ -226,4 +208,141 @@ MIDIReadEvent SerialMIDI_Parser::resume() {
     return feed(midiByte);
 }
 
-END_CS_NAMESPACE
\ No newline at end of file
+// -------------------------------------------------------------------------- //
+
+namespace {
+
+/// Find the first status byte in the given buffer. Checks a full machine word
+/// at a time for bytes with the most significant bit set.
+/// @return A pointer to the first status byte, or @p end if there is none.
+const uint8_t *findStatus(const uint8_t *data, const uint8_t *end) {
+    using word_t = uintptr_t;
+    constexpr word_t msbs = word_t(~word_t(0)) / 0xFF * 0x80;
+    while (size_t(end - data) >= sizeof(word_t)) {
+        word_t word;
+        memcpy(&word, data, sizeof(word));
+        if (word & msbs)
+            break;
+        data += sizeof(word);
+    }
+    while (data != end && !MIDI_Parser::isStatus(*data))
+        ++data;
+    return data;
+}
+
+} // namespace
+
+bool SerialMIDI_Parser::pullChannelMessage(const uint8_t *&data,
+                                           const uint8_t *end) {
+    const uint8_t *p = data;
+    uint8_t header;
+    if (isStatus(*p)) {
+        // System messages and status bytes that terminate a SysEx message
+        // are handled by the byte-per-byte path.
+        if (*p >= uint8_t(MIDIMessageType::SysExStart) ||
+            currentHeader == uint8_t(MIDIMessageType::SysExStart))
+            return false;
+        header = *p++;
+    } else {
+        // Running status only applies if no other message is in progress.
+        if (currentHeader != 0 || runningHeader == 0 || thirdByte)
+            return false;
+        header = runningHeader;
+    }
+    uint8_t numDataBytes = getMIDIStatusInfo(header).getLength();
+    bool twoDataBytes = numDataBytes == 2;
+    if (end - p < numDataBytes || isStatus(p[0]) ||
+        (twoDataBytes && isStatus(p[1])))
+        return false;
+    midimsg.header = header;
+    midimsg.data1 = p[0];
+    midimsg.data2 = twoDataBytes ? p[1] : 0;
+    runningHeader = header;
+    currentHeader = 0;
+    thirdByte = false;
+    data = p + numDataBytes;
+    return true;
+}
+
+#if !IGNORE_SYSEX
+bool SerialMIDI_Parser::pullSysExView(const uint8_t *&data,
+                                      const uint8_t *end) {
+    // The message has to start here, it cannot be the continuation of a
+    // message that started in a previous buffer.
+    if (*data != uint8_t(MIDIMessageType::SysExStart) ||
+        currentHeader == uint8_t(MIDIMessageType::SysExStart))
+        return false;
+    const uint8_t *msgEnd = findStatus(data + 1, end);
+    if (msgEnd == end || *msgEnd != uint8_t(MIDIMessageType::SysExEnd))
+        return false;
+    ++msgEnd;
+    if (size_t(msgEnd - data) > 0xFFFF)
+        return false;
+    // Same state as after SysExStart, data, SysExEnd in the byte path.
+    sysexView = data;
+    sysexViewLength = msgEnd - data;
+    sysexbuffer.start();
+    sysexbuffer.end();
+    currentHeader = 0;
+    runningHeader = 0;
+    thirdByte = false;
+    data = msgEnd;
+    return true;
+}
+
+bool SerialMIDI_Parser::pullSysExData(const uint8_t *&data,
+                                      const uint8_t *end) {
+    const uint8_t *runEnd = findStatus(data, end);
+    size_t runLength = runEnd - data;
+    uint16_t spaceLeft = sysexbuffer.getSpaceLeft();
+    if (runLength <= spaceLeft) {
+        sysexbuffer.add(data, runLength);
+        data = runEnd;
+        return false;
+    }
+    // The buffer is full, remember the first byte that doesn't fit to add it
+    // to the next chunk.
+    sysexbuffer.add(data, spaceLeft);
+    data += spaceLeft;
+    storeByte(*data++);
+    return true;
+}
+#endif
+
+MIDIReadEvent SerialMIDI_Parser::pull(BufferPuller_<uint8_t> &puller) {
+    MIDIReadEvent evt = resume();
+    if (evt != MIDIReadEvent::NO_MESSAGE)
+        return evt;
+
+    const uint8_t *data = puller.begin();
+    const uint8_t *end = puller.getEnd();
+    while (data != end) {
+#if !IGNORE_SYSEX
+        if (currentHeader == uint8_t(MIDIMessageType::SysExStart)) {
+            if (pullSysExData(data, end)) {
+                evt = MIDIReadEvent::SYSEX_CHUNK;
+                break;
+            }
+            if (data == end)
+                break;
+        }
+#endif
+        if (pullChannelMessage(data, end)) {
+            evt = MIDIReadEvent::CHANNEL_MESSAGE;
+            break;
+        }
+#if !IGNORE_SYSEX
+        if (zeroCopySysEx && pullSysExView(data, end)) {
+            evt = MIDIReadEvent::SYSEX_MESSAGE;
+            break;
+        }
+#endif
+        evt = feed(*data++);
+        if (evt != MIDIReadEvent::NO_MESSAGE)
+            break;
+    }
+    puller.skipTo(data);
+    return evt;
+}
+
+END_CS_NAMESPACE
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BufferPuller.hpp"
 #include "MIDI_Parser.hpp"
 #include "SysExBuffer.hpp"
 
@@ -26,6 +27,37 @@ class SerialMIDI_Parser : public MIDI_Parser {
     template <class BytePuller>
     MIDIReadEvent pull(BytePuller &&puller);
 
+    /**
+     * @brief   Parse one incoming MIDI message from a contiguous buffer.
+     * 
+     * Produces exactly the same events as the generic @ref pull, but SysEx 
+     * data is copied to the SysEx buffer in runs instead of byte by byte, and
+     * complete channel messages (with or without running status) are parsed
+     * in a single step.
+     * 
+     * @param   puller
+     *          The buffer of MIDI bytes. The bytes that were parsed are 
+     *          removed from it.
+     * @return  The type of MIDI message available, or 
+     *          `MIDIReadEvent::NO_MESSAGE` if `puller` ran out of bytes before
+     *          a complete message was parsed.
+     */
+    MIDIReadEvent pull(BufferPuller_<uint8_t> &puller);
+    /// @copydoc pull(BufferPuller_<uint8_t> &)
+    MIDIReadEvent pull(BufferPuller_<uint8_t> &&puller) { return pull(puller); }
+
+  protected:
+    /// Parse a complete channel message at the start of the given buffer, if
+    /// there is one.
+    /// @return True if a message was parsed, false otherwise.
+    bool pullChannelMessage(const uint8_t *&data, const uint8_t *end);
+#if !IGNORE_SYSEX
+    /// Add the SysEx data bytes at the start of the given buffer to the SysEx
+    /// buffer.
+    /// @return True if the SysEx buffer is full, false otherwise.
+    bool pullSysExData(const uint8_t *&data, const uint8_t *end);
+#endif
+
   protected:
     /// Feed a new byte to the parser.
     MIDIReadEvent feed(uint8_t midibyte);
@@ -36,16 +68,42 @@ class SerialMIDI_Parser : public MIDI_Parser {
   public:
     /// Get the latest SysEx message.
     SysExMessage getSysExMessage() const {
+        if (sysexView != nullptr)
+            return {sysexView, sysexViewLength};
         return {sysexbuffer.getBuffer(), sysexbuffer.getLength()};
     }
 
+    /// Deliver SysEx messages that are entirely contained in the buffer passed
+    /// to @ref pull(BufferPuller_<uint8_t> &) without copying them to the SysEx
+    /// buffer. The message returned by @ref getSysExMessage then points into
+    /// that buffer, so the buffer must remain valid for as long as the message
+    /// is used. Messages that span multiple buffers are still copied, and are
+    /// chunked if they don't fit in the SysEx buffer.
+    void setZeroCopySysEx(bool zeroCopy) { zeroCopySysEx = zeroCopy; }
+    /// Check whether SysEx messages may point into the input buffer.
+    /// @see    @ref setZeroCopySysEx
+    bool getZeroCopySysEx() const { return zeroCopySysEx; }
+
   protected:
     void addSysExByte(uint8_t data) { sysexbuffer.add(data); }
     bool hasSysExSpace() const { return sysexbuffer.hasSpaceLeft(); }
-    void startSysEx() { sysexbuffer.start(); }
+    void startSysEx() {
+        sysexView = nullptr;
+        sysexbuffer.start();
+    }
     void endSysEx() { sysexbuffer.end(); }
+    /// Parse a complete SysEx message at the start of the given buffer without
+    /// copying it, if there is one.
+    /// @return True if a message was parsed, false otherwise.
+    bool pullSysExView(const uint8_t *&data, const uint8_t *end);
 
     SysExBuffer sysexbuffer;
+    /// Complete SysEx message in the input buffer (zero-copy mode).
+    const uint8_t *sysexView = nullptr;
+    /// Length of @ref sysexView.
+    uint16_t sysexViewLength = 0;
+    /// @see @ref setZeroCopySysEx
+    bool zeroCopySysEx = false;
 #endif
 
   protected:
@@ -59,9 +117,14 @@ class SerialMIDI_Parser : public MIDI_Parser {
     /// for example. The byte cannot be added to the buffer now, so store it to
     /// add it the next time the parser is updated.
     void storeByte(uint8_t midiByte) { storedByte = midiByte; }
+
+  public:
     /// Check whether there's a stored byte. If this is the case, this byte
-    /// should be parsed before reading a new byte.
+    /// should be parsed before reading a new byte, so the next call to
+    /// @ref pull may return a message even if no new bytes are available.
     bool hasStoredByte() const { return storedByte != 0xFF; }
+
+  protected:
     /// Get the stored byte. Afterwards, @ref hasStoredByte will return false.
     uint8_t popStoredByte() {
         uint8_t t = storedByte;
@@ -0,0 +1,100 @@
+#include "SysExArena.hpp"
+#include <AH/Debug/Debug.hpp>
+#include <string.h>
+
+BEGIN_CS_NAMESPACE
+
+uint16_t BasicSysExArena::getLimit(uint16_t start) const {
+    uint16_t limit = size;
+    for (uint8_t i = 0; i < numCables; ++i)
+        if (regions[i].receiving && regions[i].start > start &&
+            regions[i].start < limit)
+            limit = regions[i].start;
+    return limit;
+}
+
+bool BasicSysExArena::allocate(uint8_t cable) {
+    // The gap before the first message can be used entirely
+    uint16_t bestStart = 0;
+    uint16_t bestSpace = size;
+    for (uint8_t i = 0; i < numCables; ++i)
+        if (regions[i].receiving && regions[i].start < bestSpace)
+            bestSpace = regions[i].start;
+    // Other gaps are split in two, so the message before it can still grow
+    for (uint8_t i = 0; i < numCables; ++i) {
+        const Region &r = regions[i];
+        if (!r.receiving)
+            continue;
+        uint16_t used = r.start + r.length;
+        uint16_t limit = getLimit(r.start);
+        uint16_t start = used + (limit - used) / 2;
+        if (limit - start > bestSpace) {
+            bestStart = start;
+            bestSpace = limit - start;
+        }
+    }
+    if (bestSpace < MinRegionSize)
+        return false;
+    regions[cable] = {bestStart, 0, 0, true};
+    return true;
+}
+
+bool BasicSysExArena::evict(uint8_t except) {
+    uint8_t oldest = numCables;
+    uint16_t oldestAge = 0;
+    for (uint8_t i = 0; i < numCables; ++i) {
+        uint16_t age = activity - regions[i].lastActive;
+        if (i != except && regions[i].receiving &&
+            (oldest == numCables || age > oldestAge)) {
+            oldest = i;
+            oldestAge = age;
+        }
+    }
+    if (oldest == numCables)
+        return false;
+    DEBUGREF(F("SysEx: discarding message on cable ") << (oldest + 1));
+    release(oldest);
+    ++numEvicted;
+    return true;
+}
+
+void BasicSysExArena::release(uint8_t cable) {
+    usage -= regions[cable].length;
+    regions[cable].receiving = false;
+}
+
+bool BasicSysExArena::start(uint8_t cable) {
+    Region &r = regions[cable];
+    if (r.receiving) {
+        usage -= r.length;
+        r.length = 0;
+    } else {
+        while (!allocate(cable))
+            if (!evict(cable))
+                return false;
+    }
+    touch(cable);
+    return true;
+}
+
+void BasicSysExArena::end(uint8_t cable) { release(cable); }
+
+void BasicSysExArena::add(uint8_t cable, const uint8_t *data, uint16_t len) {
+    Region &r = regions[cable];
+    memcpy(pool + r.start + r.length, data, len);
+    r.length += len;
+    usage += len;
+    if (usage > peakUsage)
+        peakUsage = usage;
+    touch(cable);
+}
+
+bool BasicSysExArena::hasSpaceLeft(uint8_t cable, uint16_t amount) const {
+    const Region &r = regions[cable];
+    bool avail = r.receiving && r.length + amount <= getLimit(r.start) - r.start;
+    if (!avail)
+        DEBUG(F("SysEx: Arena full (") << amount << ')');
+    return avail;
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Memory pool for storing the System Exclusive messages that are
+ *          being received on multiple cables by a MIDI parser.
+ *
+ * Instead of reserving a fixed buffer for every cable, space is assigned to a
+ * cable when its SysEx message starts, and it is returned when the message
+ * ends. A new message gets the second half of the largest free gap in the pool,
+ * so the message before it can still grow into the first half. A message can
+ * grow until it reaches the next message or the end of the pool, so a single
+ * message can use the entire pool. If a message doesn't fit, it is delivered in
+ * chunks, like with a @ref SysExBuffer.
+ *
+ * The space of messages that are never terminated is reclaimed when another
+ * cable needs space for a new message: the message that received data least
+ * recently is discarded.
+ *
+ * @see     @ref SysExArena
+ *
+ * @ingroup MIDIParsers
+ */
+class BasicSysExArena {
+  public:
+    /// The space assigned to a single cable.
+    struct Region {
+        /// Offset of the first byte of the message in the pool.
+        uint16_t start;
+        /// Number of bytes of the message that were received so far.
+        uint16_t length;
+        /// Value of the activity counter when the cable last received data.
+        uint16_t lastActive;
+        /// Whether a message is being received on this cable.
+        bool receiving;
+    };
+
+    /// The minimum amount of space assigned to a message, enough for a single
+    /// USB MIDI packet.
+    constexpr static uint16_t MinRegionSize = 3;
+
+  protected:
+    BasicSysExArena(uint8_t *pool, uint16_t size, Region *regions,
+                    uint8_t numCables)
+        : pool(pool), size(size), regions(regions), numCables(numCables) {}
+
+  public:
+    /// Start a new SysEx message on the given cable. If a message was already
+    /// being received on this cable, it is overwritten, and its space is
+    /// reused.
+    /// @return False if no space could be assigned to the cable, true
+    ///         otherwise.
+    bool start(uint8_t cable);
+    /// Finish the current SysEx message on the given cable, and return its
+    /// space to the pool. The data remains valid until the next call to
+    /// @ref start or @ref add.
+    void end(uint8_t cable);
+    /// Add bytes to the current SysEx message on the given cable.
+    /// @pre    `hasSpaceLeft(cable, len)`
+    void add(uint8_t cable, const uint8_t *data, uint16_t len);
+    /// Add a byte to the current SysEx message on the given cable.
+    /// @pre    `hasSpaceLeft(cable, 1)`
+    void add(uint8_t cable, uint8_t data) { add(cable, &data, 1); }
+    /// Check if the message on the given cable can grow by at least `amount`
+    /// bytes.
+    bool hasSpaceLeft(uint8_t cable, uint16_t amount = 1) const;
+    /// Check if a SysEx message is being received on the given cable.
+    bool isReceiving(uint8_t cable) const { return regions[cable].receiving; }
+    /// Get a pointer to the SysEx message on the given cable.
+    const uint8_t *getBuffer(uint8_t cable) const {
+        return pool + regions[cable].start;
+    }
+    /// Get the length of the SysEx message on the given cable.
+    uint16_t getLength(uint8_t cable) const { return regions[cable].length; }
+
+    /// @name   Statistics
+    /// @{
+
+    /// Get the total size of the pool in bytes.
+    uint16_t getSize() const { return size; }
+    /// Get the number of bytes that are currently used by all messages.
+    uint16_t getUsage() const { return usage; }
+    /// Get the largest number of bytes that were in use at the same time.
+    uint16_t getPeakUsage() const { return peakUsage; }
+    /// Reset the peak usage to the current usage.
+    void resetPeakUsage() { peakUsage = usage; }
+    /// Get the number of messages that were discarded to make room for other
+    /// messages.
+    uint16_t getNumberOfEvicted() const { return numEvicted; }
+
+    /// @}
+
+  private:
+    /// Get the start of the first message after the given one, or the size of
+    /// the pool if there is none. The message of the given cable can grow up
+    /// to this point.
+    uint16_t getLimit(uint16_t start) const;
+    /// Assign the largest available space to the given cable.
+    bool allocate(uint8_t cable);
+    /// Discard the message that received data least recently (except the
+    /// message of the given cable).
+    bool evict(uint8_t except);
+    /// Return the space of the given cable to the pool.
+    void release(uint8_t cable);
+    /// Mark the given cable as active.
+    void touch(uint8_t cable) { regions[cable].lastActive = ++activity; }
+
+  private:
+    uint8_t *pool;
+    uint16_t size;
+    Region *regions;
+    uint8_t numCables;
+    uint16_t activity = 0;
+    uint16_t usage = 0;
+    uint16_t peakUsage = 0;
+    uint16_t numEvicted = 0;
+};
+
+/**
+ * @brief   Memory pool for storing the System Exclusive messages that are
+ *          being received on multiple cables by a MIDI parser.
+ *
+ * @tparam  Size
+ *          The size of the pool in bytes. This is also the maximum size of a
+ *          single message before it is split up into chunks.
+ * @tparam  NumCables
+ *          The number of cables that can receive messages.
+ *
+ * @copydetails BasicSysExArena
+ */
+template <uint16_t Size, uint8_t NumCables>
+class SysExArena : public BasicSysExArena {
+  public:
+    SysExArena() : BasicSysExArena(storage, Size, cableRegions, NumCables) {}
+
+  private:
+    uint8_t storage[Size];
+    Region cableRegions[NumCables] {};
+};
+
+END_CS_NAMESPACE
@@ -15,7 +15,7 @@ void SysExBuffer::add(uint8_t data) {
     ++length;
 }
 
-void SysExBuffer::add(const uint8_t *data, uint8_t len) {
+void SysExBuffer::add(const uint8_t *data, uint16_t len) {
     memcpy(buffer + length, data, len);
     length += len;
 }
@@ -27,6 +27,10 @@ bool SysExBuffer::hasSpaceLeft(uint8_t amount) const {
     return avail;
 }
 
+uint16_t SysExBuffer::getSpaceLeft() const {
+    return SYSEX_BUFFER_SIZE - length;
+}
+
 bool SysExBuffer::isReceiving() const { return receiving; }
 
 const uint8_t *SysExBuffer::getBuffer() const { return buffer; }
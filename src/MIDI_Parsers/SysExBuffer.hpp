@@ -24,9 +24,11 @@ class SysExBuffer {
     /// Add a byte to the current SysEx message.
     void add(uint8_t data);
     /// Add multiple bytes to the current SysEx message.
-    void add(const uint8_t *data, uint8_t len);
+    void add(const uint8_t *data, uint16_t len);
     /// Check if the buffer has at least `amount` bytes of free space available.
     bool hasSpaceLeft(uint8_t amount = 1) const;
+    /// Get the number of bytes that can still be added to the buffer.
+    uint16_t getSpaceLeft() const;
     /// Check if the buffer is receiving a SysEx message.
     bool isReceiving() const;
     /// Get a pointer to the buffer.
@@ -1,4 +1,5 @@
 #include "USBMIDI_Parser.hpp"
+#include "MIDIStatusTable.hpp"
 #include <Settings/SettingsWrapper.hpp>
 
 BEGIN_CS_NAMESPACE
@@ -17,8 +18,11 @@ MIDIReadEvent USBMIDI_Parser::handleSysExStartCont(MIDIUSBPacket_t packet,
 #if !IGNORE_SYSEX
     // If this is a SysEx start packet
     if (packet[1] == uint8_t(MIDIMessageType::SysExStart)) {
-        startSysEx(cable); // start a new message
-                           // (overwrites previous unfinished message)
+        // start a new message (overwrites previous unfinished message)
+        if (!startSysEx(cable)) {
+            DEBUGREF(F("No space for SysEx message"));
+            return MIDIReadEvent::NO_MESSAGE; // ignore the data
+        }
     }
     // If we haven't received a SysExStart
     else if (!receivingSysEx(cable)) {
@@ -52,8 +56,11 @@ MIDIReadEvent USBMIDI_Parser::handleSysExEnd(MIDIUSBPacket_t packet,
     // This could be the a very short SysEx message that starts and ends with
     // this packet
     if (packet[1] == uint8_t(MIDIMessageType::SysExStart)) {
-        startSysEx(cable); // start a new message
-                           // (overwrites previous unfinished message)
+        // start a new message (overwrites previous unfinished message)
+        if (!startSysEx(cable)) {
+            DEBUGREF(F("No space for SysEx message"));
+            return MIDIReadEvent::NO_MESSAGE; // ignore the data
+        }
     }
     // If we haven't received a SysExStart
     else if (!receivingSysEx(cable)) {
@@ -142,31 +149,29 @@ MIDIReadEvent USBMIDI_Parser::feed(MIDIUSBPacket_t packet) {
 
     // MIDI USB cable number and code index number
     Cable cable = Cable(packet[0] >> 4);
-    MIDICodeIndexNumber CIN = MIDICodeIndexNumber(packet[0] & 0xF);
+    MIDIStatusInfo info = getUSBMIDIStatusInfo(packet[0]);
 
     // Ignore all messages for cables that we don't have
     if (cable.getRaw() >= USB_MIDI_NUMBER_OF_CABLES)
         return MIDIReadEvent::NO_MESSAGE; // LCOV_EXCL_LINE
 
-    using M = MIDICodeIndexNumber;
-    switch (CIN) {
-        case M::MiscFunctionCodes: break; // LCOV_EXCL_LINE
-        case M::CableEvents: break;       // LCOV_EXCL_LINE
-        case M::SystemCommon2B:           // fallthrough
-        case M::SystemCommon3B: return handleSysCommon(packet, cable);
-        case M::SysExStartCont: return handleSysExStartCont(packet, cable);
-        case M::SysExEnd1B: return handleSysExEnd<1>(packet, cable);
-        case M::SysExEnd2B: return handleSysExEnd<2>(packet, cable);
-        case M::SysExEnd3B: return handleSysExEnd<3>(packet, cable);
-        case M::NoteOff:         // fallthrough
-        case M::NoteOn:          // fallthrough
-        case M::KeyPressure:     // fallthrough
-        case M::ControlChange:   // fallthrough
-        case M::ProgramChange:   // fallthrough
-        case M::ChannelPressure: // fallthrough
-        case M::PitchBend: return handleChannelMessage(packet, cable);
-        case M::SingleByte: return handleSingleByte(packet, cable);
-        default: break; // LCOV_EXCL_LINE
+    switch (info.getClass()) {
+        case MIDIStatusClass::Channel:
+            return handleChannelMessage(packet, cable);
+        case MIDIStatusClass::SysCommon: return handleSysCommon(packet, cable);
+        case MIDIStatusClass::SysExStart:
+            return handleSysExStartCont(packet, cable);
+        case MIDIStatusClass::SysExEnd:
+            switch (info.getLength()) {
+                case 1: return handleSysExEnd<1>(packet, cable);
+                case 2: return handleSysExEnd<2>(packet, cable);
+                case 3: return handleSysExEnd<3>(packet, cable);
+                default: break; // LCOV_EXCL_LINE
+            }
+            break;
+        case MIDIStatusClass::RealTime: return handleSingleByte(packet, cable);
+        case MIDIStatusClass::None: break; // LCOV_EXCL_LINE
+        default: break;                    // LCOV_EXCL_LINE
     }
 
     return MIDIReadEvent::NO_MESSAGE; // LCOV_EXCL_LINE
@@ -1,5 +1,5 @@
 #include "MIDI_Parser.hpp"
-#include "SysExBuffer.hpp"
+#include "SysExArena.hpp"
 #include <AH/Containers/Array.hpp>
 
 #ifdef MIDI_NUM_CABLES
@@ -23,12 +23,23 @@ BEGIN_CS_NAMESPACE
 /**
  * @brief   Parser for MIDI over USB packets.
  * 
+ * The System Exclusive messages of all cables are stored in a single
+ * @ref SysExArena of @ref USB_SYSEX_ARENA_SIZE bytes.
+ * 
  * @ingroup MIDIParsers
  */
 class USBMIDI_Parser : public MIDI_Parser {
   public:
     using MIDIUSBPacket_t = AH::Array<uint8_t, 4>;
 
+#if !IGNORE_SYSEX
+    /// The size of the memory shared by the SysEx messages of all cables.
+    constexpr static uint16_t SysExArenaSize =
+        USB_SYSEX_ARENA_SIZE != 0 ? USB_SYSEX_ARENA_SIZE
+        : USB_MIDI_NUMBER_OF_CABLES > 1 ? 2 * SYSEX_BUFFER_SIZE
+                                        : SYSEX_BUFFER_SIZE;
+#endif
+
     /**
      * @brief   Parse one incoming MIDI message.
      * @param   puller
@@ -51,11 +62,16 @@ class USBMIDI_Parser : public MIDI_Parser {
     /// Get the latest SysEx message.
     SysExMessage getSysExMessage() const {
         return {
-            sysexbuffers[activeCable.getRaw()].getBuffer(),
-            sysexbuffers[activeCable.getRaw()].getLength(),
+            sysexarena.getBuffer(activeCable.getRaw()),
+            sysexarena.getLength(activeCable.getRaw()),
             activeCable,
         };
     }
+    /// Get the memory that stores the SysEx messages of all cables, e.g. to
+    /// inspect its peak usage.
+    const BasicSysExArena &getSysExArena() const { return sysexarena; }
+    /// @copydoc getSysExArena
+    BasicSysExArena &getSysExArena() { return sysexarena; }
 #endif
 
   protected:
@@ -68,23 +84,23 @@ class USBMIDI_Parser : public MIDI_Parser {
 
   protected:
 #if !IGNORE_SYSEX
-    void startSysEx(Cable cable) { sysexbuffers[cable.getRaw()].start(); }
+    bool startSysEx(Cable cable) { return sysexarena.start(cable.getRaw()); }
     void endSysEx(Cable cable) {
-        sysexbuffers[cable.getRaw()].end();
+        sysexarena.end(cable.getRaw());
         activeCable = cable;
     }
     void endSysExChunk(Cable cable) { activeCable = cable; }
     bool hasSysExSpace(Cable cable, uint8_t amount) const {
-        return sysexbuffers[cable.getRaw()].hasSpaceLeft(amount);
+        return sysexarena.hasSpaceLeft(cable.getRaw(), amount);
     }
     void addSysExByte(Cable cable, uint8_t data) {
-        sysexbuffers[cable.getRaw()].add(data);
+        sysexarena.add(cable.getRaw(), data);
     }
     void addSysExBytes(Cable cable, const uint8_t *data, uint8_t len) {
-        sysexbuffers[cable.getRaw()].add(data, len);
+        sysexarena.add(cable.getRaw(), data, len);
     }
     bool receivingSysEx(Cable cable) const {
-        return sysexbuffers[cable.getRaw()].isReceiving();
+        return sysexarena.isReceiving(cable.getRaw());
     }
 
     void storePacket(MIDIUSBPacket_t packet) { storedPacket = packet; }
@@ -98,7 +114,7 @@ class USBMIDI_Parser : public MIDI_Parser {
     Cable activeCable = Cable_1;
 
   private:
-    SysExBuffer sysexbuffers[USB_MIDI_NUMBER_OF_CABLES] = {};
+    SysExArena<SysExArenaSize, USB_MIDI_NUMBER_OF_CABLES> sysexarena;
     MIDIUSBPacket_t storedPacket = {{ 0x00 }};
 #endif
 };
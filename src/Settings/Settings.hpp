@@ -50,6 +50,12 @@ constexpr uint16_t SYSEX_BUFFER_SIZE = 128;
 /// Timeout in milliseconds to wait for a SysEx chunk to complete.
 constexpr unsigned long SYSEX_CHUNK_TIMEOUT = 500;
 
+/// The total size of the memory that is shared by the SysEx messages of all
+/// cables of a MIDI over USB interface. A single message can use all of it.
+/// If set to zero, it defaults to @ref SYSEX_BUFFER_SIZE for a single cable,
+/// and to twice that value for multiple cables.
+constexpr uint16_t USB_SYSEX_ARENA_SIZE = 0;
+
 /// The baud rate to use for Hairless MIDI.
 constexpr unsigned long HAIRLESS_BAUD = 115200;
 
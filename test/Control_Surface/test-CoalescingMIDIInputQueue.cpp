@@ -0,0 +1,170 @@
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Constants/Control_Change.hpp>
+#include <MIDI_Inputs/NoteCCKPValue.hpp>
+#include <MIDI_Interfaces/SerialMIDI_Interface.hpp>
+#include <TestStream.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using msgvec = std::vector<ChannelMessage>;
+
+static msgvec popAll(BasicCoalescingMIDIInputQueue &queue) {
+    msgvec result;
+    ChannelMessage msg {0, 0, 0};
+    while (queue.pop(msg))
+        result.push_back(msg);
+    return result;
+}
+
+TEST(CoalescingMIDIInputQueue, ccLastValueWins) {
+    CoalescingMIDIInputQueue<16> queue;
+    EXPECT_TRUE(queue.push({0xB0, 0x10, 0x01}));
+    EXPECT_TRUE(queue.push({0xB0, 0x11, 0x02}));
+    EXPECT_TRUE(queue.push({0xB0, 0x10, 0x03}));
+    EXPECT_TRUE(queue.push({0xB1, 0x10, 0x04}));
+    EXPECT_TRUE(queue.push({0xB0, 0x10, 0x05, Cable_2}));
+    EXPECT_TRUE(queue.push({0xB0, 0x10, 0x06}));
+    msgvec expected {
+        {0xB0, 0x10, 0x06},
+        {0xB0, 0x11, 0x02},
+        {0xB1, 0x10, 0x04},
+        {0xB0, 0x10, 0x05, Cable_2},
+    };
+    EXPECT_EQ(popAll(queue), expected);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.getNumberOfPushed(), 6u);
+    EXPECT_EQ(queue.getNumberOfCoalesced(), 2u);
+    queue.resetCounters();
+    EXPECT_EQ(queue.getNumberOfPushed(), 0u);
+    EXPECT_EQ(queue.getNumberOfCoalesced(), 0u);
+}
+
+TEST(CoalescingMIDIInputQueue, notesAndProgramChangesAreKept) {
+    CoalescingMIDIInputQueue<16> queue;
+    msgvec input {
+        {0x90, 0x3C, 0x7F}, {0x80, 0x3C, 0x7F}, {0x90, 0x3C, 0x7F},
+        {0xC0, 0x01, 0x00}, {0xC0, 0x02, 0x00},
+    };
+    for (auto msg : input)
+        EXPECT_TRUE(queue.push(msg));
+    EXPECT_EQ(popAll(queue), input);
+    EXPECT_EQ(queue.getNumberOfCoalesced(), 0u);
+}
+
+TEST(CoalescingMIDIInputQueue, orderDependentCCsAreKept) {
+    CoalescingMIDIInputQueue<16> queue;
+    msgvec input {
+        {0xB0, MIDI_CC::Bank_Select, 0x01},
+        {0xB0, MIDI_CC::Bank_Select, 0x02},
+        {0xB0, MIDI_CC::RPN_MSB, 0x00},
+        {0xB0, MIDI_CC::RPN_LSB, 0x00},
+        {0xB0, MIDI_CC::Data_Entry_MSB, 0x0C},
+        {0xB0, MIDI_CC::RPN_MSB, 0x7F},
+        {0xB0, MIDI_CC::RPN_LSB, 0x7F},
+        {0xB0, MIDI_CC::Data_Entry_MSB, 0x0C},
+        {0xB0, MIDI_CC::All_Notes_Off, 0x00},
+        {0xB0, MIDI_CC::All_Notes_Off, 0x00},
+    };
+    for (auto msg : input)
+        EXPECT_TRUE(queue.push(msg));
+    EXPECT_EQ(popAll(queue), input);
+}
+
+TEST(CoalescingMIDIInputQueue, pitchBendAndPressure) {
+    CoalescingMIDIInputQueue<16> queue;
+    queue.push({0xE0, 0x00, 0x10});
+    queue.push({0xA0, 0x3C, 0x10});
+    queue.push({0xA0, 0x3D, 0x11});
+    queue.push({0xE0, 0x00, 0x20});
+    queue.push({0xA0, 0x3C, 0x12});
+    msgvec expected {
+        {0xE0, 0x00, 0x20},
+        {0xA0, 0x3C, 0x12},
+        {0xA0, 0x3D, 0x11},
+    };
+    EXPECT_EQ(popAll(queue), expected);
+}
+
+TEST(CoalescingMIDIInputQueue, vuTracksAreKeptApart) {
+    CoalescingMIDIInputQueue<16> queue;
+    queue.push({0xD0, 0x05, 0x00}); // track 1, level 5
+    queue.push({0xD0, 0x13, 0x00}); // track 2, level 3
+    queue.push({0xD0, 0x0E, 0x00}); // track 1, set overload
+    queue.push({0xD0, 0x07, 0x00}); // track 1, level 7
+    queue.push({0xD0, 0x14, 0x00}); // track 2, level 4
+    msgvec expected {
+        {0xD0, 0x07, 0x00},
+        {0xD0, 0x14, 0x00},
+        {0xD0, 0x0E, 0x00},
+    };
+    EXPECT_EQ(popAll(queue), expected);
+}
+
+TEST(CoalescingMIDIInputQueue, fullQueue) {
+    CoalescingMIDIInputQueue<3> queue;
+    EXPECT_TRUE(queue.push({0xB0, 0x10, 0x01}));
+    EXPECT_TRUE(queue.push({0x90, 0x10, 0x01}));
+    EXPECT_TRUE(queue.push({0xB0, 0x11, 0x01}));
+    // Replacing the first message doesn't need any room
+    EXPECT_TRUE(queue.push({0xB0, 0x10, 0x02}));
+    EXPECT_FALSE(queue.push({0x90, 0x11, 0x01}));
+    ChannelMessage msg {0, 0, 0};
+    EXPECT_TRUE(queue.pop(msg));
+    EXPECT_EQ(msg, (ChannelMessage {0xB0, 0x10, 0x02}));
+    // Popping a message makes room
+    EXPECT_TRUE(queue.push({0x90, 0x11, 0x01}));
+    msgvec expected {
+        {0x90, 0x10, 0x01},
+        {0xB0, 0x11, 0x01},
+        {0x90, 0x11, 0x01},
+    };
+    EXPECT_EQ(popAll(queue), expected);
+}
+
+TEST(CoalescingMIDIInputQueue, ccNotReorderedWithNotes) {
+    CoalescingMIDIInputQueue<8> queue;
+    queue.push({0xB0, 0x07, 0x10}); // volume
+    queue.push({0x90, 0x3C, 0x7F}); // note on
+    queue.push({0xB0, 0x07, 0x20}); // volume
+    msgvec expected {
+        {0xB0, 0x07, 0x20},
+        {0x90, 0x3C, 0x7F},
+    };
+    EXPECT_EQ(popAll(queue), expected);
+    EXPECT_EQ(queue.getNumberOfCoalesced(), 1u);
+}
+
+static msgvec callbackMessages;
+
+TEST(CoalescingMIDIInputQueue, controlSurface) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    Control_Surface.connectDefaultMIDI_Interface();
+    CoalescingMIDIInputQueue<8> queue;
+    Control_Surface.setInputQueue(&queue);
+    callbackMessages.clear();
+    Control_Surface.setMIDIInputCallbacks(
+        [](ChannelMessage msg) {
+            callbackMessages.push_back(msg);
+            return false;
+        },
+        nullptr, nullptr, nullptr);
+    CCValue cc {{0x10, Channel_1}};
+
+    for (uint8_t b : {0xB0, 0x10, 0x01, 0xB0, 0x11, 0x02, 0xB0, 0x10, 0x03})
+        stream.toRead.push(b);
+    Control_Surface.updateMidiInput();
+    msgvec expected {
+        {0xB0, 0x10, 0x03},
+        {0xB0, 0x11, 0x02},
+    };
+    EXPECT_EQ(callbackMessages, expected);
+    EXPECT_EQ(cc.getValue(), 0x03);
+    EXPECT_TRUE(queue.empty());
+
+    Control_Surface.setMIDIInputCallbacks(nullptr, nullptr, nullptr, nullptr);
+    Control_Surface.setInputQueue(nullptr);
+}
@@ -0,0 +1,140 @@
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Constants/Control_Change.hpp>
+#include <MIDI_Interfaces/SerialMIDI_Interface.hpp>
+#include <TestStream.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+TEST(MIDIOutputValueCache, repeatsAreSuppressed) {
+    MIDIOutputValueCache<64> cache;
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}));
+    EXPECT_FALSE(cache.shouldSend({0xB0, 0x10, 0x01}));
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x02}));
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x11, 0x02}));
+    EXPECT_TRUE(cache.shouldSend({0xB1, 0x10, 0x02}));
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x02, Cable_2}));
+    EXPECT_FALSE(cache.shouldSend({0xB0, 0x10, 0x02}));
+    EXPECT_FALSE(cache.shouldSend({0xB0, 0x11, 0x02}));
+    EXPECT_EQ(cache.getNumberOfChecked(), 8u);
+    EXPECT_EQ(cache.getNumberOfSuppressed(), 3u);
+    cache.resetCounters();
+    EXPECT_EQ(cache.getNumberOfChecked(), 0u);
+    EXPECT_EQ(cache.getNumberOfSuppressed(), 0u);
+}
+
+TEST(MIDIOutputValueCache, notes) {
+    MIDIOutputValueCache<64> cache;
+    EXPECT_TRUE(cache.shouldSend({0x90, 0x3C, 0x7F}));
+    EXPECT_FALSE(cache.shouldSend({0x90, 0x3C, 0x7F}));
+    EXPECT_TRUE(cache.shouldSend({0x80, 0x3C, 0x7F}));
+    EXPECT_FALSE(cache.shouldSend({0x80, 0x3C, 0x7F}));
+    // Note On after Note Off for the same note is never dropped
+    EXPECT_TRUE(cache.shouldSend({0x90, 0x3C, 0x7F}));
+    EXPECT_TRUE(cache.shouldSend({0x90, 0x3D, 0x7F}));
+}
+
+TEST(MIDIOutputValueCache, pitchBendAndPressure) {
+    MIDIOutputValueCache<64> cache;
+    EXPECT_TRUE(cache.shouldSend({0xE0, 0x00, 0x40}));
+    EXPECT_TRUE(cache.shouldSend({0xE0, 0x01, 0x40}));
+    EXPECT_FALSE(cache.shouldSend({0xE0, 0x01, 0x40}));
+    EXPECT_TRUE(cache.shouldSend({0xD0, 0x10, 0x00}));
+    EXPECT_FALSE(cache.shouldSend({0xD0, 0x10, 0x00}));
+    EXPECT_TRUE(cache.shouldSend({0xA0, 0x3C, 0x10}));
+    EXPECT_TRUE(cache.shouldSend({0xA0, 0x3D, 0x10}));
+    EXPECT_FALSE(cache.shouldSend({0xA0, 0x3C, 0x10}));
+}
+
+TEST(MIDIOutputValueCache, orderDependentMessagesAreKept) {
+    MIDIOutputValueCache<64> cache;
+    std::vector<ChannelMessage> input {
+        {0xC0, 0x01, 0x00},
+        {0xB0, MIDI_CC::Bank_Select, 0x01},
+        {0xB0, MIDI_CC::RPN_LSB, 0x00},
+        {0xB0, MIDI_CC::Data_Entry_MSB, 0x0C},
+        {0xB0, MIDI_CC::All_Notes_Off, 0x00},
+    };
+    for (int i = 0; i < 2; ++i)
+        for (auto msg : input)
+            EXPECT_TRUE(cache.shouldSend(msg));
+    EXPECT_EQ(cache.getNumberOfChecked(), 0u);
+}
+
+TEST(MIDIOutputValueCache, window) {
+    MIDIOutputValueCache<64> cache;
+    cache.setWindow(100);
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}, 0xFFFFFFDC));
+    EXPECT_FALSE(cache.shouldSend({0xB0, 0x10, 0x01}, 0xFFFFFFFF));
+    EXPECT_FALSE(cache.shouldSend({0xB0, 0x10, 0x01}, 63)); // wraps around
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}, 64));
+    EXPECT_FALSE(cache.shouldSend({0xB0, 0x10, 0x01}, 163));
+    // Not suppressed after a multiple of 65.536 s, the times are 32-bit
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}, 64 + 65536));
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}, 64 + 2 * 65536));
+}
+
+TEST(MIDIOutputValueCache, bypassAndInvalidate) {
+    MIDIOutputValueCache<64> cache;
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}));
+    {
+        BasicMIDIOutputValueCache::ScopedBypass bypass {cache};
+        EXPECT_TRUE(cache.isBypassed());
+        EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}));
+        EXPECT_TRUE(cache.shouldSend({0xB0, 0x11, 0x01}));
+    }
+    EXPECT_FALSE(cache.isBypassed());
+    EXPECT_FALSE(cache.shouldSend({0xB0, 0x11, 0x01}));
+    cache.invalidate({0xB0, 0x11, 0x7F});
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x11, 0x01}));
+    cache.clear();
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x10, 0x01}));
+    EXPECT_TRUE(cache.shouldSend({0xB0, 0x11, 0x01}));
+}
+
+TEST(MIDIOutputValueCache, collisions) {
+    MIDIOutputValueCache<4> cache;
+    // More addresses than entries: a message may only be dropped if it repeats
+    // the last value that was sent to its address
+    uint8_t lastSent[16] {};
+    std::fill(std::begin(lastSent), std::end(lastSent), 0xFF);
+    for (int i = 0; i < 128; ++i) {
+        uint8_t cc = (i / 2 * 7) % 16, value = (i / 16) % 2;
+        if (cache.shouldSend({0xB0, uint8_t(0x10 + cc), value}))
+            lastSent[cc] = value;
+        else
+            EXPECT_EQ(lastSent[cc], value) << i;
+    }
+    EXPECT_EQ(cache.getNumberOfChecked(), 128u);
+    // Immediate repeats are always dropped
+    EXPECT_GE(cache.getNumberOfSuppressed(), 64u);
+}
+
+TEST(MIDIOutputValueCache, controlSurface) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    Control_Surface.connectDefaultMIDI_Interface();
+    MIDIOutputValueCache<32> cache;
+    Control_Surface.setOutputCache(&cache);
+
+    Control_Surface.sendControlChange({0x10, Channel_1}, 0x01);
+    Control_Surface.sendControlChange({0x10, Channel_1}, 0x01);
+    Control_Surface.sendControlChange({0x10, Channel_1}, 0x02);
+    // An incoming message for the same address invalidates the cached value
+    for (uint8_t b : {0xB0, 0x10, 0x05})
+        stream.toRead.push(b);
+    Control_Surface.updateMidiInput();
+    Control_Surface.sendControlChange({0x10, Channel_1}, 0x02);
+    Control_Surface.sendControlChange({0x10, Channel_1}, 0x02);
+    std::vector<uint8_t> expected {
+        0xB0, 0x10, 0x01, 0xB0, 0x10, 0x02, 0xB0, 0x10, 0x02,
+    };
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(cache.getNumberOfSuppressed(), 2u);
+
+    Control_Surface.setOutputCache(nullptr);
+}
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+
+#include <Banks/Bank.hpp>
+#include <MIDI_Inputs/MCU/VU.hpp>
+#include <MIDI_Inputs/NoteCCKPRange.hpp>
+#include <MIDI_Inputs/NoteCCKPValue.hpp>
+#include <MIDI_Inputs/PBValue.hpp>
+
+using ::testing::Return;
+
+USING_CS_NAMESPACE;
+
+TEST(MIDIInputElementIndex, singleAddresses) {
+    CCValue a {{0x10, Channel_1}};
+    CCValue b {{0x11, Channel_1}};
+    CCValue c {{0x10, Channel_2, Cable_3}};
+    MIDIInputElementCC::buildIndex();
+    auto &index = MIDIInputElementCC::getIndex();
+    EXPECT_TRUE(index.isValid());
+    EXPECT_EQ(index.getNumberOfEntries(), 3);
+    EXPECT_EQ(index.getNumberOfUnindexed(), 0);
+
+    EXPECT_TRUE(MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x11, 0x22}));
+    EXPECT_TRUE(MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_2, 0x10, 0x33, Cable_3}));
+    EXPECT_FALSE(MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_2, 0x10, 0x44, Cable_1}));
+    EXPECT_FALSE(MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x12, 0x55}));
+    EXPECT_EQ(a.getValue(), 0x00);
+    EXPECT_EQ(b.getValue(), 0x22);
+    EXPECT_EQ(c.getValue(), 0x33);
+
+    MIDIInputElementCC::clearIndex();
+    EXPECT_FALSE(index.isValid());
+}
+
+TEST(MIDIInputElementIndex, firstMatchHasPriority) {
+    NoteValue a {{0x3C, Channel_1}};
+    NoteValue b {{0x3C, Channel_1}};
+    MIDIInputElementNote::buildIndex();
+
+    MIDIInputElementNote::updateAllWith(
+        {MIDIMessageType::NoteOn, Channel_1, 0x3C, 0x7F});
+    EXPECT_EQ(a.getValue(), 0x7F);
+    EXPECT_EQ(b.getValue(), 0x00);
+
+    MIDIInputElementNote::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, range) {
+    CCRange<8> range {{0x20, Channel_4}};
+    MIDIInputElementCC::buildIndex();
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfEntries(), 8);
+
+    MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_4, 0x27, 0x12});
+    EXPECT_FALSE(MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_4, 0x28, 0x13}));
+    EXPECT_EQ(range.getValue(7), 0x12);
+
+    MIDIInputElementCC::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, rangeClippedToValidAddresses) {
+    CCRange<16> range {{0x78, Channel_1}};
+    MIDIInputElementCC::buildIndex();
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfEntries(), 8);
+    MIDIInputElementCC::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, bankableChangeAddress) {
+    Bank<4> bank(4);
+    Bankable::CCValue<4> value {bank, {0x10, Channel_1}};
+    MIDIInputElementCC::buildIndex();
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfEntries(), 4);
+
+    MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x18, 0x42});
+    EXPECT_FALSE(MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x19, 0x43}));
+    EXPECT_EQ(value.getValue(2), 0x42);
+
+    MIDIInputElementCC::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, bankableRangeChangeChannel) {
+    Bank<3> bank(2);
+    Bankable::NoteRange<3, 4> range {{bank, ChangeChannel}, {0x10, Channel_5}};
+    MIDIInputElementNote::buildIndex();
+    EXPECT_EQ(MIDIInputElementNote::getIndex().getNumberOfEntries(), 3 * 4);
+
+    MIDIInputElementNote::updateAllWith(
+        {MIDIMessageType::NoteOn, Channel_9, 0x12, 0x42});
+    EXPECT_EQ(range.getValue(2, 2), 0x42);
+
+    MIDIInputElementNote::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, channelPressureVUDeduplicated) {
+    MCU::VU vus[] {{1, Channel_1}, {2, Channel_1}, {3, Channel_2}};
+    MIDIInputElementCP::buildIndex();
+    // The track number is not part of the key, so each VU meter has a single
+    // entry for its channel.
+    EXPECT_EQ(MIDIInputElementCP::getIndex().getNumberOfEntries(), 3);
+
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .WillRepeatedly(Return(0));
+    MIDIInputElementCP::updateAllWith(
+        {MIDIMessageType::ChannelPressure, Channel_1, 0x1A});
+    MIDIInputElementCP::updateAllWith(
+        {MIDIMessageType::ChannelPressure, Channel_2, 0x25});
+    EXPECT_EQ(vus[0].getValue(), 0x0);
+    EXPECT_EQ(vus[1].getValue(), 0xA);
+    EXPECT_EQ(vus[2].getValue(), 0x5);
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    MIDIInputElementCP::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, pitchBend) {
+    PBValue a {Channel_3};
+    PBValue b {Channel_4};
+    MIDIInputElementPB::buildIndex();
+    EXPECT_EQ(MIDIInputElementPB::getIndex().getNumberOfEntries(), 2);
+
+    MIDIInputElementPB::updateAllWith(
+        {MIDIMessageType::PitchBend, Channel_4, 0x7F, 0x7F});
+    EXPECT_EQ(a.getValue(), 0);
+    EXPECT_EQ(b.getValue(), 16383);
+
+    MIDIInputElementPB::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, unindexedElements) {
+    struct Custom : MIDIInputElementCC {
+        bool updateWith(ChannelMessage msg) override {
+            last = msg.data2;
+            return true;
+        }
+        uint8_t last = 0xFF;
+    } custom;
+    CCValue value {{0x10, Channel_1}};
+    MIDIInputElementCC::buildIndex();
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfEntries(), 1);
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfUnindexed(), 1);
+
+    // Indexed elements are tried first
+    MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x10, 0x11});
+    EXPECT_EQ(value.getValue(), 0x11);
+    EXPECT_EQ(custom.last, 0xFF);
+    MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x20, 0x12});
+    EXPECT_EQ(custom.last, 0x12);
+
+    MIDIInputElementCC::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, disabledElementsAreSkipped) {
+    CCValue a {{0x10, Channel_1}};
+    CCValue b {{0x10, Channel_1}};
+    MIDIInputElementCC::buildIndex();
+    a.disable();
+
+    MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x10, 0x11});
+    EXPECT_EQ(a.getValue(), 0x00);
+    EXPECT_EQ(b.getValue(), 0x11);
+
+    a.enable();
+    MIDIInputElementCC::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, destructionInvalidates) {
+    CCValue a {{0x10, Channel_1}};
+    {
+        CCValue b {{0x11, Channel_1}};
+        MIDIInputElementCC::buildIndex();
+        EXPECT_TRUE(MIDIInputElementCC::getIndex().isValid());
+    }
+    EXPECT_FALSE(MIDIInputElementCC::getIndex().isValid());
+    EXPECT_TRUE(MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x10, 0x11}));
+    EXPECT_EQ(a.getValue(), 0x11);
+
+    MIDIInputElementCC::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, manyElements) {
+    std::vector<CCValue> values;
+    values.reserve(16 * 128);
+    for (uint8_t c = 0; c < 16; ++c)
+        for (uint8_t a = 0; a < 128; ++a)
+            values.emplace_back(MIDIAddress {a, Channel(c)});
+    MIDIInputElementCC::buildIndex();
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfEntries(), 16 * 128);
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfBuckets(), 16 * 128);
+
+    for (uint8_t c = 0; c < 16; ++c)
+        for (uint8_t a = 0; a < 128; ++a)
+            EXPECT_TRUE(MIDIInputElementCC::updateAllWith(
+                {MIDIMessageType::ControlChange, Channel(c), a, uint8_t(c)}));
+    for (uint8_t c = 0; c < 16; ++c)
+        for (uint8_t a = 0; a < 128; ++a)
+            EXPECT_EQ(values[c * 128 + a].getValue(), c);
+
+    MIDIInputElementCC::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, allMatchesDelivery) {
+    NoteValue a {{0x3C, Channel_1}};
+    NoteRange<4> b {{0x3A, Channel_1}};
+    NoteValue c {{0x3D, Channel_1}};
+    MIDIInputElementNote::buildIndex(MIDIInputDelivery::AllMatches);
+    EXPECT_EQ(MIDIInputElementNote::getIndex().getDelivery(),
+              MIDIInputDelivery::AllMatches);
+
+    EXPECT_TRUE(MIDIInputElementNote::updateAllWith(
+        {MIDIMessageType::NoteOn, Channel_1, 0x3C, 0x7F}));
+    EXPECT_EQ(a.getValue(), 0x7F);
+    EXPECT_EQ(b.getValue(2), 0x7F);
+    EXPECT_EQ(c.getValue(), 0x00);
+
+    EXPECT_TRUE(MIDIInputElementNote::updateAllWith(
+        {MIDIMessageType::NoteOff, Channel_1, 0x3C, 0x7F}));
+    EXPECT_EQ(a.getValue(), 0x00);
+    EXPECT_EQ(b.getValue(2), 0x00);
+
+    EXPECT_FALSE(MIDIInputElementNote::updateAllWith(
+        {MIDIMessageType::NoteOn, Channel_1, 0x3E, 0x7F}));
+
+    MIDIInputElementNote::clearIndex();
+}
+
+TEST(MIDIInputElementIndex, allMatchesDeliveryUnindexed) {
+    struct Custom : MIDIInputElementCC {
+        bool updateWith(ChannelMessage msg) override {
+            ++count;
+            return msg.data1 == 0x10;
+        }
+        unsigned count = 0;
+    } custom;
+    CCValue value {{0x10, Channel_1}};
+    MIDIInputElementCC::buildIndex(MIDIInputDelivery::AllMatches);
+
+    MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x10, 0x11});
+    EXPECT_EQ(value.getValue(), 0x11);
+    EXPECT_EQ(custom.count, 1);
+
+    MIDIInputElementCC::clearIndex();
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getDelivery(),
+              MIDIInputDelivery::FirstMatch);
+}
+
+TEST(MIDIInputElementIndex, allMatchesBankableNoDuplicates) {
+    Bank<2> bank(1);
+    struct Counter : MatchingMIDIInputElement<MIDIMessageType::ControlChange,
+                                              BankableTwoByteMIDIMatcher<2>> {
+        Counter(Bank<2> &bank)
+            : MatchingMIDIInputElement({bank, {0x10, Channel_1}}) {}
+        void handleUpdate(BankableTwoByteMIDIMatcher<2>::Result) override {
+            ++count;
+        }
+        unsigned count = 0;
+    } counter {bank};
+    MIDIInputElementCC::buildIndex(MIDIInputDelivery::AllMatches);
+    EXPECT_EQ(MIDIInputElementCC::getIndex().getNumberOfEntries(), 2);
+
+    MIDIInputElementCC::updateAllWith(
+        {MIDIMessageType::ControlChange, Channel_1, 0x11, 0x01});
+    EXPECT_EQ(counter.count, 1);
+
+    MIDIInputElementCC::clearIndex();
+}
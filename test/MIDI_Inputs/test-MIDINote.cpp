@@ -947,6 +947,41 @@ TEST(BankableNoteLED, NoteOnNoteOff) {
     EXPECT_TRUE(mnl.getDirty());
 }
 
+TEST(BankableNoteLED, bankSwitchSameState) {
+    Bank<3> bank;
+    Bankable::NoteLED<3> mnl = {bank, 2, {0x3C, Channel_5}};
+
+    ::testing::InSequence seq;
+
+    EXPECT_CALL(ArduinoMock::getInstance(), pinMode(2, OUTPUT));
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(2, LOW));
+    MIDIInputElementNote::beginAll();
+    mnl.clearDirty();
+
+    // Bank 0 and bank 1 ON, bank 2 OFF
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(2, HIGH));
+    MIDIInputElementNote::updateAllWith({0x94, 0x3C, 0x7E});
+    MIDIInputElementNote::updateAllWith({0x94, 0x3D, 0x7E});
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    mnl.clearDirty();
+
+    // Switching to a bank with the same state doesn't touch the LED
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(::testing::_, ::testing::_))
+        .Times(0);
+    bank.select(1);
+    bank.select(1);
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_EQ(mnl.getValue(), 0x7E);
+    EXPECT_FALSE(mnl.getDirty());
+
+    // Switching to a bank with a different state does
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(2, LOW));
+    bank.select(2);
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_EQ(mnl.getValue(), 0x00);
+    EXPECT_TRUE(mnl.getDirty());
+}
+
 #include <MIDI_Inputs/LEDs/NoteCCKPLEDPWM.hpp>
 
 /// @todo TODO
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+// Minimal stand-in for the FastLED color type, FastLED is not available in
+// the tests
+#define FASTLED_VERSION 3000000
+struct CRGB {
+    uint8_t r, g, b;
+    CRGB &nscale8_video(uint8_t) { return *this; }
+    bool operator!=(CRGB o) const { return r != o.r || g != o.g || b != o.b; }
+};
+
+#include <MIDI_Inputs/NoteCCKPRange.hpp>
+#include <MIDI_Inputs/LEDs/NoteCCKPRangeFastLED.hpp>
+
+using namespace cs;
+
+namespace {
+/// Uses a different color for each bank.
+struct BankColorMapper {
+    CRGB operator()(uint8_t value, uint8_t bankIndex, uint8_t) const {
+        return {value, uint8_t(bankIndex * 10), 0};
+    }
+};
+} // namespace
+
+TEST(NoteRangeFastLED, bankDependentColorsEqualValues) {
+    Bank<2> bank(4);
+    CRGB leds[3] {};
+    Bankable::NoteCCKPRangeFastLED<MIDIMessageType::NoteOn, 2, 3,
+                                   BankColorMapper>
+        mn {bank, leds, {0x10, Channel_5}, BankColorMapper {}};
+    mn.begin();
+    EXPECT_EQ(leds[0].g, 0);
+
+    // Both banks have the same values
+    mn.updateWith({MIDIMessageType::NoteOn, Channel_5, 0x10, 0x20});
+    mn.updateWith({MIDIMessageType::NoteOn, Channel_5, 0x14, 0x20});
+    EXPECT_EQ(leds[0].r, 0x20);
+    EXPECT_EQ(leds[0].g, 0);
+
+    // The colors still change because they depend on the bank
+    bank.select(1);
+    EXPECT_EQ(leds[0].r, 0x20);
+    EXPECT_EQ(leds[0].g, 10);
+    EXPECT_EQ(leds[1].g, 10);
+    bank.select(0);
+    EXPECT_EQ(leds[0].g, 0);
+}
@@ -117,3 +117,34 @@ TEST(BLERingBuf, pushpopNonContiguous) {
     EXPECT_EQ(buf.pop(data), BLEDataType::None);
     EXPECT_EQ(buf.pop(data), BLEDataType::None);
 }
+
+TEST(BLERingBuf, consume) {
+    BLERingBuf<12> buf;
+    // |HH|--|--|--|--|--|
+    EXPECT_TRUE(buf.push(view("abcde")));
+    // |HH|HH|ab|cd|e-|--|
+    EXPECT_FALSE(buf.push(view("f")));
+    BLEDataView data;
+    EXPECT_EQ(buf.pop(data), BLEDataType::Packet);
+    // |--|HH|ab|cd|e-|--|
+    ASSERT_EQ(data.length, 6);
+    // Only whole multiples of the header size are released
+    buf.consume(data.data + 1);
+    EXPECT_FALSE(buf.push(view("f")));
+    buf.consume(data.data + 3);
+    // |--|--|HH|cd|e-|--|
+    EXPECT_TRUE(buf.push(view("f")));
+    // |HH|f-|HH|cd|e-|HH|
+    EXPECT_STREQ(reinterpret_cast<const char *>(data.data + 2), "cde");
+    buf.consume(data.data + 6);
+    // |HH|f-|--|--|HH|HH|
+    EXPECT_EQ(buf.pop(data), BLEDataType::Packet);
+    // |HH|f-|--|--|--|HH|
+    ASSERT_EQ(data.length, 0);
+    EXPECT_EQ(buf.pop(data), BLEDataType::Continuation);
+    // |HH|f-|--|--|--|--|
+    ASSERT_EQ(data.length, 2);
+    EXPECT_STREQ(reinterpret_cast<const char *>(data.data), "f");
+    EXPECT_EQ(buf.pop(data), BLEDataType::None);
+    EXPECT_EQ(buf.pop(data), BLEDataType::None);
+}
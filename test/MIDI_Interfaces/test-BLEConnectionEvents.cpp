@@ -0,0 +1,182 @@
+#include <MIDI_Interfaces/BLEMIDI/BLEConnectionEvents.hpp>
+#include <MIDI_Interfaces/BLEMIDI/BLEMIDIPacketBuilder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+TEST(BLEConnectionEvents, unknown) {
+    BLEConnectionEvents ev;
+    EXPECT_FALSE(ev.isKnown());
+    EXPECT_EQ(ev.getNotificationTime(1234), 1234u);
+}
+
+TEST(BLEConnectionEvents, parameters) {
+    BLEConnectionEvents ev;
+    ev.setParameters(12, 4, 100000); // 15 ms
+    EXPECT_TRUE(ev.isKnown());
+    EXPECT_EQ(ev.getInterval(), 12u);
+    EXPECT_EQ(ev.getIntervalMicros(), 15000u);
+    EXPECT_EQ(ev.getLatency(), 4u);
+    ev.setParameters(0, 0, 200000);
+    EXPECT_FALSE(ev.isKnown());
+    EXPECT_EQ(ev.getLatency(), 0u);
+}
+
+TEST(BLEConnectionEvents, nextEvent) {
+    BLEConnectionEvents ev;
+    ev.setParameters(12, 0, 100000); // 15 ms
+    EXPECT_EQ(ev.getNextEvent(100000), 100000u);
+    EXPECT_EQ(ev.getNextEvent(100001), 115000u);
+    EXPECT_EQ(ev.getNextEvent(115000), 115000u);
+    EXPECT_EQ(ev.getNextEvent(99999), 100000u);
+    EXPECT_EQ(ev.getNextEvent(85000), 85000u);
+    EXPECT_EQ(ev.getNextEvent(84999), 85000u);
+}
+
+TEST(BLEConnectionEvents, wrapAround) {
+    BLEConnectionEvents ev;
+    ev.setParameters(6, 0, 0xFFFFF000); // 7.5 ms
+    uint32_t t = 0xFFFFF000;
+    for (int i = 0; i < 1000; ++i) {
+        t += 7500;
+        ev.update(t + 100);
+        EXPECT_EQ(ev.getNextEvent(t + 100), t + 7500);
+        EXPECT_EQ(ev.getNextEvent(t), t);
+    }
+}
+
+TEST(BLEConnectionEvents, maxNotificationsPerEvent) {
+    BLEConnectionEvents ev;
+    ev.setParameters(8, 0, 0); // 10 ms
+    ev.setGuardTime(500);
+    ev.setMaxNotificationsPerEvent(2);
+    EXPECT_EQ(ev.getNotificationTime(1000), 1000u);
+    ev.registerNotification(1000);
+    EXPECT_EQ(ev.getNotificationTime(2000), 2000u);
+    ev.registerNotification(2000);
+    // Third notification has to wait for the next event
+    EXPECT_EQ(ev.getNotificationTime(3000), 19500u);
+    ev.registerNotification(19500);
+    EXPECT_EQ(ev.getNotificationTime(19600), 19600u);
+}
+
+namespace {
+
+struct SimulationResult {
+    double notifications = 0;
+    double bytes = 0;
+    double mean_latency = 0; // µs
+};
+
+/// Simulates a stream of MIDI messages that are sent over a BLE link with the
+/// given connection interval, where the first connection event takes place
+/// at time @p phase. Partially filled packets are handed to the BLE stack
+/// after the given timeout. A notification that is handed to the BLE stack at
+/// time t is sent during the first connection event after t + guard time.
+SimulationResult simulate(uint16_t interval, uint32_t timeout,
+                          uint32_t msg_period, uint16_t mtu, uint32_t phase) {
+    const uint32_t duration = 10'000'000;
+    BLEConnectionEvents link;
+    link.setParameters(interval, 0, phase);
+    BLEMIDIPacketBuilder packet {uint16_t(mtu - 3)};
+    std::vector<uint32_t> msg_times; // creation times of messages in packet
+    uint32_t start = 0;
+    SimulationResult result;
+    double total_latency = 0;
+    unsigned num_msgs = 0;
+
+    auto flush = [&](uint32_t t) {
+        uint32_t event = link.getNextEvent(t + link.getGuardTime());
+        ++result.notifications;
+        result.bytes += packet.getSize();
+        for (uint32_t m : msg_times)
+            total_latency += event - m;
+        num_msgs += msg_times.size();
+        msg_times.clear();
+        packet.reset();
+    };
+
+    uint32_t t_msg = 317; // not aligned with the connection events
+    uint8_t i = 0;
+    while (t_msg < duration) {
+        if (!packet.empty() && start + timeout <= t_msg) {
+            flush(start + timeout);
+            continue;
+        }
+        uint16_t ts = (t_msg / 1000) & 0x1FFF;
+        if (packet.empty())
+            start = t_msg;
+        if (!packet.add3B(0x90, i, 0x7F, ts)) {
+            flush(t_msg);
+            start = t_msg;
+            packet.add3B(0x90, i, 0x7F, ts);
+        }
+        i = (i + 1) & 0x7F;
+        msg_times.push_back(t_msg);
+        t_msg += msg_period;
+    }
+    if (!packet.empty())
+        flush(start + timeout);
+    result.mean_latency = total_latency / num_msgs;
+    return result;
+}
+
+/// Average of @ref simulate over random phases of the connection events.
+SimulationResult simulateRandomPhases(uint16_t interval, uint32_t timeout,
+                                      uint32_t msg_period, uint16_t mtu) {
+    const unsigned count = 16;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<uint32_t> phases(0, interval * 1250u - 1);
+    SimulationResult result;
+    for (unsigned i = 0; i < count; ++i) {
+        auto r = simulate(interval, timeout, msg_period, mtu, phases(gen));
+        result.notifications += r.notifications / count;
+        result.bytes += r.bytes / count;
+        result.mean_latency += r.mean_latency / count;
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(BLEConnectionEvents, simulationTimeout) {
+    // 30 ms connection interval, a Note On every 2 ms
+    auto short_timeout = simulateRandomPhases(24, 5000, 2000, 185);
+    auto long_timeout = simulateRandomPhases(24, 10000, 2000, 185);
+    RecordProperty("short_bytes_per_notification",
+                   std::to_string(short_timeout.bytes /
+                                  short_timeout.notifications));
+    RecordProperty("long_bytes_per_notification",
+                   std::to_string(long_timeout.bytes /
+                                  long_timeout.notifications));
+    RecordProperty("short_latency_us",
+                   std::to_string(short_timeout.mean_latency));
+    RecordProperty("long_latency_us", std::to_string(long_timeout.mean_latency));
+    // A longer timeout means fewer, fuller notifications, and more latency
+    EXPECT_LT(long_timeout.notifications, short_timeout.notifications);
+    EXPECT_LT(long_timeout.bytes, short_timeout.bytes);
+    EXPECT_GT(long_timeout.mean_latency, short_timeout.mean_latency);
+    // Every message makes the first connection event after the timeout
+    EXPECT_LE(long_timeout.mean_latency, 10000 + 30000);
+}
+
+TEST(BLEConnectionEvents, simulationShortInterval) {
+    // 7.5 ms connection interval, 10 ms timeout, a Note On every 2 ms
+    auto r = simulateRandomPhases(6, 10000, 2000, 185);
+    RecordProperty("latency_us", std::to_string(r.mean_latency));
+    // The timeout is longer than the interval, so it dominates the latency
+    EXPECT_GT(r.mean_latency, 5000);
+    EXPECT_LE(r.mean_latency, 10000 + 7500);
+}
+
+TEST(BLEConnectionEvents, simulationFullPackets) {
+    // Small MTU: packets fill up before the timeout, so the timeout doesn't
+    // affect the throughput
+    auto short_timeout = simulateRandomPhases(24, 5000, 500, 23);
+    auto long_timeout = simulateRandomPhases(24, 10000, 500, 23);
+    EXPECT_NEAR(long_timeout.notifications, short_timeout.notifications, 1);
+}
@@ -3,6 +3,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <random>
+
 USING_CS_NAMESPACE;
 
 static uint16_t timestamp(uint8_t msb, uint8_t lsb) {
@@ -958,4 +960,106 @@ TEST(BLEMIDIPacketBuilder, sysExAddChunkEndTwoPackets) {
     EXPECT_EQ(length, 0);
     EXPECT_EQ(dataptr, nullptr);
     EXPECT_EQ(b.getPacket(), expected);
-}
\ No newline at end of file
+}
+
+TEST(StaticBLEMIDIPacketBuilder, capacity) {
+    StaticBLEMIDIPacketBuilder<32> b;
+    EXPECT_EQ(b.getCapacity(), 20);
+    b.setCapacity(512);
+    EXPECT_EQ(b.getCapacity(), 32);
+    b.setCapacity(6);
+    EXPECT_EQ(b.getCapacity(), 6);
+    EXPECT_TRUE(b.add3B(0x92, 0x12, 0x34, timestamp(0x01, 0x02)));
+    EXPECT_FALSE(b.add3B(0x93, 0x12, 0x34, timestamp(0x01, 0x02)));
+    bvec expected = {0x81, 0x82, 0x92, 0x12, 0x34};
+    EXPECT_EQ(bvec(b.getPacket().begin(), b.getPacket().end()), expected);
+}
+
+TEST(StaticBLEMIDIPacketBuilder, capacityNotBelowSize) {
+    StaticBLEMIDIPacketBuilder<32> b;
+    EXPECT_TRUE(b.add3B(0x92, 0x12, 0x34, timestamp(0x01, 0x02)));
+    EXPECT_TRUE(b.add3B(0x93, 0x12, 0x34, timestamp(0x01, 0x02)));
+    ASSERT_EQ(b.getSize(), 9);
+    // Like std::vector::reserve, the capacity doesn't shrink below the size
+    b.setCapacity(6);
+    EXPECT_EQ(b.getCapacity(), 9);
+    EXPECT_FALSE(b.add3B(0x94, 0x12, 0x34, timestamp(0x01, 0x02)));
+    EXPECT_FALSE(b.addRealTime(0xF8, timestamp(0x01, 0x02)));
+    EXPECT_EQ(b.getSize(), 9);
+}
+
+/// Feed the same random stream of messages to both builders, and check that
+/// they produce the same packets.
+template <class BuilderA, class BuilderB>
+static void checkSamePackets(BuilderA &a, BuilderB &b, uint16_t capacity) {
+    a.setCapacity(capacity);
+    b.setCapacity(capacity);
+    std::mt19937 gen(capacity);
+    std::uniform_int_distribution<int> kind(0, 5), data(0, 0x7F);
+    std::vector<bvec> packets_a, packets_b;
+    auto flush = [&] {
+        packets_a.emplace_back(a.getBuffer(), a.getBuffer() + a.getSize());
+        packets_b.emplace_back(b.getBuffer(), b.getBuffer() + b.getSize());
+        a.reset();
+        b.reset();
+    };
+    bvec sysex(2 * capacity, 0x11);
+    sysex.front() = 0xF0;
+    sysex.back() = 0xF7;
+    for (uint16_t ts = 0; ts < 1000; ++ts) {
+        uint8_t d1 = data(gen), d2 = data(gen);
+        uint8_t header = 0x90 | (d2 & 0x03);
+        bool ok_a, ok_b;
+        switch (kind(gen)) {
+            case 0: // fallthrough
+            case 1:
+                ok_a = a.add3B(header, d1, d2, ts / 2);
+                ok_b = b.add3B(header, d1, d2, ts / 2);
+                break;
+            case 2:
+                ok_a = a.add2B(0xC0, d1, ts / 2);
+                ok_b = b.add2B(0xC0, d1, ts / 2);
+                break;
+            case 3:
+                ok_a = a.addRealTime(0xF8, ts / 2);
+                ok_b = b.addRealTime(0xF8, ts / 2);
+                break;
+            case 4:
+                ok_a = a.addSysCommon(1, 0xF1, d1, 0, ts / 2);
+                ok_b = b.addSysCommon(1, 0xF1, d1, 0, ts / 2);
+                break;
+            default: {
+                const uint8_t *data_a = sysex.data(), *data_b = sysex.data();
+                size_t len_a = sysex.size(), len_b = sysex.size();
+                if (!a.addSysEx(data_a, len_a, ts) |
+                    !b.addSysEx(data_b, len_b, ts)) {
+                    flush();
+                    a.addSysEx(data_a, len_a, ts);
+                    b.addSysEx(data_b, len_b, ts);
+                }
+                while (data_a || data_b) {
+                    ASSERT_EQ(data_a, data_b);
+                    ASSERT_EQ(len_a, len_b);
+                    flush();
+                    a.continueSysEx(data_a, len_a, ts);
+                    b.continueSysEx(data_b, len_b, ts);
+                }
+                continue;
+            }
+        }
+        ASSERT_EQ(ok_a, ok_b);
+        if (!ok_a) {
+            flush();
+            --ts; // try again in a new packet
+        }
+    }
+    flush();
+    EXPECT_EQ(packets_a, packets_b);
+}
+
+TEST(StaticBLEMIDIPacketBuilder, sameAsDynamic) {
+    BLEMIDIPacketBuilder a;
+    StaticBLEMIDIPacketBuilder<512> b;
+    for (uint16_t capacity : {5, 6, 7, 20, 61, 182, 244, 512})
+        checkSamePackets(a, b, capacity);
+}
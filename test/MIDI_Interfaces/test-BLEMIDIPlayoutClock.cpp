@@ -0,0 +1,156 @@
+#include <MIDI_Interfaces/BLEMIDI/BLEMIDIPlayoutClock.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+USING_CS_NAMESPACE;
+
+TEST(BLEMIDIPlayoutClock, unwrap) {
+    BLEMIDIPlayoutClock clock;
+    uint32_t now = 0xFFFFF000;
+    EXPECT_EQ(clock.unwrap(8190, now), 8190u);
+    now += 5000;
+    EXPECT_EQ(clock.unwrap(3, now), 8195u); // overflow
+    now += 1000;
+    EXPECT_EQ(clock.unwrap(1, now), 8193u); // slightly earlier than expected
+    // More than half the range of the timestamps later
+    now += 6000000;
+    EXPECT_EQ(clock.unwrap((8193 + 6000) & 0x1FFF, now), 8193u + 6000);
+    EXPECT_EQ(clock.getSenderTime(), 8193u + 6000);
+}
+
+TEST(BLEMIDIPlayoutClock, firstMessage) {
+    BLEMIDIPlayoutClock clock;
+    clock.setLatency(10000);
+    EXPECT_FALSE(clock.isSynchronized());
+    EXPECT_EQ(clock.schedule(1234, 5000000), 5010000u);
+    EXPECT_TRUE(clock.isSynchronized());
+    // Sent 4 ms later, arrived 10 ms later
+    EXPECT_EQ(clock.schedule(1238, 5010000), 5014000u);
+    // Sent 1 ms later, arrived 1 ms later
+    EXPECT_EQ(clock.schedule(1239, 5011000), 5015000u);
+    // Sent 11 ms later, arrived 1 ms later: shorter delay than the first one
+    EXPECT_EQ(clock.schedule(1250, 5012000), 5022000u);
+}
+
+namespace {
+
+struct PlayoutResult {
+    uint32_t min_delay = UINT32_MAX, max_delay = 0; // release time - send time
+    uint32_t min_arrival = UINT32_MAX, max_arrival = 0; // arrival - send time
+    uint32_t on_time = 0, late = 0; // number of messages
+    float drift = 0;
+    uint32_t getJitter() const { return max_delay - min_delay; }
+    uint32_t getArrivalJitter() const { return max_arrival - min_arrival; }
+};
+
+/// Simulates a sender that sends a message every @p period µs, using a clock
+/// that drifts @p ppm relative to the local clock. The messages are batched
+/// per connection event (every @p interval µs), and some of the events are
+/// missed. Only the last @p measure µs are used for the results.
+PlayoutResult simulate(BLEMIDIPlayoutClock &clock, uint32_t period,
+                       uint32_t interval, double ppm, uint32_t duration,
+                       uint32_t measure) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> missed(0, 9);
+    std::uniform_int_distribution<int> delay(200, 600);
+    const uint32_t t0 = 0xFF000000; // local times wrap around
+    const double s0 = 123456789;    // sender time at t0 (µs)
+    PlayoutResult result;
+    uint32_t next_event = t0 + interval / 3, prev_event = t0;
+    for (uint32_t t = 0; t < duration; t += period) {
+        // Time stamp according to the sender's clock
+        double sender = s0 + t * (1 + ppm * 1e-6);
+        uint16_t timestamp = uint64_t(sender / 1000) & 0x1FFF;
+        // Arrives after the next connection event that isn't missed
+        uint32_t send_time = t0 + t;
+        while (int32_t(next_event - send_time) < 0)
+            next_event += interval;
+        // Data is never reordered, so if an event is missed, the next
+        // messages are delayed as well
+        uint32_t event = std::max(next_event - t0, prev_event - t0) + t0;
+        while (missed(gen) == 0)
+            event += interval;
+        prev_event = event;
+        uint32_t arrival = event + delay(gen);
+        uint32_t release = clock.schedule(timestamp, arrival);
+        EXPECT_GE(int32_t(release - arrival), 0);
+        EXPECT_LE(release - arrival, clock.getLatency());
+        if (t < duration - measure)
+            continue;
+        result.min_arrival = std::min(result.min_arrival, arrival - send_time);
+        result.max_arrival = std::max(result.max_arrival, arrival - send_time);
+        // Messages that arrive later than the latency can't be on time
+        if (release == arrival) {
+            ++result.late;
+            continue;
+        }
+        ++result.on_time;
+        uint32_t d = release - send_time;
+        result.min_delay = std::min(result.min_delay, d);
+        result.max_delay = std::max(result.max_delay, d);
+    }
+    result.drift = clock.getDrift();
+    return result;
+}
+
+} // namespace
+
+TEST(BLEMIDIPlayoutClock, removesConnectionEventJitter) {
+    // A Timing Clock message every 20.8 ms (120 BPM), 15 ms interval
+    BLEMIDIPlayoutClock clock;
+    clock.setLatency(40000);
+    auto res = simulate(clock, 20833, 15000, 0, 20000000, 10000000);
+    RecordProperty("jitter_without_playout_us",
+                   std::to_string(res.getArrivalJitter()));
+    RecordProperty("jitter_us", std::to_string(res.getJitter()));
+    RecordProperty("max_delay_us", std::to_string(res.max_delay));
+    RecordProperty("late", std::to_string(res.late));
+    // Without playout, the jitter is several connection intervals. The
+    // remaining jitter is due to the millisecond resolution of the timestamps
+    // and the variation of the transmission delay.
+    EXPECT_GT(res.getArrivalJitter(), 30000u);
+    EXPECT_LE(res.getJitter(), 2000u);
+    EXPECT_LE(res.max_delay, 40000u + 2000u);
+    // Only messages that were delayed by several missed connection events
+    EXPECT_LT(res.late, res.on_time / 50);
+}
+
+TEST(BLEMIDIPlayoutClock, drift) {
+    for (double ppm : {-200., 200.}) {
+        BLEMIDIPlayoutClock clock;
+        clock.setLatency(40000);
+        auto res = simulate(clock, 5000, 7500, ppm, 60000000, 30000000);
+        RecordProperty(ppm > 0 ? "jitter_fast_us" : "jitter_slow_us",
+                       std::to_string(res.getJitter()));
+        EXPECT_LE(res.getJitter(), 2000u) << ppm;
+        EXPECT_LT(res.late, res.on_time / 50) << ppm;
+        // The local clock runs slower if the sender's clock runs faster
+        EXPECT_NEAR(res.drift, -ppm * 1e-6, 50e-6) << ppm;
+    }
+}
+
+TEST(BLEMIDIPlayoutClock, senderClockJumps) {
+    BLEMIDIPlayoutClock clock;
+    clock.setLatency(20000);
+    uint32_t now = 0;
+    uint16_t timestamp = 0;
+    for (int i = 0; i < 5000; ++i) {
+        now += 1000;
+        timestamp = (timestamp + 1) & 0x1FFF;
+        clock.schedule(timestamp, now);
+    }
+    // A different device connects, its timestamps are 3 s earlier
+    timestamp = (timestamp - 3000) & 0x1FFF;
+    uint32_t late = 0;
+    for (int i = 0; i < 5000; ++i) {
+        now += 1000;
+        timestamp = (timestamp + 1) & 0x1FFF;
+        if (clock.schedule(timestamp, now) - now != 20000)
+            ++late;
+    }
+    // Only the messages in the first one or two windows are released early
+    EXPECT_LE(late, 2000u);
+}
@@ -36,6 +36,9 @@ void MockBLEImpl::notify(BLEConnectionHandle, BLECharacteristicHandle,
 }
 
 struct BluetoothMIDI_Interface : GenericBLEMIDI_Interface<MockBLEBackend> {
+    // Packets are sent asynchronously, make sure they're sent before the
+    // expectations of the mock backend are verified
+    ~BluetoothMIDI_Interface() { backend.waitUntilSent(); }
     void parse(const uint8_t *data, size_t length) {
         BLEDataView view {data, static_cast<uint16_t>(length)};
         auto data_gen = [view {view}]() mutable {
@@ -449,6 +452,47 @@ TEST(BluetoothMIDIInterface, invalidPacket) {
 
 using namespace ::testing;
 
+TEST(BluetoothMIDIInterface, receivePlayout) {
+    MockMIDI_Callbacks cb;
+
+    BluetoothMIDI_Interface midi;
+    midi.begin();
+    midi.setCallbacks(&cb);
+    midi.setPlayoutLatency(std::chrono::milliseconds {10});
+    auto at = [&](unsigned long t) {
+        EXPECT_CALL(ArduinoMock::getInstance(), micros())
+            .WillRepeatedly(Return(t));
+        midi.update();
+    };
+
+    // Sent at 0 ms, arrives at 1 s, released 10 ms later
+    uint8_t data1[] = {0x80, 0x80, 0x90, 0x3C, 0x7F};
+    midi.parse(data1, sizeof(data1));
+    at(1000000);
+    EXPECT_TRUE(cb.channelMessages.empty());
+    at(1010000);
+    std::vector<ChannelMessage> expected = {{0x90, 0x3C, 0x7F}};
+    EXPECT_EQ(cb.channelMessages, expected);
+    EXPECT_EQ(midi.getSenderTime(), 0u);
+
+    // Sent at 15 ms and 20 ms, both arrive at 1.02 s
+    uint8_t data2[] = {0x80, 0x8F, 0x90, 0x3D, 0x7F, 0x94, 0x90, 0x3E, 0x7F};
+    midi.parse(data2, sizeof(data2));
+    at(1020000);
+    EXPECT_EQ(cb.channelMessages, expected);
+    at(1025000);
+    expected.push_back({0x90, 0x3D, 0x7F});
+    EXPECT_EQ(cb.channelMessages, expected);
+    at(1029999);
+    EXPECT_EQ(cb.channelMessages, expected);
+    at(1030000);
+    expected.push_back({0x90, 0x3E, 0x7F});
+    EXPECT_EQ(cb.channelMessages, expected);
+    EXPECT_EQ(midi.getSenderTime(), 20u);
+
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
 TEST(BluetoothMIDIInterface, sendOneNoteMessage) {
     BluetoothMIDI_Interface midi;
     midi.begin();
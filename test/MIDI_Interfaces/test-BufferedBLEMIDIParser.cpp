@@ -0,0 +1,238 @@
+#include <MIDI_Interfaces/BLEMIDI/BLEMIDIPacketBuilder.hpp>
+#include <MIDI_Interfaces/BLEMIDI/BufferedBLEMIDIParser.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using bvec = std::vector<uint8_t>;
+
+namespace {
+
+/// Flattened MIDI message, for comparing the output of two parsers.
+struct Msg {
+    MIDIReadEvent type;
+    bvec data;
+    uint16_t timestamp;
+    bool operator==(const Msg &o) const {
+        return type == o.type && data == o.data && timestamp == o.timestamp;
+    }
+};
+
+std::ostream &operator<<(std::ostream &os, const Msg &m) {
+    os << int(m.type) << " @" << m.timestamp << ":";
+    for (uint8_t b : m.data)
+        os << ' ' << std::hex << int(b) << std::dec;
+    return os;
+}
+
+Msg flatten(const AnyMIDIMessage &m) {
+    auto evt = m.eventType;
+    if (evt == MIDIReadEvent::CHANNEL_MESSAGE) {
+        auto c = m.message.channelmessage;
+        return {evt, {c.header, c.data1, c.data2}, m.timestamp};
+    } else if (evt == MIDIReadEvent::SYSCOMMON_MESSAGE) {
+        auto c = m.message.syscommonmessage;
+        return {evt, {c.header, c.data1, c.data2}, m.timestamp};
+    } else if (evt == MIDIReadEvent::REALTIME_MESSAGE) {
+        return {evt, {m.message.realtimemessage.message}, m.timestamp};
+    } else if (evt == MIDIReadEvent::SYSEX_CHUNK ||
+               evt == MIDIReadEvent::SYSEX_MESSAGE) {
+        auto s = m.message.sysexmessage;
+        return {evt, {s.data, s.data + s.length}, m.timestamp};
+    }
+    return {evt, {}, m.timestamp};
+}
+
+/// Reference implementation: feed the BLE packets to the MIDI parser byte by
+/// byte.
+std::vector<Msg> parseBytewise(const std::vector<bvec> &packets) {
+    SerialMIDI_Parser parser {false};
+    std::vector<Msg> result;
+    for (auto &packet : packets) {
+        BLEMIDIParser ble_parser {packet.data(), packet.size()};
+        while (true) {
+            auto evt = parser.pull(ble_parser);
+            auto ts = ble_parser.getTimestamp();
+            if (evt == MIDIReadEvent::CHANNEL_MESSAGE)
+                result.push_back(flatten({parser.getChannelMessage(), ts}));
+            else if (evt == MIDIReadEvent::SYSCOMMON_MESSAGE)
+                result.push_back(flatten({parser.getSysCommonMessage(), ts}));
+            else if (evt == MIDIReadEvent::REALTIME_MESSAGE)
+                result.push_back(flatten({parser.getRealTimeMessage(), ts}));
+            else if (evt == MIDIReadEvent::SYSEX_CHUNK ||
+                     evt == MIDIReadEvent::SYSEX_MESSAGE)
+                result.push_back(flatten({parser.getSysExMessage(), ts}));
+            else
+                break;
+        }
+    }
+    return result;
+}
+
+template <uint16_t Capacity>
+std::vector<Msg> popAll(BufferedBLEMIDIParser<Capacity> &parser) {
+    std::vector<Msg> result;
+    AnyMIDIMessage msg;
+    while (parser.popMessage(msg))
+        result.push_back(flatten(msg));
+    return result;
+}
+
+/// Random BLE packets with channel messages (with and without running
+/// status), real-time messages and SysEx messages that may span multiple
+/// packets.
+std::vector<bvec> randomPackets(size_t count, uint16_t capacity) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> data(0, 0x7F);
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::vector<bvec> packets;
+    BLEMIDIPacketBuilder builder {capacity};
+    auto flush = [&] {
+        packets.emplace_back(builder.getBuffer(),
+                             builder.getBuffer() + builder.getSize());
+        builder.reset();
+    };
+    uint16_t timestamp = 0;
+    while (packets.size() < count) {
+        timestamp = (timestamp + kind(gen)) & 0x1FFF;
+        uint8_t channel = data(gen) & 1;
+        uint8_t d1 = data(gen), d2 = data(gen);
+        switch (kind(gen)) {
+            case 0: { // SysEx
+                bvec sysex(data(gen) + 2, d1);
+                sysex.front() = 0xF0;
+                sysex.back() = 0xF7;
+                const uint8_t *sysex_data = sysex.data();
+                size_t sysex_length = sysex.size();
+                if (!builder.addSysEx(sysex_data, sysex_length, timestamp)) {
+                    flush();
+                    builder.addSysEx(sysex_data, sysex_length, timestamp);
+                }
+                while (sysex_data) {
+                    flush();
+                    builder.continueSysEx(sysex_data, sysex_length, timestamp);
+                }
+            } break;
+            case 1: // Timing Clock
+                if (!builder.addRealTime(0xF8, timestamp)) {
+                    flush();
+                    builder.addRealTime(0xF8, timestamp);
+                }
+                break;
+            case 2: // Program Change
+                if (!builder.add2B(0xC0 | channel, d1, timestamp)) {
+                    flush();
+                    builder.add2B(0xC0 | channel, d1, timestamp);
+                }
+                break;
+            default: // Note On
+                if (!builder.add3B(0x90 | channel, d1, d2, timestamp)) {
+                    flush();
+                    builder.add3B(0x90 | channel, d1, d2, timestamp);
+                }
+        }
+    }
+    return packets;
+}
+
+} // namespace
+
+TEST(BufferedBLEMIDIParser, channelMessages) {
+    BufferedBLEMIDIParser<64> parser;
+    bvec packet {0x81, 0x82, 0x90, 0x3C, 0x7F, 0x83, 0x3D, 0x7E,
+                 0x84, 0x80, 0x3C, 0x00};
+    ASSERT_TRUE(parser.pushPacket({packet.data(), uint16_t(packet.size())}));
+    std::vector<Msg> expected {
+        {MIDIReadEvent::CHANNEL_MESSAGE, {0x90, 0x3C, 0x7F}, 0x82},
+        {MIDIReadEvent::CHANNEL_MESSAGE, {0x90, 0x3D, 0x7E}, 0x83},
+        {MIDIReadEvent::CHANNEL_MESSAGE, {0x80, 0x3C, 0x00}, 0x84},
+    };
+    EXPECT_EQ(popAll(parser), expected);
+}
+
+TEST(BufferedBLEMIDIParser, headerSplitFromTimestamp) {
+    // The BLE stack may deliver the packet in chunks of any size
+    BufferedBLEMIDIParser<64> parser;
+    bvec chunk1 {0x81};
+    bvec chunk2 {0x82, 0x90, 0x3C, 0x7F};
+    ASSERT_TRUE(parser.pushPacket({chunk1.data(), uint16_t(chunk1.size())}));
+    ASSERT_TRUE(parser.pushPacket({chunk2.data(), uint16_t(chunk2.size())},
+                                  BLEDataType::Continuation));
+    std::vector<Msg> expected {
+        {MIDIReadEvent::CHANNEL_MESSAGE, {0x90, 0x3C, 0x7F}, 0x82},
+    };
+    EXPECT_EQ(popAll(parser), expected);
+}
+
+TEST(BufferedBLEMIDIParser, emptyFirstChunk) {
+    BufferedBLEMIDIParser<64> parser;
+    bvec packet {0x81, 0x82, 0x90, 0x3C, 0x7F};
+    ASSERT_TRUE(parser.pushPacket({}));
+    ASSERT_TRUE(parser.pushPacket({packet.data(), uint16_t(packet.size())},
+                                  BLEDataType::Continuation));
+    std::vector<Msg> expected {
+        {MIDIReadEvent::CHANNEL_MESSAGE, {0x90, 0x3C, 0x7F}, 0x82},
+    };
+    EXPECT_EQ(popAll(parser), expected);
+}
+
+TEST(BufferedBLEMIDIParser, wrappedPackets) {
+    // Every packet is parsed directly from the ring buffer, also when it wraps
+    // around, regardless of where it's split
+    auto packets = randomPackets(500, 40);
+    BufferedBLEMIDIParser<64> parser;
+    std::vector<Msg> result;
+    for (auto &packet : packets) {
+        ASSERT_TRUE(
+            parser.pushPacket({packet.data(), uint16_t(packet.size())}));
+        auto msgs = popAll(parser);
+        result.insert(result.end(), msgs.begin(), msgs.end());
+    }
+    auto expected = parseBytewise(packets);
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t i = 0; i < result.size(); ++i)
+        ASSERT_EQ(result[i], expected[i]) << i;
+    EXPECT_GT(expected.size(), 1000u);
+}
+
+TEST(BufferedBLEMIDIParser, releaseProgressively) {
+    BufferedBLEMIDIParser<64> parser;
+    // Note On messages with running status, 3 bytes each
+    bvec packet1 {0x80, 0x80, 0x90, 0x00, 0x7F};
+    for (uint8_t i = 1; i < 12; ++i)
+        packet1.insert(packet1.end(), {0x80, i, 0x7F});
+    // Timing Clock messages, 2 bytes each
+    bvec packet2 {0x80};
+    for (uint8_t i = 0; i < 14; ++i)
+        packet2.insert(packet2.end(), {0x80, 0xF8});
+    ASSERT_TRUE(parser.pushPacket({packet1.data(), uint16_t(packet1.size())}));
+    // Not enough space left for the second packet
+    BLEDataView view2 {packet2.data(), uint16_t(packet2.size())};
+    EXPECT_FALSE(parser.pushPacket(view2));
+
+    // Space is freed as the first packet is parsed, before it's parsed
+    // completely
+    AnyMIDIMessage msg;
+    uint8_t note = 0;
+    while (!parser.pushPacket(view2)) {
+        ASSERT_TRUE(parser.popMessage(msg));
+        EXPECT_EQ(msg.message.channelmessage.data1, note++);
+    }
+    EXPECT_LT(note, 8);
+    // The rest of the first packet is still intact
+    while (note < 12) {
+        ASSERT_TRUE(parser.popMessage(msg));
+        ASSERT_EQ(msg.eventType, MIDIReadEvent::CHANNEL_MESSAGE);
+        EXPECT_EQ(msg.message.channelmessage.data1, note++);
+    }
+    size_t clocks = 0;
+    while (parser.popMessage(msg)) {
+        EXPECT_EQ(msg.eventType, MIDIReadEvent::REALTIME_MESSAGE);
+        ++clocks;
+    }
+    EXPECT_EQ(clocks, 14u);
+}
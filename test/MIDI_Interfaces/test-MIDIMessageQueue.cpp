@@ -0,0 +1,146 @@
+#include <MIDI_Interfaces/MIDIMessageQueue.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+USING_CS_NAMESPACE;
+using ::testing::ElementsAreArray;
+using ::testing::StrictMock;
+
+namespace {
+
+struct MockMIDI_Sink : TrueMIDI_Sink {
+    MOCK_METHOD(void, sinkMIDIfromPipe, (ChannelMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (SysExMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (SysCommonMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (RealTimeMessage), (override));
+};
+
+struct CountingSink : TrueMIDI_Sink {
+    void sinkMIDIfromPipe(ChannelMessage msg) override {
+        EXPECT_EQ(msg.data1, expected & 0x7F);
+        ++expected;
+    }
+    void sinkMIDIfromPipe(SysExMessage) override {}
+    void sinkMIDIfromPipe(SysCommonMessage) override {}
+    void sinkMIDIfromPipe(RealTimeMessage) override {}
+    uint32_t expected = 0;
+};
+
+} // namespace
+
+TEST(MIDIMessageQueue, pushFlush) {
+    StrictMock<MockMIDI_Sink> sink;
+    MIDI_Pipe pipe;
+    MIDIMessageQueue<4> queue;
+    queue >> pipe >> sink;
+
+    ChannelMessage cm {0x93, 0x10, 0x7F, Cable_6};
+    SysCommonMessage scm {MIDIMessageType::SongPositionPointer, 0x12, 0x34,
+                          Cable_2};
+    RealTimeMessage rtm {MIDIMessageType::TimingClock, Cable_3};
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.push(cm));
+    EXPECT_TRUE(queue.push(scm));
+    EXPECT_TRUE(queue.push(rtm));
+    EXPECT_FALSE(queue.empty());
+
+    ::testing::InSequence seq;
+    EXPECT_CALL(sink, sinkMIDIfromPipe(cm));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(scm));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(rtm));
+    EXPECT_EQ(queue.flush(), 3);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.flush(), 0);
+}
+
+TEST(MIDIMessageQueue, overflow) {
+    StrictMock<MockMIDI_Sink> sink;
+    MIDI_Pipe pipe;
+    MIDIMessageQueue<2> queue;
+    queue >> pipe >> sink;
+    EXPECT_EQ(queue.getCapacity(), 2);
+    EXPECT_EQ(queue.getPeakUsage(), 0);
+
+    ChannelMessage msgs[] {{0x90, 1, 1}, {0x90, 2, 2}, {0x90, 3, 3}};
+    EXPECT_TRUE(queue.push(msgs[0]));
+    EXPECT_EQ(queue.getPeakUsage(), 1);
+    EXPECT_TRUE(queue.push(msgs[1]));
+    EXPECT_FALSE(queue.push(msgs[2]));
+    EXPECT_EQ(queue.getNumberOfOverflows(), 1);
+    EXPECT_EQ(queue.getPeakUsage(), 2);
+
+    ::testing::InSequence seq;
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msgs[0]));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msgs[1]));
+    queue.flush();
+    ::testing::Mock::VerifyAndClear(&sink);
+
+    // The queue wraps around
+    EXPECT_TRUE(queue.push(msgs[2]));
+    EXPECT_TRUE(queue.push(msgs[0]));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msgs[2]));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msgs[0]));
+    queue.flush();
+    // The peak usage is a high-water mark, it isn't reset by flushing
+    EXPECT_EQ(queue.getPeakUsage(), 2);
+}
+
+TEST(MIDIMessageQueue, sysex) {
+    StrictMock<MockMIDI_Sink> sink;
+    MIDI_Pipe pipe;
+    MIDIMessageQueue<8, 2, 4> queue;
+    queue >> pipe >> sink;
+
+    uint8_t data1[] {0xF0, 0x01, 0xF7};
+    uint8_t data2[] {0xF0, 0x02, 0x03, 0xF7};
+    uint8_t data3[] {0xF0, 0x04, 0x05, 0x06, 0xF7};
+    EXPECT_TRUE(queue.push(SysExMessage {data1, Cable_2}));
+    EXPECT_FALSE(queue.push(SysExMessage {data3})); // too long
+    EXPECT_TRUE(queue.push(SysExMessage {data2, Cable_3}));
+    EXPECT_FALSE(queue.push(SysExMessage {data1})); // no slots left
+    EXPECT_EQ(queue.getNumberOfSysExOverflows(), 2);
+    // The producer's copies can be overwritten
+    data1[1] = data2[1] = 0x7F;
+
+    std::vector<std::vector<uint8_t>> received;
+    EXPECT_CALL(sink, sinkMIDIfromPipe(::testing::An<SysExMessage>()))
+        .Times(2)
+        .WillRepeatedly([&](SysExMessage msg) {
+            received.emplace_back(msg.data, msg.data + msg.length);
+        });
+    EXPECT_EQ(queue.flush(), 2);
+    using v = std::vector<uint8_t>;
+    EXPECT_THAT(received,
+                ElementsAreArray({v {0xF0, 0x01, 0xF7},
+                                  v {0xF0, 0x02, 0x03, 0xF7}}));
+    ::testing::Mock::VerifyAndClear(&sink);
+
+    // The slots are free again
+    EXPECT_CALL(sink, sinkMIDIfromPipe(::testing::An<SysExMessage>()))
+        .Times(2);
+    EXPECT_TRUE(queue.push(SysExMessage {data1}));
+    EXPECT_TRUE(queue.push(SysExMessage {data2}));
+    queue.flush();
+}
+
+TEST(MIDIMessageQueue, thread) {
+    CountingSink sink;
+    MIDI_Pipe pipe;
+    MIDIMessageQueue<16> queue;
+    queue >> pipe >> sink;
+
+    const uint32_t count = 10000;
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < count; ++i)
+            while (!queue.push(ChannelMessage {0x90, uint8_t(i & 0x7F), 0}))
+                std::this_thread::yield();
+    });
+    while (sink.expected < count)
+        if (queue.flush() == 0)
+            std::this_thread::yield();
+    producer.join();
+    EXPECT_EQ(sink.expected, count);
+}
@@ -0,0 +1,179 @@
+#include <MIDI_Interfaces/MIDIStallBuffer.hpp>
+#include <MIDI_Interfaces/MIDI_Staller.hpp>
+
+#include <Arduino.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+USING_CS_NAMESPACE;
+using ::testing::Return;
+using ::testing::StrictMock;
+
+namespace {
+
+struct MockMIDI_Sink : TrueMIDI_Sink {
+    MOCK_METHOD(void, sinkMIDIfromPipe, (ChannelMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (SysExMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (SysCommonMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (RealTimeMessage), (override));
+};
+
+struct MockMIDIStaller : MIDIStaller {
+    MockMIDIStaller(MIDI_Source *stalled) : stalled(stalled) {}
+    MOCK_METHOD(void, stallHandled, ());
+    void handleStall() override {
+        stallHandled();
+        stalled->unstall(this);
+    }
+    MIDI_Source *stalled;
+};
+
+// Source A stalls the sink, source B sends through a stall buffer.
+struct MIDIStallBufferTest : ::testing::Test {
+    StrictMock<MockMIDI_Sink> sink;
+    TrueMIDI_Source sourceA, sourceB;
+    MIDI_PipeFactory<3> pipes;
+    MIDIStallBuffer<2> buffer;
+    StrictMock<MockMIDIStaller> staller {&sourceA};
+
+    void SetUp() override {
+        sourceA >> pipes >> sink;
+        sourceB >> pipes >> buffer;
+        buffer >> pipes >> sink;
+    }
+    void expectMillis(unsigned long t) {
+        EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillOnce(Return(t));
+    }
+};
+
+} // namespace
+
+TEST_F(MIDIStallBufferTest, notStalled) {
+    ChannelMessage msg {0x93, 0x10, 0x7F};
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msg));
+    sourceB.sourceMIDItoPipe(msg);
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(MIDIStallBufferTest, parkAndReplay) {
+    sourceA.stall(&staller);
+    EXPECT_TRUE(buffer.isStalled());
+    EXPECT_FALSE(sourceB.isStalled());
+
+    // Messages are parked without handling the stall
+    ChannelMessage msg1 {0x93, 0x10, 0x7F};
+    SysCommonMessage msg2 {MIDIMessageType::TuneRequest};
+    expectMillis(100);
+    sourceB.sourceMIDItoPipe(msg1);
+    sourceB.sourceMIDItoPipe(msg2);
+    EXPECT_EQ(buffer.getPeakUsage(), 2);
+
+    // Real-Time messages are never delayed
+    RealTimeMessage rt {MIDIMessageType::TimingClock};
+    EXPECT_CALL(sink, sinkMIDIfromPipe(rt));
+    sourceB.sourceMIDItoPipe(rt);
+    ::testing::Mock::VerifyAndClear(&sink);
+
+    // Nothing is sent while still stalled
+    buffer.update();
+
+    // Replayed in order once the stall is resolved
+    sourceA.unstall(&staller);
+    ::testing::InSequence seq;
+    expectMillis(142);
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msg1));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msg2));
+    buffer.update();
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.getLongestStall(), 42);
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST_F(MIDIStallBufferTest, orderPreservedAfterUnstall) {
+    sourceA.stall(&staller);
+    ChannelMessage msg1 {0x93, 0x10, 0x7F};
+    ChannelMessage msg2 {0x83, 0x10, 0x7F};
+    expectMillis(0);
+    sourceB.sourceMIDItoPipe(msg1);
+    sourceA.unstall(&staller);
+    // The buffer isn't empty, so the new message is parked after msg1
+    sourceB.sourceMIDItoPipe(msg2);
+    ::testing::InSequence seq;
+    expectMillis(1);
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msg1));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msg2));
+    buffer.update();
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST_F(MIDIStallBufferTest, fullFallsBackToHandleStall) {
+    sourceA.stall(&staller);
+    ChannelMessage msgs[] {{0x90, 1, 1}, {0x90, 2, 2}, {0x90, 3, 3}};
+    expectMillis(0);
+    sourceB.sourceMIDItoPipe(msgs[0]);
+    sourceB.sourceMIDItoPipe(msgs[1]);
+
+    ::testing::InSequence seq;
+    EXPECT_CALL(staller, stallHandled());
+    expectMillis(5);
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msgs[0]));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msgs[1]));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msgs[2]));
+    sourceB.sourceMIDItoPipe(msgs[2]);
+    EXPECT_EQ(buffer.getNumberOfOverflows(), 1);
+    EXPECT_FALSE(sourceA.isStalled());
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST_F(MIDIStallBufferTest, stallFromSourcePassesThrough) {
+    StrictMock<MockMIDIStaller> stallerB {&sourceB};
+    sourceB.stall(&stallerB);
+    EXPECT_TRUE(sourceA.isStalled());
+    EXPECT_EQ(sourceA.getStaller(), &stallerB);
+    // The stall of our own source doesn't cause messages to be parked, it is
+    // handled as if there were no buffer
+    EXPECT_CALL(stallerB, stallHandled());
+    EXPECT_CALL(sink, sinkMIDIfromPipe(::testing::An<ChannelMessage>()));
+    buffer.sinkMIDIfromPipe(ChannelMessage {0x90, 0x10, 0x7F});
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_FALSE(sourceA.isStalled());
+    EXPECT_FALSE(sourceB.isStalled());
+}
+
+TEST(MIDIStallBuffer, parkSysEx) {
+    StrictMock<MockMIDI_Sink> sink;
+    TrueMIDI_Source sourceA, sourceB;
+    MIDI_PipeFactory<3> pipes;
+    MIDIStallBuffer<4, 1, 8> buffer;
+    StrictMock<MockMIDIStaller> staller {&sourceA};
+    sourceA >> pipes >> sink;
+    sourceB >> pipes >> buffer;
+    buffer >> pipes >> sink;
+
+    sourceA.stall(&staller);
+    uint8_t data[] {0xF0, 0x11, 0x22, 0xF7};
+    SysExMessage sysex {data, sizeof(data)};
+    ChannelMessage msg {0x93, 0x10, 0x7F};
+    EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillOnce(Return(0));
+    sourceB.sourceMIDItoPipe(sysex);
+    sourceB.sourceMIDItoPipe(msg);
+    // The message is copied, the original data can be reused
+    data[1] = 0x00;
+
+    // Only one SysEx slot: wait for the stall to be resolved
+    uint8_t data2[] {0xF0, 0x33, 0xF7};
+    SysExMessage sysex2 {data2, sizeof(data2)};
+    uint8_t expected[] {0xF0, 0x11, 0x22, 0xF7};
+    ::testing::InSequence seq;
+    EXPECT_CALL(staller, stallHandled());
+    EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillOnce(Return(3));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(SysExMessage {expected, 4}));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msg));
+    EXPECT_CALL(sink, sinkMIDIfromPipe(sysex2));
+    sourceB.sourceMIDItoPipe(sysex2);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.getNumberOfOverflows(), 0u);
+    EXPECT_EQ(buffer.getNumberOfSysExOverflows(), 1u);
+    EXPECT_EQ(buffer.getLongestStall(), 3u);
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
@@ -2270,3 +2270,131 @@ TEST(MIDI_Pipes, StreamMIDIInterfaceSysExChunks) {
     testing::Mock::VerifyAndClear(&midiB);
     testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
 }
+
+// -------------------------------------------------------------------------- //
+
+#include <MIDI_Interfaces/StaticMIDI_Pipe.hpp>
+
+TEST(StaticMIDI_Pipe, dropAndMapChannel) {
+    using namespace MIDIPipeStages;
+    StrictMock<MockMIDI_Sink> sink;
+    TrueMIDI_Source source;
+    StaticMIDI_Pipe<Drop<MIDIMessageType::ActiveSensing>, MapChannel<1, 3>>
+        pipe;
+    source >> pipe >> sink;
+
+    RealTimeMessage clock {MIDIMessageType::TimingClock, Cable_2};
+    EXPECT_CALL(sink, sinkMIDIfromPipe(clock));
+    source.sourceMIDItoPipe(clock);
+    source.sourceMIDItoPipe(RealTimeMessage {MIDIMessageType::ActiveSensing});
+    ::testing::Mock::VerifyAndClear(&sink);
+
+    ChannelMessage ch1 {MIDIMessageType::NoteOn, Channel_1, 0x10, 0x7F};
+    ChannelMessage ch3 {MIDIMessageType::NoteOn, Channel_3, 0x10, 0x7F};
+    ChannelMessage ch2 {MIDIMessageType::NoteOn, Channel_2, 0x10, 0x7F};
+    EXPECT_CALL(sink, sinkMIDIfromPipe(ch3)).Times(2);
+    EXPECT_CALL(sink, sinkMIDIfromPipe(ch2));
+    source.sourceMIDItoPipe(ch1);
+    source.sourceMIDItoPipe(ch3);
+    source.sourceMIDItoPipe(ch2);
+    ::testing::Mock::VerifyAndClear(&sink);
+
+    SysExMessage sysex {nullptr, 0, Cable_3};
+    EXPECT_CALL(sink, sinkMIDIfromPipe(sysex));
+    source.sourceMIDItoPipe(sysex);
+    ::testing::Mock::VerifyAndClear(&sink);
+}
+
+TEST(StaticMIDI_Pipe, stagesInOrder) {
+    using namespace MIDIPipeStages;
+    StrictMock<MockMIDI_Sink> sink1, sink2;
+    TrueMIDI_Source source;
+    // Only channel 2 after mapping, so channel 1 passes the first pipe
+    StaticMIDI_Pipe<MapChannel<1, 2>, OnlyChannel<2>, Transpose<12>> pipe1;
+    // But not the second one
+    StaticMIDI_Pipe<OnlyChannel<2>, MapChannel<1, 2>, MapCable<1, 5>> pipe2;
+    source >> pipe1 >> sink1;
+    source >> pipe2 >> sink2;
+
+    ChannelMessage note {MIDIMessageType::NoteOff, Channel_1, 0x70, 0x40};
+    ChannelMessage cc {MIDIMessageType::ControlChange, Channel_2, 0x70, 0x40};
+    EXPECT_CALL(sink1, sinkMIDIfromPipe(ChannelMessage {
+                           MIDIMessageType::NoteOff, Channel_2, 0x7C, 0x40}));
+    EXPECT_CALL(sink1, sinkMIDIfromPipe(cc));
+    EXPECT_CALL(sink2, sinkMIDIfromPipe(ChannelMessage {
+                           MIDIMessageType::ControlChange, Channel_2, 0x70,
+                           0x40, Cable_5}));
+    source.sourceMIDItoPipe(note);
+    source.sourceMIDItoPipe(cc);
+    ::testing::Mock::VerifyAndClear(&sink1);
+    ::testing::Mock::VerifyAndClear(&sink2);
+
+    // Notes transposed out of range are dropped
+    ChannelMessage high {MIDIMessageType::NoteOn, Channel_2, 0x78, 0x40};
+    EXPECT_CALL(sink2, sinkMIDIfromPipe(ChannelMessage {
+                           MIDIMessageType::NoteOn, Channel_2, 0x78, 0x40,
+                           Cable_5}));
+    source.sourceMIDItoPipe(high);
+    ::testing::Mock::VerifyAndClear(&sink1);
+    ::testing::Mock::VerifyAndClear(&sink2);
+
+    // Cable mapping applies to all message types
+    SysCommonMessage sc {MIDIMessageType::TuneRequest, Cable_1};
+    EXPECT_CALL(sink1, sinkMIDIfromPipe(sc));
+    EXPECT_CALL(sink2, sinkMIDIfromPipe(SysCommonMessage {
+                           MIDIMessageType::TuneRequest, Cable_5}));
+    source.sourceMIDItoPipe(sc);
+}
+
+TEST(StaticMIDI_Pipe, customStage) {
+    struct Velocity {
+        bool operator()(ChannelMessage &msg) const {
+            if (msg.getMessageType() == MIDIMessageType::NoteOn)
+                msg.data2 = value;
+            return true;
+        }
+        uint8_t value;
+    };
+    StrictMock<MockMIDI_Sink> sink;
+    TrueMIDI_Source source;
+    StaticMIDI_Pipe<Velocity> pipe {Velocity {0x20}};
+    source >> pipe >> sink;
+    EXPECT_CALL(sink, sinkMIDIfromPipe(ChannelMessage {0x91, 0x10, 0x20}));
+    source.sourceMIDItoPipe(ChannelMessage {0x91, 0x10, 0x7F});
+    ::testing::Mock::VerifyAndClear(&sink);
+    pipe.stages.first.value = 0x30;
+    EXPECT_CALL(sink, sinkMIDIfromPipe(ChannelMessage {0x91, 0x10, 0x30}));
+    source.sourceMIDItoPipe(ChannelMessage {0x91, 0x10, 0x7F});
+}
+
+TEST(StaticMIDI_Pipe, factoryAndBidirectional) {
+    using namespace MIDIPipeStages;
+    StrictMock<MockMIDI_Sink> sink1, sink2;
+    StrictMock<MockMIDI_SinkSource> sinksource;
+    TrueMIDI_Source source;
+    MIDI_PipeFactory<2, StaticMIDI_Pipe<MapChannel<1, 16>>> pipes;
+    source >> pipes >> sink1;
+    source >> pipes >> sink2;
+    // The second pipe carries messages from left to right
+    BidirectionalStaticMIDI_Pipe<StaticMIDI_Pipe<>,
+                                 StaticMIDI_Pipe<Drop<MIDIMessageType::Start>>>
+        bidi;
+    TrueMIDI_SinkSource &other = sinksource;
+    StrictMock<MockMIDI_SinkSource> sinksource2;
+    sinksource2 | bidi | other;
+
+    ChannelMessage msg {0x90, 0x10, 0x7F};
+    EXPECT_CALL(sink1, sinkMIDIfromPipe(ChannelMessage {0x9F, 0x10, 0x7F}));
+    EXPECT_CALL(sink2, sinkMIDIfromPipe(ChannelMessage {0x9F, 0x10, 0x7F}));
+    source.sourceMIDItoPipe(msg);
+    ::testing::Mock::VerifyAndClear(&sink1);
+    ::testing::Mock::VerifyAndClear(&sink2);
+
+    EXPECT_CALL(sinksource, sinkMIDIfromPipe(msg));
+    sinksource2.sourceMIDItoPipe(msg);
+    sinksource2.sourceMIDItoPipe(RealTimeMessage {MIDIMessageType::Start});
+    ::testing::Mock::VerifyAndClear(&sinksource);
+    RealTimeMessage start {MIDIMessageType::Start};
+    EXPECT_CALL(sinksource2, sinkMIDIfromPipe(start));
+    sinksource.sourceMIDItoPipe(start);
+}
@@ -0,0 +1,180 @@
+#include <MIDI_Interfaces/MIDI_RoutingMatrix.hpp>
+#include <MIDI_Interfaces/MIDI_Staller.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+USING_CS_NAMESPACE;
+using ::testing::StrictMock;
+
+namespace {
+
+struct MockMIDI_Sink : TrueMIDI_Sink {
+    MOCK_METHOD(void, sinkMIDIfromPipe, (ChannelMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (SysExMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (SysCommonMessage), (override));
+    MOCK_METHOD(void, sinkMIDIfromPipe, (RealTimeMessage), (override));
+};
+
+struct MockMIDIStaller : MIDIStaller {
+    MockMIDIStaller(MIDI_Source *stalled) : stalled(stalled) {}
+    MOCK_METHOD(void, stallHandled, ());
+    void handleStall() override {
+        stallHandled();
+        stalled->unstall(this);
+    }
+    MIDI_Source *stalled;
+};
+
+} // namespace
+
+TEST(MIDI_RoutingMatrix, routes) {
+    StrictMock<MockMIDI_Sink> sinks[3];
+    TrueMIDI_Source sources[2];
+    MIDI_RoutingMatrix<2, 3> matrix;
+    for (auto &source : sources)
+        matrix.addSource(source);
+    for (auto &sink : sinks)
+        matrix.addSink(sink);
+
+    matrix.route(0, 0);
+    matrix.route(0, 2);
+    matrix.route(1, 2);
+    EXPECT_TRUE(matrix.isRouted(0, 2));
+    EXPECT_FALSE(matrix.isRouted(1, 0));
+
+    ChannelMessage msg {0x93, 0x10, 0x7F, Cable_6};
+    EXPECT_CALL(sinks[0], sinkMIDIfromPipe(msg));
+    EXPECT_CALL(sinks[2], sinkMIDIfromPipe(msg));
+    sources[0].sourceMIDItoPipe(msg);
+    ::testing::Mock::VerifyAndClear(&sinks[0]);
+    ::testing::Mock::VerifyAndClear(&sinks[2]);
+
+    RealTimeMessage rt {0xF8, Cable_2};
+    EXPECT_CALL(sinks[2], sinkMIDIfromPipe(rt));
+    sources[1].sourceMIDItoPipe(rt);
+    ::testing::Mock::VerifyAndClear(&sinks[2]);
+
+    // Change the routes at run time
+    matrix.unroute(0, 2);
+    matrix.route(1, 1);
+    SysExMessage sysex {nullptr, 0, Cable_3};
+    EXPECT_CALL(sinks[0], sinkMIDIfromPipe(sysex));
+    sources[0].sourceMIDItoPipe(sysex);
+    EXPECT_CALL(sinks[1], sinkMIDIfromPipe(sysex));
+    EXPECT_CALL(sinks[2], sinkMIDIfromPipe(sysex));
+    sources[1].sourceMIDItoPipe(sysex);
+    ::testing::Mock::VerifyAndClear(&sinks[0]);
+    ::testing::Mock::VerifyAndClear(&sinks[1]);
+    ::testing::Mock::VerifyAndClear(&sinks[2]);
+
+    matrix.clearRoutes();
+    sources[0].sourceMIDItoPipe(msg);
+    sources[1].sourceMIDItoPipe(msg);
+}
+
+TEST(MIDI_RoutingMatrix, manySinks) {
+    StrictMock<MockMIDI_Sink> sinks[20];
+    TrueMIDI_Source source;
+    MIDI_RoutingMatrix<1, 20> matrix;
+    uint8_t src = matrix.addSource(source);
+    for (auto &sink : sinks)
+        matrix.addSink(sink);
+    for (uint8_t k : {0, 7, 8, 15, 19})
+        matrix.route(src, k);
+
+    ChannelMessage msg {0x93, 0x10, 0x7F};
+    for (uint8_t k : {0, 7, 8, 15, 19})
+        EXPECT_CALL(sinks[k], sinkMIDIfromPipe(msg));
+    source.sourceMIDItoPipe(msg);
+}
+
+TEST(MIDI_RoutingMatrix, invalidRoutes) {
+    MockMIDI_Sink sink;
+    TrueMIDI_Source source;
+    MIDI_RoutingMatrix<2, 3> matrix;
+    uint8_t src = matrix.addSource(source);
+    uint8_t dst = matrix.addSink(sink);
+    // Within the template capacity, but not added to the matrix
+    EXPECT_THROW(matrix.route(src + 1, dst), AH::ErrorException);
+    EXPECT_THROW(matrix.route(src, dst + 1), AH::ErrorException);
+    EXPECT_THROW(matrix.isRouted(src, 3), AH::ErrorException);
+    EXPECT_THROW(matrix.unroute(5, dst), AH::ErrorException);
+    EXPECT_NO_THROW(matrix.route(src, dst));
+    EXPECT_TRUE(matrix.isRouted(src, dst));
+}
+
+TEST(MIDI_RoutingMatrix, combinedWithPipes) {
+    StrictMock<MockMIDI_Sink> sinks[2];
+    TrueMIDI_Source sources[2];
+    MIDI_Pipe pipes[2];
+    MIDI_RoutingMatrix<1, 1> matrix;
+    // The source and sink of the matrix have normal pipes as well
+    sources[0] >> pipes[0] >> sinks[0];
+    sources[1] >> pipes[1] >> sinks[1];
+    matrix.route(matrix.addSource(sources[0]), matrix.addSink(sinks[1]));
+
+    ChannelMessage msg {0x93, 0x10, 0x7F};
+    EXPECT_CALL(sinks[0], sinkMIDIfromPipe(msg));
+    EXPECT_CALL(sinks[1], sinkMIDIfromPipe(msg));
+    sources[0].sourceMIDItoPipe(msg);
+    ::testing::Mock::VerifyAndClear(&sinks[0]);
+    ::testing::Mock::VerifyAndClear(&sinks[1]);
+
+    EXPECT_CALL(sinks[1], sinkMIDIfromPipe(msg));
+    sources[1].sourceMIDItoPipe(msg);
+}
+
+TEST(MIDI_RoutingMatrix, stall) {
+    StrictMock<MockMIDI_Sink> sinks[2];
+    TrueMIDI_Source sources[3];
+    MIDI_RoutingMatrix<3, 2> matrix;
+    for (auto &source : sources)
+        matrix.addSource(source);
+    for (auto &sink : sinks)
+        matrix.addSink(sink);
+    matrix.route(0, 0);
+    matrix.route(1, 0);
+    matrix.route(1, 1);
+    matrix.route(2, 1);
+
+    StrictMock<MockMIDIStaller> staller(&sources[0]);
+    sources[0].stall(&staller);
+    EXPECT_TRUE(sources[0].isStalled());
+    EXPECT_TRUE(sources[1].isStalled()); // shares sink 0 with source 0
+    EXPECT_FALSE(sources[2].isStalled());
+    EXPECT_EQ(sources[1].getStaller(), &staller);
+
+    // Sending from a source that has to wait for the staller
+    ChannelMessage msg {0x93, 0x10, 0x7F};
+    EXPECT_CALL(staller, stallHandled());
+    EXPECT_CALL(sinks[0], sinkMIDIfromPipe(msg));
+    EXPECT_CALL(sinks[1], sinkMIDIfromPipe(msg));
+    sources[1].sourceMIDItoPipe(msg);
+    EXPECT_FALSE(sources[0].isStalled());
+    EXPECT_FALSE(sources[1].isStalled());
+    EXPECT_FALSE(sources[2].isStalled());
+}
+
+TEST(MIDI_RoutingMatrix, stallFromOutside) {
+    StrictMock<MockMIDI_Sink> sink;
+    TrueMIDI_Source sources[2], outside;
+    MIDI_Pipe pipe;
+    MIDI_RoutingMatrix<2, 1> matrix;
+    outside >> pipe >> sink;
+    matrix.addSource(sources[0]);
+    matrix.addSource(sources[1]);
+    matrix.route(0, matrix.addSink(sink));
+
+    StrictMock<MockMIDIStaller> staller(&outside);
+    outside.stall(&staller);
+    EXPECT_TRUE(sources[0].isStalled());
+    EXPECT_FALSE(sources[1].isStalled());
+
+    ChannelMessage msg {0x93, 0x10, 0x7F};
+    EXPECT_CALL(staller, stallHandled());
+    EXPECT_CALL(sink, sinkMIDIfromPipe(msg));
+    sources[0].sourceMIDItoPipe(msg);
+    EXPECT_FALSE(sources[0].isStalled());
+    EXPECT_FALSE(outside.isStalled());
+}
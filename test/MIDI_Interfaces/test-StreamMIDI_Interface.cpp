@@ -1,5 +1,6 @@
 #include <MIDI_Interfaces/MIDI_Callbacks.hpp>
 #include <MIDI_Interfaces/SerialMIDI_Interface.hpp>
+#include <MIDI_Parsers/BufferPuller.hpp>
 #include <TestStream.hpp>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -72,6 +73,264 @@ TEST(StreamMIDI_Interface, SysExSend0B) {
     EXPECT_TRUE(stream.sent.empty());
 }
 
+TEST(StreamMIDI_Interface, transmitBufferRealTimeFirst) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    uint8_t txbuf[16];
+    midi.setTransmitBuffer(txbuf, sizeof(txbuf));
+
+    stream.writeSpace = 4;
+    u8vec sysex = {0xF0, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0xF7};
+    midi.send({sysex, Cable_1});
+    midi.sendNoteOn({0x55, Channel_4}, 0x66);
+    EXPECT_EQ(stream.sent, u8vec(sysex.begin(), sysex.begin() + 4));
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 7);
+
+    // The clock is sent before the rest of the SysEx message and the note
+    midi.sendRealTime(MIDIMessageType::TimingClock);
+    stream.writeSpace = 16;
+    midi.update();
+    u8vec expected = {
+        0xF0, 0x11, 0x22, 0x33, 0xF8,       //
+        0x44, 0x55, 0x66, 0xF7, 0x93, 0x55, //
+        0x66,                               //
+    };
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 0);
+}
+
+TEST(StreamMIDI_Interface, transmitBufferFullAndSendNow) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    uint8_t txbuf[4];
+    midi.setTransmitBuffer(txbuf, sizeof(txbuf));
+
+    // The stream doesn't accept any data without blocking, so everything is
+    // buffered until the buffer is full
+    midi.sendNoteOn({0x11, Channel_1}, 0x7F);
+    EXPECT_TRUE(stream.sent.empty());
+    midi.sendNoteOn({0x22, Channel_1}, 0x7F);
+    u8vec expected = {0x90, 0x11};
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 4);
+
+    // The buffer wraps around
+    midi.sendProgramChange({0x33, Channel_2});
+    expected = {0x90, 0x11, 0x7F, 0x90};
+    EXPECT_EQ(stream.sent, expected);
+
+    midi.sendNow();
+    expected = {0x90, 0x11, 0x7F, 0x90, 0x22, 0x7F, 0xC1, 0x33};
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 0);
+}
+
+TEST(StreamMIDI_Interface, transmitBufferUnknownWriteSpace) {
+    // Like many streams, TestStream reports zero bytes of write space by
+    // default, which means that it doesn't know
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    uint8_t txbuf[64];
+    midi.setTransmitBuffer(txbuf, sizeof(txbuf));
+
+    // A lone message is written by update, not only when the buffer is full
+    midi.sendNoteOn({0x11, Channel_1}, 0x7F);
+    EXPECT_TRUE(stream.sent.empty());
+    midi.update();
+    u8vec expected = {0x90, 0x11, 0x7F};
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 0);
+
+    // Longer messages are written entirely as well, like without transmit
+    // buffer
+    u8vec sysex(40, 0x55);
+    sysex.front() = 0xF0;
+    sysex.back() = 0xF7;
+    midi.send({sysex, Cable_1});
+    // Real-Time messages can still be sent before it
+    midi.sendRealTime(MIDIMessageType::TimingClock);
+    midi.update();
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 0);
+    expected.push_back(0xF8);
+    expected.insert(expected.end(), sysex.begin(), sysex.end());
+    EXPECT_EQ(stream.sent, expected);
+}
+
+TEST(StreamMIDI_Interface, transmitBufferKnownWriteSpace) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    uint8_t txbuf[64];
+    midi.setTransmitBuffer(txbuf, sizeof(txbuf));
+
+    // Once the stream has reported free space, zero means that it is full,
+    // and update doesn't block
+    stream.writeSpace = 2;
+    midi.sendNoteOn({0x11, Channel_1}, 0x7F);
+    u8vec expected = {0x90, 0x11};
+    EXPECT_EQ(stream.sent, expected);
+    midi.update();
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 1);
+    stream.writeSpace = 1;
+    midi.update();
+    expected.push_back(0x7F);
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 0);
+}
+
+TEST(StreamMIDI_Interface, batchedWrites) {
+    TestStream stream;
+    stream.writeSpace = 1000;
+    StreamMIDI_Interface midi = stream;
+    uint8_t txbuf[8];
+    midi.setTransmitBuffer(txbuf, sizeof(txbuf));
+    midi.enableBatchedWrites();
+
+    // Nothing is written until the batch is sent
+    midi.sendNoteOn({0x11, Channel_1}, 0x7F);
+    midi.sendProgramChange({0x22, Channel_1});
+    midi.sendRealTime(MIDIMessageType::TimingClock);
+    u8vec expected = {0xF8};
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 5);
+    midi.sendNow();
+    expected = {0xF8, 0x90, 0x11, 0x7F, 0xC0, 0x22};
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(stream.writeCalls, 1);
+
+    // When the buffer is full, the entire batch is written at once
+    midi.sendNoteOn({0x33, Channel_1}, 0x7F);
+    midi.sendNoteOn({0x44, Channel_1}, 0x7F);
+    midi.sendNoteOn({0x55, Channel_1}, 0x7F);
+    expected = {0xF8, 0x90, 0x11, 0x7F, 0xC0, 0x22,
+                0x90, 0x33, 0x7F, 0x90, 0x44, 0x7F};
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(stream.writeCalls, 2);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 3);
+
+    // Messages that are larger than the buffer are written directly
+    u8vec sysex = {0xF0, 1, 2, 3, 4, 5, 6, 7, 0xF7};
+    midi.send({sysex, Cable_1});
+    expected.insert(expected.end(), {0x90, 0x55, 0x7F});
+    expected.insert(expected.end(), sysex.begin(), sysex.end());
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(stream.writeCalls, 4);
+
+    // The end of the loop sends the batch
+    midi.sendControlChange({0x66, Channel_1}, 0x7F);
+    MIDI_Interface::endLoopAll();
+    expected.insert(expected.end(), {0xB0, 0x66, 0x7F});
+    EXPECT_EQ(stream.sent, expected);
+    EXPECT_EQ(stream.writeCalls, 5);
+    EXPECT_EQ(midi.getTransmitBufferUsage(), 0);
+}
+
+TEST(StreamMIDI_Interface, runningStatus) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    midi.enableRunningStatus();
+    midi.setNoteOffAsNoteOn();
+    midi.sendNoteOn({0x11, Channel_2}, 0x7F);
+    midi.sendNoteOff({0x11, Channel_2}, 0x40);
+    midi.sendRealTime(MIDIMessageType::TimingClock);
+    midi.sendNoteOn({0x22, Channel_2}, 0x7F);
+    midi.sendControlChange({0x07, Channel_2}, 0x10);
+    midi.sendControlChange({0x07, Channel_2}, 0x11);
+    midi.sendSysCommon(MIDIMessageType::TuneRequest);
+    midi.sendControlChange({0x07, Channel_2}, 0x12);
+    u8vec sysex = {0xF0, 0x11, 0xF7};
+    midi.send({sysex, Cable_1});
+    midi.sendControlChange({0x07, Channel_2}, 0x13);
+    midi.sendControlChange({0x07, Channel_2}, 0x14);
+    u8vec expected = {
+        0x91, 0x11, 0x7F, //
+        0x11, 0x00,       // Note Off as Note On with velocity zero
+        0xF8,             // Real-Time doesn't cancel running status
+        0x22, 0x7F,       //
+        0xB1, 0x07, 0x10, //
+        0x07, 0x11,       //
+        0xF6,             // System Common cancels running status
+        0xB1, 0x07, 0x12, //
+        0xF0, 0x11, 0xF7, // SysEx cancels running status
+        0xB1, 0x07, 0x13, //
+        0x07, 0x14,       //
+    };
+    EXPECT_EQ(stream.sent, expected);
+}
+
+TEST(StreamMIDI_Interface, runningStatusPolicy) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    midi.enableRunningStatus();
+    midi.setRunningStatusCancellation(false, false);
+    midi.setRunningStatusRefresh(2);
+    midi.sendNoteOn({0x11, Channel_1}, 0x7F);
+    midi.sendNoteOff({0x11, Channel_1}, 0x40);
+    midi.sendPitchBend(Channel_1, 0x0000);
+    midi.sendPitchBend(Channel_1, 0x0001);
+    midi.sendSysCommon(MIDIMessageType::TuneRequest);
+    u8vec sysex = {0xF0, 0x11, 0xF7};
+    midi.send({sysex, Cable_1});
+    midi.sendPitchBend(Channel_1, 0x0002);
+    midi.sendPitchBend(Channel_1, 0x0003);
+    midi.sendPitchBend(Channel_1, 0x0004);
+    u8vec expected = {
+        0x90, 0x11, 0x7F, //
+        0x80, 0x11, 0x40, // Note Off is sent as is
+        0xE0, 0x00, 0x00, //
+        0x01, 0x00,       //
+        0xF6,             //
+        0xF0, 0x11, 0xF7, //
+        0x02, 0x00,       // Running status was kept
+        0xE0, 0x03, 0x00, // Refreshed after two messages
+        0x04, 0x00,       //
+    };
+    EXPECT_EQ(stream.sent, expected);
+}
+
+TEST(StreamMIDI_Interface, runningStatusFaderAutomation) {
+    // Two faders (volume and pan) and a few notes on the same channel, and a
+    // third fader on a different channel, as recorded from a DAW.
+    std::vector<ChannelMessage> trace;
+    for (uint8_t t = 0; t < 128; ++t) {
+        trace.push_back({0xB0, 0x07, uint8_t(t)});
+        if (t % 2 == 0)
+            trace.push_back({0xB0, 0x0A, uint8_t(127 - t)});
+        if (t % 16 == 0)
+            trace.push_back({0xE1, uint8_t(t), 0x40});
+        if (t % 32 == 0)
+            trace.push_back({0x90, 0x3C, 0x7F});
+        if (t % 32 == 16)
+            trace.push_back({0x80, 0x3C, 0x40});
+    }
+
+    TestStream plain, compressed;
+    StreamMIDI_Interface midiPlain = plain, midiCompressed = compressed;
+    midiCompressed.enableRunningStatus();
+    midiCompressed.setNoteOffAsNoteOn();
+    midiCompressed.setRunningStatusRefresh(16);
+    for (auto msg : trace) {
+        midiPlain.send(msg);
+        midiCompressed.send(msg);
+    }
+    EXPECT_EQ(plain.sent.size(), 3 * trace.size());
+    // At least 25% fewer bytes (at most a third can be saved)
+    EXPECT_LT(compressed.sent.size() * 4, plain.sent.size() * 3);
+
+    // The receiver gets exactly the same messages
+    SerialMIDI_Parser parser;
+    auto puller = BufferPuller(compressed.sent);
+    for (auto msg : trace) {
+        ASSERT_EQ(parser.pull(puller), MIDIReadEvent::CHANNEL_MESSAGE);
+        if (msg.getMessageType() == MIDIMessageType::NoteOff) {
+            msg.setMessageType(MIDIMessageType::NoteOn);
+            msg.data2 = 0;
+        }
+        EXPECT_EQ(parser.getChannelMessage(), msg);
+    }
+    EXPECT_EQ(parser.pull(puller), MIDIReadEvent::NO_MESSAGE);
+}
+
 TEST(StreamMIDI_Interface, readRealTime) {
     TestStream stream;
     StreamMIDI_Interface midi = stream;
@@ -111,6 +370,46 @@ TEST(StreamMIDI_Interface, readSysEx) {
     EXPECT_EQ(sysex.cable, Cable_1);
 }
 
+TEST(StreamMIDI_Interface, readReceiveBuffer) {
+    TestStream stream;
+    StreamMIDI_Interface midi = stream;
+    uint8_t rxbuf[16];
+    midi.setReceiveBuffer(rxbuf, sizeof(rxbuf));
+    const SysExVector data = {
+        0x93, 0x3C, 0x60, 0x3D, 0x61,                   // Note On (running)
+        0xF0, 0x55, 0x66, 0x77, 0xF7,                   // SysEx in one block
+        0xF8,                                           // Real-Time
+        0xF0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0xF7, // SysEx over 2 blocks
+    };
+    for (auto v : data)
+        stream.toRead.push(v);
+
+    EXPECT_EQ(midi.read(), MIDIReadEvent::CHANNEL_MESSAGE);
+    EXPECT_EQ(midi.getChannelMessage(), ChannelMessage(0x93, 0x3C, 0x60));
+    EXPECT_EQ(midi.read(), MIDIReadEvent::CHANNEL_MESSAGE);
+    EXPECT_EQ(midi.getChannelMessage(), ChannelMessage(0x93, 0x3D, 0x61));
+
+    // SysEx message that fits in the receive buffer is not copied
+    EXPECT_EQ(midi.read(), MIDIReadEvent::SYSEX_MESSAGE);
+    SysExMessage sysex = midi.getSysExMessage();
+    EXPECT_EQ(sysex.data, rxbuf + 5);
+    EXPECT_EQ(SysExVector(sysex.data, sysex.data + sysex.length),
+              SysExVector(data.begin() + 5, data.begin() + 10));
+
+    EXPECT_EQ(midi.read(), MIDIReadEvent::REALTIME_MESSAGE);
+    EXPECT_EQ(midi.getRealTimeMessage(), RealTimeMessage(0xF8));
+
+    // SysEx message that crosses the end of the buffer is copied
+    EXPECT_EQ(midi.read(), MIDIReadEvent::SYSEX_MESSAGE);
+    sysex = midi.getSysExMessage();
+    EXPECT_FALSE(sysex.data >= rxbuf && sysex.data < rxbuf + sizeof(rxbuf));
+    EXPECT_EQ(SysExVector(sysex.data, sysex.data + sysex.length),
+              SysExVector(data.begin() + 11, data.end()));
+
+    EXPECT_EQ(midi.read(), MIDIReadEvent::NO_MESSAGE);
+    EXPECT_TRUE(stream.toRead.empty());
+}
+
 TEST(StreamMIDI_Interface, readNoteUpdate) {
     class MockMIDI_Callbacks : public MIDI_Callbacks {
       public:
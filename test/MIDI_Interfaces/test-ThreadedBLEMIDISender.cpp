@@ -0,0 +1,185 @@
+#include <MIDI_Interfaces/BLEMIDI/ThreadedBLEMIDISender.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using namespace std::chrono_literals;
+using bvec = std::vector<uint8_t>;
+
+struct StubBLESender
+    : ThreadedBLEMIDISender<StubBLESender, StaticBLEMIDIPacketBuilder<64>> {
+    using Sender =
+        ThreadedBLEMIDISender<StubBLESender, StaticBLEMIDIPacketBuilder<64>>;
+    friend Sender;
+
+    StubBLESender() { updateMTU(64 + 3); }
+    // All data should be sent before the members of this class are destroyed
+    ~StubBLESender() { waitUntilSent(); }
+
+    void add(uint8_t data1, uint8_t data2) {
+        auto lck = acquirePacket();
+        if (!lck.packet->add3B(0x90, data1, data2, 0)) {
+            do
+                sendNow(lck);
+            while (!lck.packet->add3B(0x90, data1, data2, 0));
+        }
+        releasePacketAndNotify(lck);
+    }
+    void flush() {
+        auto lck = acquirePacket();
+        sendNow(lck);
+    }
+    std::vector<bvec> getSent() {
+        std::lock_guard<std::mutex> lck {mtx};
+        return sent;
+    }
+    size_t getNumberOfSent() {
+        std::lock_guard<std::mutex> lck {mtx};
+        return sent.size();
+    }
+
+    std::chrono::milliseconds delay {0};
+    std::atomic<bool> sending {false};
+
+  private:
+    void sendData(BLEDataView data) {
+        sending.store(true);
+        std::this_thread::sleep_for(delay);
+        {
+            std::lock_guard<std::mutex> lck {mtx};
+            sent.emplace_back(data.data, data.data + data.length);
+        }
+        sending.store(false);
+    }
+
+    std::mutex mtx;
+    std::vector<bvec> sent;
+};
+
+TEST(ThreadedBLEMIDISender, sendNowDoesNotBlock) {
+    StubBLESender sender;
+    sender.delay = 100ms;
+    sender.setTimeout(10s);
+    sender.begin();
+
+    sender.add(0x10, 0x11);
+    sender.flush();
+    while (!sender.sending.load())
+        std::this_thread::yield();
+    // The first packet is still being sent, the second one shouldn't wait
+    auto t0 = std::chrono::steady_clock::now();
+    sender.add(0x20, 0x21);
+    sender.flush();
+    auto t1 = std::chrono::steady_clock::now();
+    EXPECT_LT(t1 - t0, 50ms);
+
+    sender.waitUntilSent();
+    std::vector<bvec> expected {
+        {0x80, 0x80, 0x90, 0x10, 0x11},
+        {0x80, 0x80, 0x90, 0x20, 0x21},
+    };
+    EXPECT_EQ(sender.getSent(), expected);
+}
+
+TEST(ThreadedBLEMIDISender, timeout) {
+    StubBLESender sender;
+    sender.setTimeout(20ms);
+    sender.begin();
+
+    auto t0 = std::chrono::steady_clock::now();
+    sender.add(0x10, 0x11);
+    sender.add(0x12, 0x13);
+    while (sender.getNumberOfSent() == 0)
+        std::this_thread::sleep_for(1ms);
+    auto t1 = std::chrono::steady_clock::now();
+    EXPECT_GE(t1 - t0, 20ms);
+
+    std::vector<bvec> expected {{0x80, 0x80, 0x90, 0x10, 0x11, 0x12, 0x13}};
+    EXPECT_EQ(sender.getSent(), expected);
+}
+
+TEST(ThreadedBLEMIDISender, connectionParameters) {
+    StubBLESender sender;
+    sender.setTimeout(30ms);
+    sender.begin();
+    sender.updateConnectionParameters(2, 4); // 2.5 ms
+    EXPECT_EQ(sender.getConnectionInterval(), 2u);
+    EXPECT_EQ(sender.getPeripheralLatency(), 4u);
+
+    // The times of the connection events are not known, so the timeout is
+    // still used
+    auto t0 = std::chrono::steady_clock::now();
+    sender.add(0x10, 0x11);
+    while (sender.getNumberOfSent() == 0)
+        std::this_thread::sleep_for(1ms);
+    auto t1 = std::chrono::steady_clock::now();
+    EXPECT_GE(t1 - t0, 29ms);
+}
+
+TEST(ThreadedBLEMIDISender, maxNotificationsPerEvent) {
+    StubBLESender sender;
+    sender.updateConnectionParameters(40, 0); // 50 ms
+    sender.setMaxNotificationsPerEvent(1);
+    sender.begin();
+
+    // Only one notification per connection event: the second packet has to
+    // wait for the next event (and the third message may be added to it)
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint8_t i = 0; i < 3; ++i) {
+        sender.add(i, i);
+        sender.flush();
+    }
+    sender.waitUntilSent();
+    auto t1 = std::chrono::steady_clock::now();
+    EXPECT_GE(t1 - t0, 49ms);
+    auto sent = sender.getSent();
+    ASSERT_GE(sent.size(), 2u);
+    EXPECT_EQ(sent[0], (bvec {0x80, 0x80, 0x90, 0x00, 0x00}));
+    bvec data;
+    for (auto &packet : sent)
+        for (uint8_t b : packet)
+            if (b < 0x80)
+                data.push_back(b);
+    EXPECT_EQ(data, (bvec {0, 0, 1, 1, 2, 2}));
+}
+
+TEST(ThreadedBLEMIDISender, stressInOrder) {
+    StubBLESender sender;
+    sender.setTimeout(1ms);
+    sender.begin();
+
+    // The main thread fills the packets while the sender thread concurrently
+    // takes them because of the timeout, or because they're handed off
+    const uint16_t count = 1 << 14;
+    std::thread producer {[&] {
+        for (uint16_t i = 0; i < count; ++i) {
+            sender.add(i & 0x7F, i >> 7);
+            if (i % 97 == 0)
+                sender.flush();
+        }
+        sender.flush();
+    }};
+    producer.join();
+    sender.waitUntilSent();
+
+    // Only the data bytes are below 0x80
+    bvec data;
+    for (auto &packet : sender.getSent()) {
+        EXPECT_LE(packet.size(), 64u);
+        for (uint8_t b : packet)
+            if (b < 0x80)
+                data.push_back(b);
+    }
+    ASSERT_EQ(data.size(), 2u * count);
+    for (uint16_t i = 0; i < count; ++i) {
+        EXPECT_EQ(data[2 * i + 0], i & 0x7F) << i;
+        EXPECT_EQ(data[2 * i + 1], i >> 7) << i;
+    }
+}
@@ -1,3 +1,4 @@
+#include <MIDI_Interfaces/USBMIDI/LowLevel/BulkRX.hpp>
 #include <MIDI_Interfaces/USBMIDI/LowLevel/BulkTX.hpp>
 
 #include <gmock/gmock.h>
@@ -5,7 +6,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <numeric>
 #include <random>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -13,7 +16,9 @@ namespace {
 
 constexpr uint16_t PacketSize = 64;
 
-struct TestBulkTX : cs::BulkTX<TestBulkTX, uint32_t, PacketSize> {
+template <uint8_t NumBuffers>
+struct TestBulkTX
+    : cs::BulkTX<TestBulkTX<NumBuffers>, uint32_t, PacketSize, NumBuffers> {
     void start_timeout();
     void cancel_timeout();
     void tx_start(const void *data, uint32_t size);
@@ -24,6 +29,8 @@ struct TestBulkTX : cs::BulkTX<TestBulkTX, uint32_t, PacketSize> {
     bool connectedForWrite() const { return true; }
 
     timer_t timeout_timerid {}, write_timerid {};
+    /// Duration of a simulated USB transfer.
+    uint32_t transfer_us = 1;
     itimerspec timeout_its {}, write_its {};
 
     std::vector<uint32_t> data_challenge;
@@ -34,21 +41,18 @@ struct TestBulkTX : cs::BulkTX<TestBulkTX, uint32_t, PacketSize> {
     TestBulkTX(const TestBulkTX &) = delete;
     const TestBulkTX &operator=(const TestBulkTX &) = delete;
 
-    friend void timeout_handler(int, siginfo_t *, void *context);
-    friend void write_handler(int, siginfo_t *, void *context);
+    static void timeout_handler(int, siginfo_t *info, void *) {
+        auto *self = reinterpret_cast<TestBulkTX *>(info->si_value.sival_ptr);
+        self->timeout_callback();
+    }
+    static void write_handler(int, siginfo_t *info, void *) {
+        auto *self = reinterpret_cast<TestBulkTX *>(info->si_value.sival_ptr);
+        self->tx_callback();
+    }
 };
 
-void timeout_handler(int, siginfo_t *info, void *) {
-    auto *self = reinterpret_cast<TestBulkTX *>(info->si_value.sival_ptr);
-    self->timeout_callback();
-}
-
-void write_handler(int, siginfo_t *info, void *) {
-    auto *self = reinterpret_cast<TestBulkTX *>(info->si_value.sival_ptr);
-    self->tx_callback();
-}
-
-TestBulkTX::TestBulkTX() {
+template <uint8_t NumBuffers>
+TestBulkTX<NumBuffers>::TestBulkTX() {
     // Set up the signal handler
     struct sigaction timeout_sa {};
     timeout_sa.sa_flags = SA_SIGINFO;
@@ -88,26 +92,30 @@ TestBulkTX::TestBulkTX() {
     write_its.it_interval.tv_nsec = 0;
 }
 
-TestBulkTX::~TestBulkTX() {
+template <uint8_t NumBuffers>
+TestBulkTX<NumBuffers>::~TestBulkTX() {
     timer_delete(timeout_timerid);
     timer_delete(write_timerid);
 }
 
-void TestBulkTX::start_timeout() {
+template <uint8_t NumBuffers>
+void TestBulkTX<NumBuffers>::start_timeout() {
     std::chrono::microseconds us {10};
     timeout_its.it_value.tv_sec = 0;
     timeout_its.it_value.tv_nsec = 1000 * us.count();
     timer_settime(timeout_timerid, 0, &timeout_its, NULL);
 }
 
-void TestBulkTX::cancel_timeout() {
+template <uint8_t NumBuffers>
+void TestBulkTX<NumBuffers>::cancel_timeout() {
     timeout_its.it_value.tv_sec = 0;
     timeout_its.it_value.tv_nsec = 0;
     timer_settime(timeout_timerid, 0, &timeout_its, NULL);
 }
 
-void TestBulkTX::tx_start(const void *data, uint32_t size) {
-    std::chrono::microseconds us {1};
+template <uint8_t NumBuffers>
+void TestBulkTX<NumBuffers>::tx_start(const void *data, uint32_t size) {
+    std::chrono::microseconds us {transfer_us};
     EXPECT_GT(size, 0);
     static_assert(sizeof(uint32_t) == 4);
     auto it = data_response.insert(data_response.end(), size / 4, uint32_t {0});
@@ -117,7 +125,8 @@ void TestBulkTX::tx_start(const void *data, uint32_t size) {
     timer_settime(write_timerid, 0, &write_its, NULL);
 }
 
-void run_experiment(TestBulkTX &midi) {
+template <uint8_t NumBuffers>
+void run_experiment(TestBulkTX<NumBuffers> &midi) {
     using std::chrono::microseconds;
     size_t i = 0;
     size_t pi = 0;
@@ -141,12 +150,161 @@ void run_experiment(TestBulkTX &midi) {
     EXPECT_TRUE(midi.is_done());
 }
 
+/// Simulation of a BulkTX driver with a virtual clock (in microseconds). The
+/// host polls the bulk IN endpoint whenever the bus is idle, so a transfer
+/// completes shortly after it is started.
+struct SimBulkTX : cs::BulkTX<SimBulkTX, uint32_t, PacketSize> {
+    void start_timeout() {
+        timeout_armed = true;
+        deadline = now + timeout_us;
+    }
+    void cancel_timeout() { timeout_armed = false; }
+    void tx_start(const void *data, uint32_t size) {
+        EXPECT_TRUE(in_flight.empty());
+        in_flight.resize(size / 4);
+        std::memcpy(in_flight.data(), data, size);
+        done_at = now + transfer_us;
+        ++packets;
+    }
+    void tx_start_timeout(const void *data, uint32_t size) {
+        tx_start(data, size);
+    }
+    void tx_start_isr(const void *data, uint32_t size) { tx_start(data, size); }
+    bool connectedForWrite() const { return true; }
+
+    /// Advance the clock by the given number of microseconds.
+    void tick(uint32_t us) {
+        for (uint32_t i = 0; i < us; ++i) {
+            ++now;
+            if (timeout_armed && now >= deadline) {
+                timeout_armed = false;
+                timeout_callback();
+            }
+            if (!in_flight.empty() && now >= done_at) {
+                for (uint32_t msg : in_flight) {
+                    uint32_t latency = now - written_at[msg];
+                    total_latency += latency;
+                    max_latency = std::max(max_latency, latency);
+                    received.push_back(msg);
+                }
+                in_flight.clear();
+                tx_callback();
+            }
+        }
+    }
+    /// Write a message, and remember when it was written.
+    void write_msg() {
+        uint32_t msg = written_at.size();
+        written_at.push_back(now);
+        write(msg);
+    }
+
+    using BulkTX::is_done;
+    using BulkTX::send_now;
+    using BulkTX::write;
+
+    uint32_t now = 0;
+    uint32_t timeout_us = 1000;
+    uint32_t deadline = 0;
+    /// Time it takes to transfer a packet.
+    uint32_t transfer_us = 20;
+    uint32_t done_at = 0;
+    bool timeout_armed = false;
+    std::vector<uint32_t> in_flight;
+    std::vector<uint32_t> written_at {0};
+    std::vector<uint32_t> received;
+    uint32_t packets = 0;
+    uint64_t total_latency = 0;
+    uint32_t max_latency = 0;
+};
+
+enum class FlushPolicy { Immediate, Timeout, EndOfLoop };
+
+struct FlushResult {
+    double packets_per_msg, mean_latency_us;
+    uint32_t max_latency_us;
+};
+
+/// Controller that sends 0 to 3 messages per 200 µs loop iteration for two
+/// second, flushing the BulkTX buffer according to the given policy.
+FlushResult simulate_flush_policy(FlushPolicy policy) {
+    std::default_random_engine rng {12345};
+    std::uniform_int_distribution<int> num_msgs {0, 3};
+    SimBulkTX tx;
+    tx.tick(50);
+    for (int i = 0; i < 10'000; ++i) {
+        for (int n = num_msgs(rng); n > 0; --n) {
+            tx.write_msg();
+            if (policy == FlushPolicy::Immediate)
+                tx.send_now();
+            tx.tick(10);
+        }
+        if (policy == FlushPolicy::EndOfLoop)
+            tx.send_now();
+        tx.tick(200 - tx.now % 200);
+    }
+    tx.send_now();
+    tx.tick(5000);
+    EXPECT_TRUE(tx.is_done());
+    std::vector<uint32_t> expected(tx.written_at.size() - 1);
+    std::iota(expected.begin(), expected.end(), 1);
+    EXPECT_EQ(tx.received, expected);
+    return {
+        double(tx.packets) / expected.size(),
+        double(tx.total_latency) / expected.size(),
+        tx.max_latency,
+    };
+}
+
+struct TestBulkRX : cs::BulkRX<TestBulkRX, uint32_t, PacketSize> {
+    using BulkRX::reset;
+    using BulkRX::rx_callback;
+    void rx_start(void *data, uint32_t size) {
+        rx_buffer = static_cast<uint32_t *>(data);
+        rx_size = size;
+        ++rx_starts;
+    }
+    void rx_start_isr(void *data, uint32_t size) { rx_start(data, size); }
+
+    /// Simulate the reception of a packet with the given messages.
+    void receive(std::initializer_list<uint32_t> msgs) {
+        ASSERT_GE(rx_size, msgs.size() * sizeof(uint32_t));
+        std::copy(msgs.begin(), msgs.end(), rx_buffer);
+        rx_callback(msgs.size() * sizeof(uint32_t));
+    }
+
+    uint32_t *rx_buffer = nullptr;
+    uint32_t rx_size = 0;
+    unsigned rx_starts = 0;
+};
+
 } // namespace
 
+TEST(USB, BulkTXFlushPolicy) {
+    const std::string names[] {"immediate", "timeout", "end_of_loop"};
+    FlushResult results[3];
+    for (int i = 0; i < 3; ++i) {
+        results[i] = simulate_flush_policy(FlushPolicy(i));
+        RecordProperty(names[i] + "_packets_per_msg",
+                       std::to_string(results[i].packets_per_msg));
+        RecordProperty(names[i] + "_latency_us",
+                       std::to_string(results[i].mean_latency_us));
+        RecordProperty(names[i] + "_max_latency_us",
+                       std::to_string(results[i].max_latency_us));
+    }
+    auto [immediate, timeout, end_of_loop] = results;
+    // Batching uses far fewer packets than sending every message immediately
+    EXPECT_LT(timeout.packets_per_msg, immediate.packets_per_msg / 4);
+    EXPECT_LT(end_of_loop.packets_per_msg, immediate.packets_per_msg);
+    // Sending at the end of the loop only adds the duration of the loop
+    EXPECT_LE(end_of_loop.max_latency_us, 200);
+    EXPECT_LT(end_of_loop.mean_latency_us, timeout.mean_latency_us);
+}
+
 TEST(USB, BulkTX) {
     std::default_random_engine rng {12345};
     std::uniform_int_distribution<uint32_t> uniform;
-    TestBulkTX tx;
+    TestBulkTX<2> tx;
     tx.data_challenge.resize(1024 * 1024);
     tx.data_response.reserve(tx.data_challenge.size());
     std::generate(tx.data_challenge.begin(), tx.data_challenge.end(),
@@ -154,3 +312,100 @@ TEST(USB, BulkTX) {
     run_experiment(tx);
     EXPECT_EQ(tx.data_challenge, tx.data_response);
 }
+
+TEST(USB, BulkTXRing) {
+    std::default_random_engine rng {54321};
+    std::uniform_int_distribution<uint32_t> uniform;
+    TestBulkTX<8> tx;
+    tx.data_challenge.resize(256 * 1024);
+    tx.data_response.reserve(tx.data_challenge.size());
+    std::generate(tx.data_challenge.begin(), tx.data_challenge.end(),
+                  [&] { return uniform(rng); });
+    run_experiment(tx);
+    EXPECT_EQ(tx.data_challenge, tx.data_response);
+    EXPECT_LE(tx.getMaxQueueDepth(), 7);
+}
+
+template <uint8_t NumBuffers>
+void run_burst(TestBulkTX<NumBuffers> &tx) {
+    std::default_random_engine rng {12345};
+    std::uniform_int_distribution<uint32_t> uniform;
+    tx.data_challenge.resize(16 * 1024);
+    std::generate(tx.data_challenge.begin(), tx.data_challenge.end(),
+                  [&] { return uniform(rng); });
+    // Write large bursts, like a SysEx dump, much faster than the transfers
+    // can complete
+    tx.transfer_us = 100;
+    for (size_t i = 0; i < tx.data_challenge.size(); i += 1024)
+        tx.write(tx.data_challenge.data() + i, 1024);
+    tx.send_now();
+    std::this_thread::sleep_for(std::chrono::microseconds {100'000});
+    EXPECT_TRUE(tx.is_done());
+    EXPECT_EQ(tx.data_challenge, tx.data_response);
+    EXPECT_EQ(tx.getQueueDepth(), 0);
+}
+
+TEST(USB, BulkTXStatistics) {
+    TestBulkTX<2> tx2;
+    run_burst(tx2);
+    EXPECT_EQ(tx2.getMaxQueueDepth(), 1);
+    EXPECT_GT(tx2.getStallTime(), 0);
+    EXPECT_EQ(tx2.clearMaxQueueDepth(), 1);
+    EXPECT_EQ(tx2.getMaxQueueDepth(), 0);
+    EXPECT_GT(tx2.clearStallTime(), 0);
+    EXPECT_EQ(tx2.getStallTime(), 0);
+
+    TestBulkTX<8> tx8;
+    run_burst(tx8);
+    EXPECT_EQ(tx8.getMaxQueueDepth(), 7);
+    EXPECT_GT(tx8.getStallTime(), 0);
+}
+
+TEST(USB, BulkRXPacketView) {
+    TestBulkRX rx;
+    rx.reset();
+    EXPECT_EQ(rx.rx_starts, 1);
+    EXPECT_TRUE(rx.peek_packet().empty());
+
+    rx.receive({1, 2, 3});
+    rx.receive({4, 5});
+    auto packet = rx.peek_packet();
+    EXPECT_THAT(std::vector<uint32_t>(packet.begin(), packet.end()),
+                testing::ElementsAre(1, 2, 3));
+    rx.consume(2);
+    packet = rx.peek_packet();
+    EXPECT_THAT(std::vector<uint32_t>(packet.begin(), packet.end()),
+                testing::ElementsAre(3));
+    rx.consume(1);
+    packet = rx.peek_packet();
+    EXPECT_THAT(std::vector<uint32_t>(packet.begin(), packet.end()),
+                testing::ElementsAre(4, 5));
+    uint32_t msg = 0;
+    EXPECT_TRUE(rx.read(msg));
+    EXPECT_EQ(msg, 4);
+    EXPECT_TRUE(rx.read(msg));
+    EXPECT_EQ(msg, 5);
+    EXPECT_FALSE(rx.read(msg));
+    EXPECT_TRUE(rx.peek_packet().empty());
+}
+
+TEST(USB, BulkRXReadMany) {
+    TestBulkRX rx;
+    rx.reset();
+    uint32_t next = 0, expected = 0;
+    // Go around the ring of receive buffers a couple of times, and let it
+    // fill up completely so reception has to be restarted by the reader
+    for (int i = 0; i < 8; ++i) {
+        unsigned starts = rx.rx_starts;
+        for (int j = 0; j < 16; ++j, next += 3)
+            rx.receive({next, next + 1, next + 2});
+        EXPECT_EQ(rx.rx_starts, starts + 15); // last buffer fills the ring
+        uint32_t msgs[20];
+        uint32_t count;
+        while ((count = rx.read_many(msgs, 20)) > 0)
+            for (uint32_t k = 0; k < count; ++k)
+                EXPECT_EQ(msgs[k], expected++);
+        EXPECT_EQ(rx.rx_starts, starts + 16); // restarted after reading
+    }
+    EXPECT_EQ(expected, next);
+}
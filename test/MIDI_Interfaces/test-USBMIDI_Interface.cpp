@@ -28,6 +28,71 @@ TEST(USBMIDI_Interface, RealTime) {
     midi.sendRealTime(MIDIMessageType::TimingClock, Cable_9);
 }
 
+TEST(USBMIDI_Interface, sendAtEndOfLoop) {
+    StrictMock<USBMIDI_Interface> midi;
+    midi.neverSendImmediately();
+    midi.sendAtEndOfLoop();
+    Sequence seq;
+    EXPECT_CALL(midi.backend, write(0x89, 0x93, 0x55, 0x66)).InSequence(seq);
+    EXPECT_CALL(midi.backend, write(0x8C, 0xC3, 0x66, 0x00)).InSequence(seq);
+    EXPECT_CALL(midi.backend, sendNow()).InSequence(seq);
+    midi.sendNoteOn({0x55, Channel_4, Cable_9}, 0x66);
+    midi.sendProgramChange({Channel_4, Cable_9}, 0x66);
+    MIDI_Interface::endLoopAll();
+}
+
+namespace {
+/// Backend that gives access to entire received USB packets at once.
+struct PacketUSBMIDIBackend {
+    using MIDIUSBPacket_t = AH::Array<uint8_t, 4>;
+    struct PacketView {
+        const uint32_t *data;
+        uint32_t size;
+        const uint32_t *begin() const { return data; }
+        const uint32_t *end() const { return data + size; }
+        bool empty() const { return size == 0; }
+    };
+    std::vector<std::vector<uint32_t>> packets;
+    size_t packet = 0, index = 0;
+    std::vector<uint32_t> consumed;
+
+    PacketView peekPacket() {
+        if (packet == packets.size())
+            return {nullptr, 0};
+        return {packets[packet].data() + index,
+                uint32_t(packets[packet].size() - index)};
+    }
+    void consume(uint32_t n) {
+        consumed.push_back(n);
+        if (n > 0 && (index += n) == packets[packet].size())
+            ++packet, index = 0;
+    }
+    MIDIUSBPacket_t read() { return {}; }
+    void write(MIDIUSBPacket_t) {}
+    void sendNow() {}
+    static bool preferImmediateSend() { return false; }
+};
+} // namespace
+
+TEST(USBMIDI_Interface, readPackets) {
+    GenericUSBMIDI_Interface<PacketUSBMIDIBackend> midi;
+    midi.backend.packets = {
+        {0x7F3C9009, 0x0201F004}, // Note On, SysEx start
+        {0x00F70306, 0x4007B00B}, // SysEx end, Control Change
+    };
+    EXPECT_EQ(midi.read(), MIDIReadEvent::CHANNEL_MESSAGE);
+    EXPECT_EQ(midi.getChannelMessage(), (ChannelMessage {0x90, 0x3C, 0x7F}));
+    EXPECT_EQ(midi.read(), MIDIReadEvent::SYSEX_MESSAGE);
+    std::vector<uint8_t> sysex(midi.getSysExMessage().data,
+                               midi.getSysExMessage().data +
+                                   midi.getSysExMessage().length);
+    EXPECT_THAT(sysex, testing::ElementsAre(0xF0, 0x01, 0x02, 0x03, 0xF7));
+    EXPECT_EQ(midi.read(), MIDIReadEvent::CHANNEL_MESSAGE);
+    EXPECT_EQ(midi.getChannelMessage(), (ChannelMessage {0xB0, 0x07, 0x40}));
+    EXPECT_EQ(midi.read(), MIDIReadEvent::NO_MESSAGE);
+    EXPECT_THAT(midi.backend.consumed, testing::ElementsAre(1, 1, 1, 1, 0));
+}
+
 TEST(USBMIDI_Interface, SysExSend3B) {
     StrictMock<USBMIDI_Interface> midi;
     Sequence seq;
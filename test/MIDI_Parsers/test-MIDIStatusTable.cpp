@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <MIDI_Parsers/MIDIStatusTable.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+
+using namespace cs;
+
+TEST(MIDIStatusTable, statusBytes) {
+    for (unsigned s = 0; s <= 0xFF; ++s) {
+        MIDIMessage msg {uint8_t(s), 0, 0};
+        MIDIStatusInfo info = getMIDIStatusInfo(s);
+        if (s < 0x80) {
+            EXPECT_EQ(info.getClass(), MIDIStatusClass::None) << s;
+        } else if (msg.hasValidChannelMessageHeader()) {
+            EXPECT_EQ(info.getClass(), MIDIStatusClass::Channel) << s;
+            EXPECT_EQ(info.getLength(),
+                      ChannelMessage(msg).hasTwoDataBytes() ? 2 : 1)
+                << s;
+            EXPECT_TRUE(info.isRunningStatus()) << s;
+        } else if (s == 0xF0) {
+            EXPECT_EQ(info.getClass(), MIDIStatusClass::SysExStart);
+            EXPECT_FALSE(info.isRunningStatus());
+        } else if (s == 0xF7) {
+            EXPECT_EQ(info.getClass(), MIDIStatusClass::SysExEnd);
+            EXPECT_FALSE(info.isRunningStatus());
+        } else if (msg.hasValidSystemCommonHeader()) {
+            EXPECT_EQ(info.getClass(), MIDIStatusClass::SysCommon) << s;
+            EXPECT_FALSE(info.isRunningStatus()) << s;
+            EXPECT_EQ(info.getLength(),
+                      SysCommonMessage(msg).getNumberOfDataBytes())
+                << s;
+        } else {
+            EXPECT_EQ(info.getClass(), MIDIStatusClass::RealTime) << s;
+            EXPECT_EQ(info.getLength(), 0) << s;
+            EXPECT_FALSE(info.isRunningStatus()) << s;
+        }
+    }
+}
+
+TEST(MIDIStatusTable, codeIndexNumbers) {
+    using M = MIDIStatusClass;
+    using CIN = MIDICodeIndexNumber;
+    auto check = [](CIN cin, M cls, uint8_t len) {
+        MIDIStatusInfo info = getUSBMIDIStatusInfo(uint8_t(cin));
+        EXPECT_EQ(info.getClass(), cls) << int(cin);
+        EXPECT_EQ(info.getLength(), len) << int(cin);
+    };
+    check(CIN::MiscFunctionCodes, M::None, 0);
+    check(CIN::CableEvents, M::None, 0);
+    check(CIN::SystemCommon2B, M::SysCommon, 2);
+    check(CIN::SystemCommon3B, M::SysCommon, 3);
+    check(CIN::SysExStartCont, M::SysExStart, 3);
+    check(CIN::SysExEnd1B, M::SysExEnd, 1);
+    check(CIN::SysExEnd2B, M::SysExEnd, 2);
+    check(CIN::SysExEnd3B, M::SysExEnd, 3);
+    check(CIN::NoteOff, M::Channel, 3);
+    check(CIN::NoteOn, M::Channel, 3);
+    check(CIN::KeyPressure, M::Channel, 3);
+    check(CIN::ControlChange, M::Channel, 3);
+    check(CIN::ProgramChange, M::Channel, 2);
+    check(CIN::ChannelPressure, M::Channel, 2);
+    check(CIN::PitchBend, M::Channel, 3);
+    check(CIN::SingleByte, M::RealTime, 1);
+    // The cable number in the upper nibble is ignored
+    EXPECT_EQ(getUSBMIDIStatusInfo(0x59).getClass(), M::Channel);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <MIDI_Parsers/BufferPuller.hpp>
+#include <MIDI_Parsers/SysExArena.hpp>
+#include <MIDI_Parsers/USBMIDI_Parser.hpp>
+
+#include <vector>
+
+using namespace cs;
+
+using Packet_t = USBMIDI_Parser::MIDIUSBPacket_t;
+
+namespace {
+
+std::vector<uint8_t> data(uint8_t first, uint16_t len) {
+    std::vector<uint8_t> v(len);
+    for (auto &d : v)
+        d = first++ & 0x7F;
+    return v;
+}
+
+/// Split a SysEx message into USB MIDI packets for the given cable.
+std::vector<Packet_t> packetize(std::vector<uint8_t> msg, uint8_t cable) {
+    std::vector<Packet_t> packets;
+    auto it = msg.begin();
+    size_t length = msg.size();
+    uint8_t c = cable << 4;
+    while (length > 3) {
+        packets.push_back({uint8_t(c | 0x4), it[0], it[1], it[2]});
+        it += 3, length -= 3;
+    }
+    switch (length) {
+        case 3: packets.push_back({uint8_t(c | 0x7), it[0], it[1], it[2]}); break;
+        case 2: packets.push_back({uint8_t(c | 0x6), it[0], it[1], 0}); break;
+        case 1: packets.push_back({uint8_t(c | 0x5), it[0], 0, 0}); break;
+        default: break;
+    }
+    return packets;
+}
+
+} // namespace
+
+TEST(SysExArena, singleMessageUsesEntirePool) {
+    SysExArena<64, 4> arena;
+    auto d = data(0, 64);
+    ASSERT_TRUE(arena.start(2));
+    EXPECT_TRUE(arena.hasSpaceLeft(2, 64));
+    EXPECT_FALSE(arena.hasSpaceLeft(2, 65));
+    arena.add(2, d.data(), 64);
+    EXPECT_FALSE(arena.hasSpaceLeft(2, 1));
+    EXPECT_EQ(std::vector<uint8_t>(arena.getBuffer(2), arena.getBuffer(2) + 64),
+              d);
+    EXPECT_EQ(arena.getUsage(), 64);
+    arena.end(2);
+    EXPECT_FALSE(arena.isReceiving(2));
+    EXPECT_EQ(arena.getUsage(), 0);
+    EXPECT_EQ(arena.getPeakUsage(), 64);
+    arena.resetPeakUsage();
+    EXPECT_EQ(arena.getPeakUsage(), 0);
+}
+
+TEST(SysExArena, concurrentMessages) {
+    SysExArena<64, 4> arena;
+    auto d0 = data(0, 20), d1 = data(50, 20);
+    ASSERT_TRUE(arena.start(0));
+    arena.add(0, d0.data(), 10);
+    // The second message gets the second half of the free space
+    ASSERT_TRUE(arena.start(1));
+    EXPECT_TRUE(arena.hasSpaceLeft(1, 27));
+    EXPECT_FALSE(arena.hasSpaceLeft(1, 28));
+    EXPECT_TRUE(arena.hasSpaceLeft(0, 27));
+    EXPECT_FALSE(arena.hasSpaceLeft(0, 28));
+    // Interleave the data of both messages
+    arena.add(1, d1.data(), 10);
+    arena.add(0, d0.data() + 10, 10);
+    arena.add(1, d1.data() + 10, 10);
+    EXPECT_EQ(arena.getUsage(), 40);
+    EXPECT_EQ(std::vector<uint8_t>(arena.getBuffer(0), arena.getBuffer(0) + 20),
+              d0);
+    EXPECT_EQ(std::vector<uint8_t>(arena.getBuffer(1), arena.getBuffer(1) + 20),
+              d1);
+    // When the first message ends, its space can be reused
+    arena.end(0);
+    EXPECT_EQ(arena.getUsage(), 20);
+    ASSERT_TRUE(arena.start(3));
+    EXPECT_TRUE(arena.hasSpaceLeft(3, 37));
+    EXPECT_FALSE(arena.hasSpaceLeft(3, 38));
+    EXPECT_EQ(arena.getNumberOfEvicted(), 0);
+    EXPECT_EQ(arena.getPeakUsage(), 40);
+}
+
+TEST(SysExArena, restartKeepsSpace) {
+    SysExArena<16, 2> arena;
+    auto d = data(0, 16);
+    ASSERT_TRUE(arena.start(0));
+    arena.add(0, d.data(), 8);
+    ASSERT_TRUE(arena.start(0));
+    EXPECT_EQ(arena.getLength(0), 0);
+    EXPECT_EQ(arena.getUsage(), 0);
+    EXPECT_TRUE(arena.hasSpaceLeft(0, 16));
+}
+
+TEST(SysExArena, evictLeastRecentlyActive) {
+    SysExArena<12, 4> arena;
+    auto d = data(0, 8);
+    ASSERT_TRUE(arena.start(0));
+    arena.add(0, d.data(), 3);
+    ASSERT_TRUE(arena.start(1));
+    arena.add(1, d.data(), 3);
+    arena.add(0, d.data(), 1); // cable 1 is now the least recently active
+    // No room for a third message, the message on cable 1 is discarded
+    ASSERT_TRUE(arena.start(2));
+    EXPECT_EQ(arena.getNumberOfEvicted(), 1);
+    EXPECT_TRUE(arena.isReceiving(0));
+    EXPECT_FALSE(arena.isReceiving(1));
+    EXPECT_TRUE(arena.isReceiving(2));
+    EXPECT_EQ(arena.getUsage(), 4);
+    EXPECT_EQ(std::vector<uint8_t>(arena.getBuffer(0), arena.getBuffer(0) + 4),
+              (std::vector<uint8_t> {0, 1, 2, 0}));
+}
+
+TEST(SysExArena, noSpaceWithoutOtherMessages) {
+    SysExArena<2, 1> arena;
+    EXPECT_FALSE(arena.start(0));
+    EXPECT_FALSE(arena.isReceiving(0));
+}
+
+TEST(USBMIDIParser, sysExArenaLargeMessage) {
+    USBMIDI_Parser uparser;
+    auto msg = data(0, USBMIDI_Parser::SysExArenaSize - 1);
+    msg.front() = 0xF0;
+    msg.back() = 0xF7;
+    auto packets = packetize(msg, 0);
+    auto puller = BufferPuller(packets);
+    EXPECT_EQ(uparser.pull(puller), MIDIReadEvent::SYSEX_MESSAGE);
+    EXPECT_EQ(uparser.getSysExMessage(),
+              SysExMessage(msg.data(), msg.size(), Cable_1));
+    EXPECT_TRUE(uparser.getSysExMessage().isCompleteMessage());
+    EXPECT_EQ(uparser.getSysExArena().getPeakUsage(), msg.size());
+    EXPECT_EQ(uparser.getSysExArena().getUsage(), 0);
+}
+
+TEST(USBMIDIParser, sysExArenaInterleavedCables) {
+    USBMIDI_Parser uparser;
+    auto msg1 = data(0, 33), msg2 = data(64, 21);
+    msg1.front() = msg2.front() = 0xF0;
+    msg1.back() = msg2.back() = 0xF7;
+    auto p1 = packetize(msg1, 0x3), p2 = packetize(msg2, 0x9);
+    std::vector<Packet_t> packets;
+    for (size_t i = 0; i < p1.size(); ++i) {
+        packets.push_back(p1[i]);
+        if (i < p2.size())
+            packets.push_back(p2[i]);
+    }
+    auto puller = BufferPuller(packets);
+    EXPECT_EQ(uparser.pull(puller), MIDIReadEvent::SYSEX_MESSAGE);
+    EXPECT_EQ(uparser.getSysExMessage(),
+              SysExMessage(msg2.data(), msg2.size(), Cable_10));
+    EXPECT_EQ(uparser.pull(puller), MIDIReadEvent::SYSEX_MESSAGE);
+    EXPECT_EQ(uparser.getSysExMessage(),
+              SysExMessage(msg1.data(), msg1.size(), Cable_4));
+    EXPECT_EQ(uparser.pull(puller), MIDIReadEvent::NO_MESSAGE);
+    EXPECT_EQ(uparser.getSysExArena().getPeakUsage(), 2 * 21);
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
+#include <functional>
 
 #include <MIDI_Parsers/BufferPuller.hpp>
+#include <MIDI_Parsers/LambdaPuller.hpp>
 #include <MIDI_Parsers/SerialMIDI_Parser.hpp>
 #include <MIDI_Parsers/USBMIDI_Parser.hpp>
 
@@ -751,6 +753,57 @@ TEST(SerialMIDIParser, sysExEndsWithSysExStart) {
     EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::NO_MESSAGE);
 }
 
+TEST(SerialMIDIParser, sysExAfterIncompleteSysCommon) {
+    SerialMIDI_Parser sparser;
+    uint8_t data[] = {0xF2, 0x1F, 0xF0, 0x20, 0x30, 0xF7};
+    size_t i = 0;
+    auto puller = LambdaPuller([&](uint8_t &b) {
+        return i < sizeof(data) ? (b = data[i++], true) : false;
+    });
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::SYSEX_MESSAGE);
+    EXPECT_EQ(sparser.getSysExMessage(),
+              SysExMessage({0xF0, 0x20, 0x30, 0xF7}));
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::NO_MESSAGE);
+}
+
+TEST(SerialMIDIParser, sysExZeroCopy) {
+    SerialMIDI_Parser sparser;
+    sparser.setZeroCopySysEx(true);
+    std::vector<uint8_t> data {0x90, 0x3C, 0x7F, 0xF0};
+    data.resize(data.size() + 2 * SYSEX_BUFFER_SIZE, 0x11);
+    data.push_back(0xF7);
+    data.insert(data.end(), {0xF0, 0x22});
+    auto puller = BufferPuller(data);
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::CHANNEL_MESSAGE);
+    // Not chunked, even though it's larger than the SysEx buffer
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::SYSEX_MESSAGE);
+    SysExMessage msg = sparser.getSysExMessage();
+    EXPECT_EQ(msg.data, data.data() + 3);
+    EXPECT_EQ(msg.length, 2 * SYSEX_BUFFER_SIZE + 2);
+    EXPECT_TRUE(msg.isCompleteMessage());
+    // Message that continues in the next buffer is copied
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::NO_MESSAGE);
+    uint8_t data2[] {0x33, 0xF7, 0x80, 0x01, 0x02};
+    EXPECT_EQ(sparser.pull(BufferPuller(data2)), MIDIReadEvent::SYSEX_MESSAGE);
+    EXPECT_EQ(sparser.getSysExMessage(), SysExMessage({0xF0, 0x22, 0x33, 0xF7}));
+    // The returned message lives in the parser's buffer, not in data2
+    const uint8_t *sysex = sparser.getSysExMessage().data;
+    std::less<const uint8_t *> lt;
+    EXPECT_TRUE(lt(sysex, data2) || !lt(sysex, data2 + sizeof(data2)));
+}
+
+TEST(SerialMIDIParser, sysExZeroCopyRunningStatus) {
+    SerialMIDI_Parser sparser;
+    sparser.setZeroCopySysEx(true);
+    uint8_t data[] {0x90, 0x3C, 0x7F, 0xF0, 0x11, 0xF7, 0x3D, 0x7F};
+    auto puller = BufferPuller(data);
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::CHANNEL_MESSAGE);
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::SYSEX_MESSAGE);
+    EXPECT_EQ(sparser.getSysExMessage().data, data + 3);
+    // SysEx cancels running status
+    EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::NO_MESSAGE);
+}
+
 #include <random>
 
 TEST(SerialMIDIParser, sysExMultipleChunks) {
@@ -786,8 +839,9 @@ TEST(SerialMIDIParser, sysExMultipleChunks) {
 
 TEST(USBMIDIParser, sysExMultipleChunks) {
     USBMIDI_Parser uparser;
-    const size_t buffsize3 = (SYSEX_BUFFER_SIZE / 3) * 3;
-    const size_t size = buffsize3 + SYSEX_BUFFER_SIZE + 1;
+    const size_t ArenaSize = USBMIDI_Parser::SysExArenaSize;
+    const size_t buffsize3 = (ArenaSize / 3) * 3;
+    const size_t size = buffsize3 + ArenaSize + 1;
     std::vector<uint8_t> data(size);
     std::vector<uint8_t> packet(4);
     data.front() = 0xF0;
@@ -818,7 +872,7 @@ TEST(USBMIDIParser, sysExMultipleChunks) {
     EXPECT_EQ(uparser.pull(puller), MIDIReadEvent::SYSEX_CHUNK);
     auto size1 = uparser.getSysExMessage().length;
     EXPECT_GE(size1, buffsize3);
-    EXPECT_LE(size1, SYSEX_BUFFER_SIZE);
+    EXPECT_LE(size1, ArenaSize);
     EXPECT_EQ(uparser.getSysExMessage(),
               SysExMessage(data.data(), size1, Cable_6));
     EXPECT_TRUE(uparser.getSysExMessage().isFirstChunk());
@@ -828,7 +882,7 @@ TEST(USBMIDIParser, sysExMultipleChunks) {
     EXPECT_EQ(uparser.pull(puller), MIDIReadEvent::SYSEX_CHUNK);
     auto size2 = uparser.getSysExMessage().length;
     EXPECT_GE(size2, buffsize3);
-    EXPECT_LE(size2, SYSEX_BUFFER_SIZE);
+    EXPECT_LE(size2, ArenaSize);
     EXPECT_EQ(uparser.getSysExMessage(),
               SysExMessage(data.data() + size1, size2, Cable_6));
     EXPECT_FALSE(uparser.getSysExMessage().isFirstChunk());
@@ -864,4 +918,122 @@ TEST(SerialMIDIParser, realSysEx) {
     EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::SYSEX_MESSAGE);
     EXPECT_EQ(sparser.getSysExMessage(), SysExMessage(data));
     EXPECT_EQ(sparser.pull(puller), MIDIReadEvent::NO_MESSAGE);
-}
\ No newline at end of file
+}
+namespace {
+
+/// Generate a random MIDI stream with channel messages (with and without
+/// running status), SysEx messages of different lengths, System Common and
+/// Real-Time messages, and some invalid sequences.
+std::vector<uint8_t> randomMIDIStream(std::mt19937 &gen, size_t numMessages) {
+    std::uniform_int_distribution<int> kind(0, 9), byte(0, 0x7F),
+        sysexlen(0, 300), rtbyte(0xF8, 0xFF);
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < numMessages; ++i) {
+        switch (kind(gen)) {
+            case 0:
+            case 1:
+            case 2: // Channel message
+                stream.push_back(0x80 | (byte(gen) & 0x7F));
+                // fallthrough
+            case 3: // Running status
+                stream.push_back(byte(gen));
+                stream.push_back(byte(gen));
+                break;
+            case 4: { // SysEx
+                stream.push_back(0xF0);
+                int len = sysexlen(gen);
+                for (int j = 0; j < len; ++j)
+                    stream.push_back(byte(gen));
+                if (byte(gen) > 0x10)
+                    stream.push_back(0xF7);
+            } break;
+            case 5: // Real-Time, possibly in the middle of a message
+                stream.push_back(rtbyte(gen));
+                break;
+            case 6: // System Common
+                stream.push_back(0xF1 + byte(gen) % 6);
+                stream.push_back(byte(gen));
+                break;
+            case 7: // Program Change or Channel Pressure
+                stream.push_back(0xC0 | (byte(gen) & 0x1F));
+                stream.push_back(byte(gen));
+                break;
+            case 8: // Tune Request
+                stream.push_back(0xF6);
+                break;
+            case 9: // Stray data or status byte
+            default: stream.push_back(uint8_t(byte(gen) << 1)); break;
+        }
+    }
+    return stream;
+}
+
+using EventLog = std::vector<std::vector<uint8_t>>;
+
+/// Record the event and the parsed message.
+void logEvent(EventLog &log, MIDIReadEvent evt,
+              const SerialMIDI_Parser &parser) {
+    std::vector<uint8_t> entry {uint8_t(evt)};
+    switch (evt) {
+        case MIDIReadEvent::CHANNEL_MESSAGE: {
+            auto msg = parser.getChannelMessage();
+            entry.insert(entry.end(), {msg.header, msg.data1, msg.data2});
+        } break;
+        case MIDIReadEvent::SYSCOMMON_MESSAGE: {
+            auto msg = parser.getSysCommonMessage();
+            entry.insert(entry.end(), {msg.header, msg.data1, msg.data2});
+        } break;
+        case MIDIReadEvent::REALTIME_MESSAGE:
+            entry.push_back(parser.getRealTimeMessage().message);
+            break;
+        case MIDIReadEvent::SYSEX_MESSAGE:
+        case MIDIReadEvent::SYSEX_CHUNK: {
+            auto msg = parser.getSysExMessage();
+            entry.insert(entry.end(), msg.data, msg.data + msg.length);
+        } break;
+        case MIDIReadEvent::NO_MESSAGE:
+        default: break;
+    }
+    log.push_back(std::move(entry));
+}
+
+} // namespace
+
+TEST(SerialMIDIParser, bufferPathEqualsBytePath) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> chunklen(1, 64);
+    for (bool sysCommonCancelsRunningStatus : {true, false}) {
+        for (int i = 0; i < 20; ++i) {
+            auto stream = randomMIDIStream(gen, 500);
+
+            // Byte by byte
+            SerialMIDI_Parser byteParser {sysCommonCancelsRunningStatus};
+            EventLog byteLog;
+            size_t idx = 0;
+            auto bytePuller = LambdaPuller([&](uint8_t &b) {
+                if (idx == stream.size())
+                    return false;
+                b = stream[idx++];
+                return true;
+            });
+            MIDIReadEvent evt;
+            while ((evt = byteParser.pull(bytePuller)) !=
+                   MIDIReadEvent::NO_MESSAGE)
+                logEvent(byteLog, evt, byteParser);
+
+            // Buffer at once, split into random chunks
+            SerialMIDI_Parser bufParser {sysCommonCancelsRunningStatus};
+            EventLog bufLog;
+            for (size_t start = 0; start < stream.size();) {
+                size_t len = std::min(chunklen(gen), stream.size() - start);
+                auto puller = BufferPuller(stream.data() + start, len);
+                while ((evt = bufParser.pull(puller)) !=
+                       MIDIReadEvent::NO_MESSAGE)
+                    logEvent(bufLog, evt, bufParser);
+                start += len;
+            }
+            ASSERT_EQ(byteLog, bufLog);
+            EXPECT_GT(byteLog.size(), 100u);
+        }
+    }
+}
@@ -6,8 +6,17 @@ class TestStream : public Stream {
   public:
     size_t write(uint8_t data) override {
         sent.push_back(data);
+        if (writeSpace > 0)
+            --writeSpace;
         return 1;
     }
+    size_t write(const uint8_t *data, size_t length) override {
+        ++writeCalls;
+        for (size_t i = 0; i < length; ++i)
+            write(data[i]);
+        return length;
+    }
+    int availableForWrite() override { return writeSpace; }
     int peek() override { return toRead.empty() ? -1 : toRead.front(); }
     int read() override {
         int retval = peek();
@@ -19,4 +28,8 @@ class TestStream : public Stream {
 
     std::vector<uint8_t> sent;
     std::queue<uint8_t> toRead;
+    /// Number of bytes that can be written without blocking.
+    int writeSpace = 0;
+    /// Number of calls to `write(const uint8_t *, size_t)`.
+    size_t writeCalls = 0;
 };
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include <benchmark/benchmark.h>
+
+#include <MIDI_Interfaces/BLEMIDI/BLEMIDIPacketBuilder.hpp>
+#include <MIDI_Interfaces/BLEMIDI/BufferedBLEMIDIParser.hpp>
+#include <MIDI_Parsers/BLEMIDIParser.hpp>
+#include <MIDI_Parsers/SerialMIDI_Parser.hpp>
+
+#include <random>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Control Change messages on a few channels, with a new timestamp every
+/// four messages.
+struct CCStream {
+    CCStream() {
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int> data(0, 0x7F);
+        std::uniform_int_distribution<int> channel(0, 3);
+        for (auto &msg : messages)
+            msg = {MIDIMessageType::ControlChange,
+                   Channel(uint8_t(channel(gen))), uint8_t(data(gen)),
+                   uint8_t(data(gen))};
+    }
+    std::vector<ChannelMessage> messages {256, {0, 0, 0}};
+};
+
+/// Fill BLE packets with the given capacity (20 bytes for the default MTU,
+/// larger if a larger MTU was negotiated).
+void BM_BLEMIDIPacketBuilder_add3B(benchmark::State &state) {
+    CCStream s;
+    BLEMIDIPacketBuilder builder(state.range(0));
+    size_t i = 0, packets = 0;
+    for (auto _ : state) {
+        auto msg = s.messages[i & 255];
+        uint16_t timestamp = i++ / 4;
+        if (!builder.add3B(msg.header, msg.data1, msg.data2, timestamp)) {
+            benchmark::DoNotOptimize(builder.getBuffer());
+            builder.reset();
+            builder.add3B(msg.header, msg.data1, msg.data2, timestamp);
+            ++packets;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["packets"] = benchmark::Counter(
+        packets, benchmark::Counter::kIsRate);
+}
+
+void BM_BLEMIDIPacketBuilder_addSysEx(benchmark::State &state) {
+    std::vector<uint8_t> sysex(state.range(1), 0x11);
+    sysex.front() = 0xF0;
+    sysex.back() = 0xF7;
+    BLEMIDIPacketBuilder builder(state.range(0));
+    for (auto _ : state) {
+        const uint8_t *data = sysex.data();
+        size_t length = sysex.size();
+        builder.reset();
+        builder.addSysEx(data, length, 0);
+        while (data) {
+            benchmark::DoNotOptimize(builder.getBuffer());
+            builder.reset();
+            builder.continueSysEx(data, length, 0);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * sysex.size());
+}
+
+/// Pack a stream of Control Change messages into notifications for the given
+/// MTU, as the BLE senders do: the capacity is reset after every notification.
+/// Reports the average number of MIDI messages per notification.
+template <class Builder>
+void BM_BLEMIDI_packing(benchmark::State &state) {
+    CCStream s;
+    uint16_t mtu = state.range(0);
+    Builder builder;
+    builder.setCapacity(mtu - 3);
+    size_t i = 0, notifications = 0;
+    for (auto _ : state) {
+        auto msg = s.messages[i & 255];
+        uint16_t timestamp = i++ / 4;
+        if (!builder.add3B(msg.header, msg.data1, msg.data2, timestamp)) {
+            benchmark::DoNotOptimize(builder.getBuffer());
+            builder.reset();
+            builder.setCapacity(mtu - 3);
+            builder.add3B(msg.header, msg.data1, msg.data2, timestamp);
+            ++notifications;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["msgs/notification"] =
+        notifications ? double(state.iterations()) / notifications : 0;
+}
+
+/// Parse BLE packets of the given capacity, filled with Control Change
+/// messages.
+void BM_BLEMIDIParser(benchmark::State &state) {
+    CCStream s;
+    std::vector<std::vector<uint8_t>> packets;
+    BLEMIDIPacketBuilder builder(state.range(0));
+    for (size_t i = 0; i < s.messages.size(); ++i) {
+        auto msg = s.messages[i];
+        if (!builder.add3B(msg.header, msg.data1, msg.data2, i / 4)) {
+            packets.emplace_back(builder.getBuffer(),
+                                 builder.getBuffer() + builder.getSize());
+            builder.reset();
+            builder.add3B(msg.header, msg.data1, msg.data2, i / 4);
+        }
+    }
+    packets.emplace_back(builder.getBuffer(),
+                         builder.getBuffer() + builder.getSize());
+    size_t bytes = 0;
+    for (auto &p : packets)
+        bytes += p.size();
+
+    SerialMIDI_Parser parser(false);
+    for (auto _ : state) {
+        for (auto &p : packets) {
+            BLEMIDIParser ble(p.data(), p.size());
+            while (parser.pull(ble) != MIDIReadEvent::NO_MESSAGE)
+                benchmark::DoNotOptimize(parser.getChannelMessage());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * s.messages.size());
+}
+
+/// BLE packets of the given capacity, filled with Control Change messages or
+/// with long SysEx messages.
+std::vector<std::vector<uint8_t>> makePackets(uint16_t capacity, bool sysex) {
+    std::vector<std::vector<uint8_t>> packets;
+    BLEMIDIPacketBuilder builder(capacity);
+    auto flush = [&] {
+        packets.emplace_back(builder.getBuffer(),
+                             builder.getBuffer() + builder.getSize());
+        builder.reset();
+    };
+    if (sysex) {
+        std::vector<uint8_t> msg(1000, 0x11);
+        msg.front() = 0xF0;
+        msg.back() = 0xF7;
+        for (uint16_t i = 0; i < 4; ++i) {
+            const uint8_t *data = msg.data();
+            size_t length = msg.size();
+            if (!builder.addSysEx(data, length, i)) {
+                flush();
+                builder.addSysEx(data, length, i);
+            }
+            while (data) {
+                flush();
+                builder.continueSysEx(data, length, i);
+            }
+        }
+    } else {
+        CCStream s;
+        for (size_t i = 0; i < s.messages.size(); ++i) {
+            auto msg = s.messages[i];
+            if (!builder.add3B(msg.header, msg.data1, msg.data2, i / 4)) {
+                flush();
+                builder.add3B(msg.header, msg.data1, msg.data2, i / 4);
+            }
+        }
+    }
+    flush();
+    return packets;
+}
+
+/// Extracts the MIDI bytes from the BLE packets in the ring buffer one by one
+/// (this is how @ref BufferedBLEMIDIParser used to parse them).
+template <uint16_t Capacity>
+struct BytewiseBLEMIDIParser {
+    BLERingBuf<Capacity> ble_buffer;
+    BLEMIDIParser ble_parser {nullptr, 0};
+    SerialMIDI_Parser parser {false};
+
+    bool pushPacket(BLEDataView packet) { return ble_buffer.push(packet); }
+
+    bool popMessage(AnyMIDIMessage &msg) {
+        while (true) {
+            MIDIReadEvent event = parser.pull(ble_parser);
+            uint16_t ts = ble_parser.getTimestamp();
+            if (event == MIDIReadEvent::CHANNEL_MESSAGE) {
+                msg = {parser.getChannelMessage(), ts};
+                return true;
+            } else if (event == MIDIReadEvent::SYSEX_CHUNK ||
+                       event == MIDIReadEvent::SYSEX_MESSAGE) {
+                msg = {parser.getSysExMessage(), ts};
+                return true;
+            } else if (event == MIDIReadEvent::REALTIME_MESSAGE) {
+                msg = {parser.getRealTimeMessage(), ts};
+                return true;
+            } else if (event == MIDIReadEvent::SYSCOMMON_MESSAGE) {
+                msg = {parser.getSysCommonMessage(), ts};
+                return true;
+            }
+            BLEDataView chunk;
+            auto popped = ble_buffer.pop(chunk);
+            if (popped == BLEDataType::None)
+                return false;
+            else if (popped == BLEDataType::Continuation)
+                ble_parser.extend(chunk.data, chunk.length);
+            else if (popped == BLEDataType::Packet)
+                ble_parser = {chunk.data, chunk.length};
+        }
+    }
+};
+
+/// Receive BLE packets through the given parser, for BLE packets of the given
+/// capacity (20 bytes for the default MTU, 512 for the maximum MTU), filled
+/// with Control Change messages or with SysEx data.
+template <class Parser>
+void BM_BLEMIDI_receive(benchmark::State &state) {
+    auto packets = makePackets(state.range(0), state.range(1));
+    size_t bytes = 0;
+    for (auto &p : packets)
+        bytes += p.size();
+    Parser parser;
+    AnyMIDIMessage msg;
+    size_t messages = 0;
+    for (auto _ : state) {
+        for (auto &p : packets) {
+            parser.pushPacket({p.data(), uint16_t(p.size())});
+            while (parser.popMessage(msg)) {
+                benchmark::DoNotOptimize(msg);
+                ++messages;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(messages);
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+} // namespace
+
+BENCHMARK(BM_BLEMIDIPacketBuilder_add3B)
+    ->ArgName("capacity")
+    ->Arg(20)
+    ->Arg(182);
+BENCHMARK(BM_BLEMIDIPacketBuilder_addSysEx)
+    ->ArgNames({"capacity", "length"})
+    ->ArgsProduct({{20, 182}, {128, 1024}});
+BENCHMARK_TEMPLATE(BM_BLEMIDI_packing, BLEMIDIPacketBuilder)
+    ->ArgName("mtu")
+    ->Arg(23)
+    ->Arg(64)
+    ->Arg(185)
+    ->Arg(247)
+    ->Arg(515);
+BENCHMARK_TEMPLATE(BM_BLEMIDI_packing, StaticBLEMIDIPacketBuilder<512>)
+    ->ArgName("mtu")
+    ->Arg(23)
+    ->Arg(64)
+    ->Arg(185)
+    ->Arg(247)
+    ->Arg(515);
+BENCHMARK(BM_BLEMIDIParser)->ArgName("capacity")->Arg(20)->Arg(182);
+BENCHMARK_TEMPLATE(BM_BLEMIDI_receive, BytewiseBLEMIDIParser<2048>)
+    ->ArgNames({"capacity", "sysex"})
+    ->ArgsProduct({{20, 512}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_BLEMIDI_receive, BufferedBLEMIDIParser<2048>)
+    ->ArgNames({"capacity", "sysex"})
+    ->ArgsProduct({{20, 512}, {0, 1}});
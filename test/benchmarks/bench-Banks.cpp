@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+
+#include <Banks/Bank.hpp>
+#include <MIDI_Inputs/MCU/VPotRing.hpp>
+#include <MIDI_Inputs/NoteCCKPValue.hpp>
+
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Create the given number of bankable CC and V-Pot elements in a bank with
+/// 8 banks of 8 tracks, and give a fraction of the elements a different value
+/// in every bank.
+struct BankableElements {
+    BankableElements(size_t count, unsigned percentChanged) : bank(8) {
+        ccs.reserve(count / 2);
+        vpots.reserve(count / 2);
+        for (size_t i = 0; i < count / 2; ++i) {
+            ccs.emplace_back(
+                bank, MIDIAddress {int(i % 8), Channel(uint8_t(i / 8 % 16))});
+            vpots.emplace_back(bank, 1 + i % 8,
+                               Channel(uint8_t(i / 8 % 16)));
+        }
+        for (size_t i = 0; i < count / 2; ++i) {
+            if (i * 100 >= percentChanged * (count / 2))
+                continue;
+            for (uint8_t b = 0; b < 8; ++b) {
+                Channel ch = Channel(uint8_t(i / 8 % 16));
+                uint8_t addr = i % 8 + 8 * b;
+                MIDIInputElementCC::updateAllWith(
+                    {MIDIMessageType::ControlChange, ch, addr, b});
+                MIDIInputElementCC::updateAllWith(
+                    {MIDIMessageType::ControlChange, ch, uint8_t(0x30 + addr),
+                     b});
+            }
+        }
+    }
+    Bank<8> bank;
+    std::vector<Bankable::CCValue<8>> ccs;
+    std::vector<MCU::Bankable::VPotRing<8>> vpots;
+};
+
+void BM_bankSelect(benchmark::State &state) {
+    BankableElements els(state.range(0), state.range(1));
+    setting_t setting = 0;
+    for (auto _ : state) {
+        setting = (setting + 1) % 8;
+        els.bank.select(setting);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_bankSelect)
+    ->ArgNames({"elements", "changed%"})
+    ->ArgsProduct({{16, 128, 1024}, {0, 10, 100}});
@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Inputs/MCU/VU.hpp>
+#include <MIDI_Inputs/NoteCCKPValue.hpp>
+#include <MIDI_Interfaces/SerialMIDI_Interface.hpp>
+#include <MIDI_Outputs/CCPotentiometer.hpp>
+#include <MIDI_Outputs/NoteButton.hpp>
+#include <TestStream.hpp>
+
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <vector>
+
+USING_CS_NAMESPACE;
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace {
+
+/// The elements of a mixing console with the given number of tracks: a mute
+/// button, a fader, a V-Pot LED value, a solo LED and a VU meter per track.
+struct Console {
+    Console(uint8_t tracks) {
+        for (uint8_t t = 0; t < tracks; ++t) {
+            Channel ch = Channel(t / 8);
+            uint8_t i = t % 8;
+            pin_t pin = t % NUM_DIGITAL_PINS;
+            buttons.emplace_back(new NoteButton(pin, {0x10 + i, ch}));
+            pots.emplace_back(new CCPotentiometer(pin, {0x07 + i, ch}));
+            vpots.emplace_back(new CCValue({0x30 + i, ch}));
+            leds.emplace_back(new NoteValue({0x08 + i, ch}));
+            vus.emplace_back(new MCU::VU(i + 1, ch));
+        }
+    }
+    std::vector<std::unique_ptr<NoteButton>> buttons;
+    std::vector<std::unique_ptr<CCPotentiometer>> pots;
+    std::vector<std::unique_ptr<CCValue>> vpots;
+    std::vector<std::unique_ptr<NoteValue>> leds;
+    std::vector<std::unique_ptr<MCU::VU>> vus;
+};
+
+/// Run the main loop with the given number of tracks, while the DAW sends
+/// VU meter levels and V-Pot values for every track at every iteration, and
+/// all faders move.
+void BM_Control_Surface_loop(benchmark::State &state) {
+    ArduinoMock::begin();
+    auto &mock = ArduinoMock::getInstance();
+    unsigned long time = 0;
+    EXPECT_CALL(mock, millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Invoke([&] { return time; }));
+    EXPECT_CALL(mock, micros())
+        .Times(AnyNumber())
+        .WillRepeatedly(Invoke([&] { return time * 1000; }));
+    EXPECT_CALL(mock, pinMode(_, _)).Times(AnyNumber());
+    EXPECT_CALL(mock, analogReadResolution(_)).Times(AnyNumber());
+    EXPECT_CALL(mock, digitalRead(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(HIGH));
+    int analogValue = 0;
+    EXPECT_CALL(mock, analogRead(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Invoke([&] { return analogValue; }));
+
+    {
+        uint8_t tracks = state.range(0);
+        TestStream stream;
+        StreamMIDI_Interface midi = stream;
+        Console console(tracks);
+        Control_Surface.begin();
+
+        uint8_t level = 0;
+        for (auto _ : state) {
+            ++time;
+            analogValue = (analogValue + 16) & 0x3FF;
+            level = (level + 1) & 0x0F;
+            for (uint8_t t = 0; t < tracks; ++t) {
+                uint8_t ch = t / 8, i = t % 8;
+                for (uint8_t b : {uint8_t(0xD0 | ch), uint8_t(i << 4 | level),
+                                  uint8_t(0xB0 | ch), uint8_t(0x30 + i), level})
+                    stream.toRead.push(b);
+            }
+            Control_Surface.loop();
+            stream.sent.clear();
+        }
+        state.SetItemsProcessed(state.iterations());
+
+        Control_Surface.disconnectMIDI_Interfaces();
+    }
+    ArduinoMock::end();
+}
+
+} // namespace
+
+BENCHMARK(BM_Control_Surface_loop)
+    ->ArgName("tracks")
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128);
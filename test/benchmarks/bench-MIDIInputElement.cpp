@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <MIDI_Inputs/NoteCCKPValue.hpp>
+
+#include <random>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Create the given number of CC elements, spread over all channels, and a
+/// stream of random messages that each match one of the elements.
+struct CCElements {
+    CCElements(size_t count) {
+        elements.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            elements.emplace_back(
+                MIDIAddress {int(i % 128), Channel(uint8_t(i / 128))});
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<size_t> dist(0, count - 1);
+        for (auto &msg : messages) {
+            size_t i = dist(gen);
+            msg = {MIDIMessageType::ControlChange, Channel(uint8_t(i / 128)),
+                   uint8_t(i % 128), uint8_t(i & 0x7F)};
+        }
+    }
+    std::vector<CCValue> elements;
+    std::vector<ChannelMessage> messages {256, {0, 0, 0}};
+};
+
+void updateAllWith(benchmark::State &state, bool indexed,
+                   MIDIInputDelivery delivery = MIDIInputDelivery::FirstMatch) {
+    CCElements els(state.range(0));
+    if (indexed)
+        MIDIInputElementCC::buildIndex(delivery);
+    size_t i = 0;
+    for (auto _ : state) {
+        bool match = MIDIInputElementCC::updateAllWith(els.messages[i++ & 255]);
+        benchmark::DoNotOptimize(match);
+    }
+    state.SetItemsProcessed(state.iterations());
+    MIDIInputElementCC::clearIndex();
+}
+
+void BM_updateAllWith_list(benchmark::State &state) {
+    updateAllWith(state, false);
+}
+void BM_updateAllWith_indexed(benchmark::State &state) {
+    updateAllWith(state, true);
+}
+
+void BM_updateAllWith_indexedAllMatches(benchmark::State &state) {
+    updateAllWith(state, true, MIDIInputDelivery::AllMatches);
+}
+
+void BM_buildIndex(benchmark::State &state) {
+    CCElements els(state.range(0));
+    for (auto _ : state)
+        MIDIInputElementCC::buildIndex();
+    MIDIInputElementCC::clearIndex();
+}
+
+} // namespace
+
+BENCHMARK(BM_updateAllWith_list)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK(BM_updateAllWith_indexed)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK(BM_updateAllWith_indexedAllMatches)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000);
+BENCHMARK(BM_buildIndex)->RangeMultiplier(10)->Range(10, 1000);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <MIDI_Parsers/BufferPuller.hpp>
+#include <MIDI_Parsers/MIDIStatusTable.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <MIDI_Parsers/USBMIDI_Parser.hpp>
+
+#include <random>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+std::vector<uint8_t> randomStatusBytes() {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> status(0x80, 0xFF);
+    std::vector<uint8_t> v(1024);
+    for (auto &s : v)
+        s = status(gen);
+    return v;
+}
+
+/// Number of data bytes of the given status byte, derived with the member
+/// functions of the message types.
+uint8_t lengthBranches(uint8_t status) {
+    MIDIMessage msg {status, 0, 0};
+    if (msg.hasValidChannelMessageHeader())
+        return ChannelMessage(msg).hasTwoDataBytes() ? 2 : 1;
+    if (msg.hasValidSystemCommonHeader())
+        return SysCommonMessage(msg).getNumberOfDataBytes();
+    return 0;
+}
+
+void BM_statusLength_branches(benchmark::State &state) {
+    auto bytes = randomStatusBytes();
+    for (auto _ : state)
+        for (uint8_t s : bytes)
+            benchmark::DoNotOptimize(lengthBranches(s));
+    state.SetItemsProcessed(state.iterations() * bytes.size());
+}
+
+void BM_statusLength_table(benchmark::State &state) {
+    auto bytes = randomStatusBytes();
+    for (auto _ : state)
+        for (uint8_t s : bytes)
+            benchmark::DoNotOptimize(getMIDIStatusInfo(s).getLength());
+    state.SetItemsProcessed(state.iterations() * bytes.size());
+}
+
+/// Parse buffers of USB MIDI packets of the given size: 64 bytes is the size of
+/// a full-speed bulk endpoint (AVR, SAMD), 512 bytes the size of a high-speed
+/// endpoint (Teensy 4).
+void BM_USBMIDI_Parser(benchmark::State &state) {
+    using Packet_t = USBMIDI_Parser::MIDIUSBPacket_t;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> data(0, 0x7F);
+    std::uniform_int_distribution<int> cin(0x8, 0xF);
+    std::vector<Packet_t> packets(state.range(0) / sizeof(Packet_t));
+    for (auto &p : packets) {
+        uint8_t c = cin(gen);
+        uint8_t status = c == 0xF ? 0xF8 : c << 4;
+        p = {c, status, uint8_t(data(gen)), uint8_t(data(gen))};
+    }
+    USBMIDI_Parser parser;
+    for (auto _ : state) {
+        auto puller = BufferPuller(packets);
+        while (parser.pull(puller) != MIDIReadEvent::NO_MESSAGE)
+            benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * packets.size());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_statusLength_branches);
+BENCHMARK(BM_statusLength_table);
+BENCHMARK(BM_USBMIDI_Parser)->ArgName("bytes")->Arg(64)->Arg(512);
@@ -0,0 +1,171 @@
+#include <benchmark/benchmark.h>
+
+#include <MIDI_Interfaces/MIDI_Pipes.hpp>
+#include <MIDI_Interfaces/MIDI_RoutingMatrix.hpp>
+#include <MIDI_Interfaces/StaticMIDI_Pipe.hpp>
+
+#include <memory>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+struct CountingSink : TrueMIDI_Sink {
+    void sinkMIDIfromPipe(ChannelMessage) override { ++count; }
+    void sinkMIDIfromPipe(SysExMessage) override { ++count; }
+    void sinkMIDIfromPipe(SysCommonMessage) override { ++count; }
+    void sinkMIDIfromPipe(RealTimeMessage) override { ++count; }
+    size_t count = 0;
+};
+
+struct Forward : TrueMIDI_SinkSource {
+    void sinkMIDIfromPipe(ChannelMessage msg) override {
+        sourceMIDItoPipe(msg);
+    }
+    void sinkMIDIfromPipe(SysExMessage msg) override {
+        sourceMIDItoPipe(msg);
+    }
+    void sinkMIDIfromPipe(SysCommonMessage msg) override {
+        sourceMIDItoPipe(msg);
+    }
+    void sinkMIDIfromPipe(RealTimeMessage msg) override {
+        sourceMIDItoPipe(msg);
+    }
+};
+
+/// Send a message from a single source to the given number of sinks, each
+/// connected through their own pipe.
+void BM_MIDI_Pipe_fanOut(benchmark::State &state) {
+    size_t numSinks = state.range(0);
+    TrueMIDI_Source source;
+    std::vector<std::unique_ptr<CountingSink>> sinks;
+    std::vector<std::unique_ptr<MIDI_Pipe>> pipes;
+    for (size_t i = 0; i < numSinks; ++i) {
+        sinks.emplace_back(new CountingSink);
+        pipes.emplace_back(new MIDI_Pipe);
+        source >> *pipes.back() >> *sinks.back();
+    }
+    ChannelMessage msg {0xB0, 0x10, 0x7F};
+    for (auto _ : state) {
+        source.sourceMIDItoPipe(msg);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSinks);
+    pipes.clear(); // disconnect before the sinks are destroyed
+}
+
+/// Send a message from a single source to the given number of sinks through
+/// a routing matrix.
+void BM_MIDI_RoutingMatrix_fanOut(benchmark::State &state) {
+    size_t numSinks = state.range(0);
+    TrueMIDI_Source source;
+    std::vector<std::unique_ptr<CountingSink>> sinks;
+    MIDI_RoutingMatrix<1, 16> matrix;
+    uint8_t src = matrix.addSource(source);
+    for (size_t i = 0; i < numSinks; ++i) {
+        sinks.emplace_back(new CountingSink);
+        matrix.route(src, matrix.addSink(*sinks.back()));
+    }
+    ChannelMessage msg {0xB0, 0x10, 0x7F};
+    for (auto _ : state) {
+        source.sourceMIDItoPipe(msg);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSinks);
+    for (auto &sink : sinks)
+        sink->disconnectSourcePipes();
+}
+
+/// Send a message through a chain of the given number of routing stages
+/// (sink-sources), which is the path a message takes through a MIDI_Pipe
+/// for every interface and routing element it passes.
+void BM_MIDI_Pipe_chain(benchmark::State &state) {
+    size_t length = state.range(0);
+    TrueMIDI_Source source;
+    CountingSink sink;
+    std::vector<std::unique_ptr<Forward>> stages;
+    std::vector<std::unique_ptr<MIDI_Pipe>> pipes;
+    for (size_t i = 0; i < length; ++i)
+        stages.emplace_back(new Forward);
+    for (size_t i = 0; i <= length; ++i)
+        pipes.emplace_back(new MIDI_Pipe);
+    source >> *pipes[0];
+    for (size_t i = 0; i < length; ++i) {
+        *pipes[i] >> *stages[i];
+        *stages[i] >> *pipes[i + 1];
+    }
+    *pipes[length] >> sink;
+    ChannelMessage msg {0xB0, 0x10, 0x7F};
+    for (auto _ : state) {
+        source.sourceMIDItoPipe(msg);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    pipes.clear();
+}
+
+/// A filter that remaps a channel, implemented by overriding the virtual
+/// mapping function of a pipe.
+template <uint8_t From, uint8_t To>
+struct VirtualMapChannel : MIDI_Pipe {
+    void mapForwardMIDI(ChannelMessage msg) override {
+        if (msg.getChannel().getRaw() == From - 1)
+            msg.setChannel(Channel(To - 1));
+        sourceMIDItoSink(msg);
+    }
+};
+
+/// Four channel mappings as separate virtual pipes, connected in series.
+void BM_MIDI_Pipe_filters_virtual(benchmark::State &state) {
+    TrueMIDI_Source source;
+    VirtualMapChannel<1, 2> p1;
+    VirtualMapChannel<2, 3> p2;
+    VirtualMapChannel<3, 4> p3;
+    VirtualMapChannel<4, 5> p4;
+    Forward f1, f2, f3;
+    CountingSink sink;
+    source >> p1 >> f1;
+    f1 >> p2 >> f2;
+    f2 >> p3 >> f3;
+    f3 >> p4 >> sink;
+    ChannelMessage msg {0xB0, 0x10, 0x7F};
+    for (auto _ : state) {
+        source.sourceMIDItoPipe(msg);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    p1.disconnect(), p2.disconnect(), p3.disconnect(), p4.disconnect();
+}
+
+/// The same four channel mappings as stages of a single static pipe.
+void BM_MIDI_Pipe_filters_static(benchmark::State &state) {
+    using namespace MIDIPipeStages;
+    TrueMIDI_Source source;
+    StaticMIDI_Pipe<MapChannel<1, 2>, MapChannel<2, 3>, MapChannel<3, 4>,
+                    MapChannel<4, 5>>
+        pipe;
+    CountingSink sink;
+    source >> pipe >> sink;
+    ChannelMessage msg {0xB0, 0x10, 0x7F};
+    for (auto _ : state) {
+        source.sourceMIDItoPipe(msg);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    pipe.disconnect();
+}
+
+} // namespace
+
+BENCHMARK(BM_MIDI_Pipe_fanOut)
+    ->ArgName("sinks")
+    ->RangeMultiplier(4)
+    ->Range(1, 16);
+BENCHMARK(BM_MIDI_RoutingMatrix_fanOut)
+    ->ArgName("sinks")
+    ->RangeMultiplier(4)
+    ->Range(1, 16);
+BENCHMARK(BM_MIDI_Pipe_chain)->ArgName("stages")->Arg(1)->Arg(4);
+BENCHMARK(BM_MIDI_Pipe_filters_virtual);
+BENCHMARK(BM_MIDI_Pipe_filters_static);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <MIDI_Parsers/BufferPuller.hpp>
+#include <MIDI_Parsers/LambdaPuller.hpp>
+#include <MIDI_Parsers/SerialMIDI_Parser.hpp>
+
+#include <random>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+enum StreamType { SysEx, RunningStatus, Mixed };
+
+/// Generate 64 KiB of MIDI data: Mackie Control LCD SysEx messages, Control
+/// Change messages with running status, or an even mix of both with status
+/// bytes for every channel message.
+std::vector<uint8_t> makeStream(StreamType type) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> byte(0, 0x7F);
+    std::vector<uint8_t> stream;
+    while (stream.size() < 0x10000) {
+        bool sysex = type == SysEx || (type == Mixed && byte(gen) < 0x40);
+        if (sysex) {
+            for (uint8_t b : {0xF0, 0x00, 0x00, 0x66, 0x14, 0x12, 0x00})
+                stream.push_back(b);
+            for (int i = 0; i < 112; ++i)
+                stream.push_back(byte(gen));
+            stream.push_back(0xF7);
+        } else {
+            if (type == Mixed || stream.empty())
+                stream.push_back(0xB0);
+            stream.push_back(byte(gen));
+            stream.push_back(byte(gen));
+        }
+    }
+    return stream;
+}
+
+template <class PullFunc>
+void parse(benchmark::State &state, PullFunc pullAll, bool zeroCopy = false) {
+    auto stream = makeStream(StreamType(state.range(0)));
+    SerialMIDI_Parser parser;
+    parser.setZeroCopySysEx(zeroCopy);
+    for (auto _ : state) {
+        size_t events = pullAll(parser, stream);
+        benchmark::DoNotOptimize(events);
+    }
+    state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+void BM_SerialMIDI_Parser_bytes(benchmark::State &state) {
+    parse(state, [](SerialMIDI_Parser &parser, const std::vector<uint8_t> &s) {
+        size_t i = 0, events = 0;
+        auto puller = LambdaPuller([&](uint8_t &b) {
+            if (i == s.size())
+                return false;
+            b = s[i++];
+            return true;
+        });
+        while (parser.pull(puller) != MIDIReadEvent::NO_MESSAGE)
+            ++events;
+        return events;
+    });
+}
+
+size_t pullBuffer(SerialMIDI_Parser &parser, const std::vector<uint8_t> &s) {
+    size_t events = 0;
+    auto puller = BufferPuller(s);
+    while (parser.pull(puller) != MIDIReadEvent::NO_MESSAGE)
+        ++events;
+    return events;
+}
+
+void BM_SerialMIDI_Parser_buffer(benchmark::State &state) {
+    parse(state, pullBuffer);
+}
+
+void BM_SerialMIDI_Parser_bufferZeroCopy(benchmark::State &state) {
+    parse(state, pullBuffer, true);
+}
+
+} // namespace
+
+BENCHMARK(BM_SerialMIDI_Parser_bytes)
+    ->ArgName("stream")
+    ->DenseRange(SysEx, Mixed);
+BENCHMARK(BM_SerialMIDI_Parser_buffer)
+    ->ArgName("stream")
+    ->DenseRange(SysEx, Mixed);
+BENCHMARK(BM_SerialMIDI_Parser_bufferZeroCopy)
+    ->ArgName("stream")
+    ->DenseRange(SysEx, Mixed);
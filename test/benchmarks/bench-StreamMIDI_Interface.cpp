@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+
+#include <MIDI_Interfaces/SerialMIDI_Interface.hpp>
+#include <TestStream.hpp>
+
+#include <algorithm>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Simulates a UART at 31250 baud with a hardware transmit FIFO, in steps of
+/// one millisecond, on top of a TestStream.
+struct UARTModel {
+    TestStream stream;
+    /// Bytes per millisecond (31250 baud, 10 bits per byte).
+    constexpr static double BytesPerMs = 3.125;
+    /// Size of the hardware transmit FIFO.
+    constexpr static int FIFOSize = 16;
+    /// Number of bytes that have left the FIFO.
+    double transmitted = 0;
+
+    /// Advance the time by one millisecond.
+    void tick() {
+        transmitted = std::min<double>(transmitted + BytesPerMs,
+                                       stream.sent.size());
+        int backlog = stream.sent.size() - int(transmitted);
+        stream.writeSpace = std::max(FIFOSize - backlog, 0);
+    }
+    /// Time (ms) until a byte that is written now would leave the UART.
+    double delay() const {
+        return (stream.sent.size() - transmitted) / BytesPerMs;
+    }
+};
+
+/// Send a 24 PPQN clock at 125 BPM (every 20 ms) while a 256-byte SysEx dump
+/// is sent every 250 ms, and measure how long the clock messages have to wait
+/// for the UART. Without a transmit buffer, the clock waits for the entire
+/// SysEx message; with a transmit buffer of the given size, it only waits for
+/// the bytes in the hardware FIFO.
+void BM_StreamMIDI_clockJitter(benchmark::State &state) {
+    uint16_t txSize = state.range(0);
+    std::vector<uint8_t> txBuffer(txSize);
+    std::vector<uint8_t> sysex(256, 0x55);
+    sysex.front() = 0xF0;
+    sysex.back() = 0xF7;
+    double minDelay = 1e9, maxDelay = 0;
+    for (auto _ : state) {
+        UARTModel uart;
+        StreamMIDI_Interface midi = uart.stream;
+        midi.setTransmitBuffer(txSize ? txBuffer.data() : nullptr, txSize);
+        for (int t = 0; t < 1000; ++t) {
+            uart.tick();
+            midi.update();
+            if (t % 250 == 5)
+                midi.send(SysExMessage {sysex.data(), uint16_t(sysex.size())});
+            if (t % 20 == 10) {
+                double delay = uart.delay();
+                midi.sendRealTime(MIDIMessageType::TimingClock);
+                minDelay = std::min(minDelay, delay);
+                maxDelay = std::max(maxDelay, delay);
+            }
+        }
+        benchmark::DoNotOptimize(uart.stream.sent.data());
+    }
+    state.counters["max_clock_delay_ms"] = maxDelay;
+    state.counters["clock_jitter_ms"] = maxDelay - minDelay;
+}
+
+/// Models a USB CDC serial port, where every call to `write` results in at
+/// least one USB transfer of at most 64 bytes.
+struct USBSerialModel : TestStream {
+    constexpr static size_t PacketSize = 64;
+    size_t transfers = 0;
+    USBSerialModel() { writeSpace = 1 << 30; }
+    size_t write(uint8_t data) override {
+        ++transfers;
+        return TestStream::write(data);
+    }
+    size_t write(const uint8_t *data, size_t length) override {
+        transfers += (length + PacketSize - 1) / PacketSize;
+        sent.insert(sent.end(), data, data + length);
+        return length;
+    }
+};
+
+/// Send 16 Control Change messages per loop iteration, like a bank of faders
+/// that are all moving, and count the number of USB transfers per message.
+/// Without batching, every message is its own transfer.
+void BM_StreamMIDI_batchedWrites(benchmark::State &state) {
+    bool batched = state.range(0);
+    uint8_t txBuffer[128];
+    USBSerialModel stream;
+    StreamMIDI_Interface midi = stream;
+    midi.setTransmitBuffer(txBuffer, sizeof(txBuffer));
+    midi.enableBatchedWrites(batched);
+    size_t messages = 0;
+    for (auto _ : state) {
+        for (uint8_t i = 0; i < 16; ++i)
+            midi.sendControlChange({i, Channel_1},
+                                   uint8_t(messages + i) & 0x7F);
+        midi.endLoop();
+        messages += 16;
+        if (stream.sent.size() > 4096)
+            stream.sent.clear();
+    }
+    state.SetItemsProcessed(messages);
+    state.counters["transfers_per_msg"] = double(stream.transfers) / messages;
+}
+
+} // namespace
+
+BENCHMARK(BM_StreamMIDI_clockJitter)
+    ->ArgName("txbuf")
+    ->Arg(0)
+    ->Arg(64)
+    ->Arg(512);
+BENCHMARK(BM_StreamMIDI_batchedWrites)->ArgName("batched")->Arg(0)->Arg(1);